@@ -0,0 +1,144 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <physics/formulas/gravity.hpp>
+#include <physics/formulas/mech.hpp>
+#include <physics/object/object.hpp>
+#include <physics/parallel/thread_pool.hpp>
+#include <physics/units/quantity.hpp>
+#include <physics/vector/vector.hpp>
+
+#include "bodies.hpp"
+
+namespace {
+
+namespace pb = physics::benchmarks;
+namespace pg = physics::gravity;
+namespace pm = physics::mech;
+namespace pu = physics::units;
+namespace pv = physics::vector;
+
+void BM_ObjectUpdate(benchmark::State& state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  auto objects = pb::MakeBodies(n, pb::Distribution::kUniform);
+
+  for (auto _ : state) {
+    for (auto& obj : objects) {
+      obj.Update(pu::Time{1e-3});
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(n));
+}
+BENCHMARK(BM_ObjectUpdate)->RangeMultiplier(10)->Range(10, 1000000);
+
+pv::Vector<pu::Length, 3> SampleVector() {
+  return {pu::Length{1.5}, pu::Length{-2.0}, pu::Length{3.25}};
+}
+
+void BM_VectorNorm(benchmark::State& state) {
+  auto v = SampleVector();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(v);
+    benchmark::DoNotOptimize(pv::Norm(v));
+  }
+}
+BENCHMARK(BM_VectorNorm);
+
+void BM_VectorDot(benchmark::State& state) {
+  auto a = SampleVector();
+  auto b = SampleVector();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(a);
+    benchmark::DoNotOptimize(b);
+    benchmark::DoNotOptimize(pv::Dot(a, b));
+  }
+}
+BENCHMARK(BM_VectorDot);
+
+void BM_VectorNormalize(benchmark::State& state) {
+  auto v = SampleVector();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(v);
+    benchmark::DoNotOptimize(pv::Normalize(v));
+  }
+}
+BENCHMARK(BM_VectorNormalize);
+
+// Формулы из mech.cpp и gravity.cpp; аргументы проходят через DoNotOptimize, чтобы вызов не свернулся в константу
+// У формул есть перегрузки для массивов, поэтому скалярная версия выбирается через обобщенную лямбду
+template <typename Fn, typename... Args>
+void RunFormula(benchmark::State& state, Fn fn, Args... args) {
+  for (auto _ : state) {
+    (benchmark::DoNotOptimize(args), ...);
+    benchmark::DoNotOptimize(fn(args...));
+  }
+}
+
+const pu::Weight kMass{5.97e24};
+const pu::Length kDistance{6.371e6};
+const pu::Speed kSpeed{7.9e3};
+const pu::Time kTime{3.0};
+const pu::Acceleration kAccel{9.81};
+const pu::Force kForce{10.0};
+const pu::SpringConstant kSpring{200.0};
+
+BENCHMARK_CAPTURE(RunFormula, KineticEnergy, [](auto... args) { return pm::KineticEnergy(args...); }, kMass, kSpeed);
+BENCHMARK_CAPTURE(RunFormula, PotentialEnergy, [](auto... args) { return pm::PotentialEnergy(args...); }, kMass, kAccel, kDistance);
+BENCHMARK_CAPTURE(RunFormula, NewtonSecondLaw, [](auto... args) { return pm::NewtonSecondLaw(args...); }, kMass, kAccel);
+BENCHMARK_CAPTURE(RunFormula, AverageSpeed, [](auto... args) { return pm::AverageSpeed(args...); }, kDistance, kTime);
+BENCHMARK_CAPTURE(RunFormula, UniformMotion, [](auto... args) { return pm::UniformMotion(args...); }, kDistance, kSpeed, kTime);
+BENCHMARK_CAPTURE(RunFormula, AcceleratedMotion, [](auto... args) { return pm::AcceleratedMotion(args...); }, kDistance, kSpeed, kAccel, kTime);
+BENCHMARK_CAPTURE(RunFormula, Momentum, [](auto... args) { return pm::Momentum(args...); }, kMass, kSpeed);
+BENCHMARK_CAPTURE(RunFormula, Work, [](auto... args) { return pm::Work(args...); }, kForce, kDistance);
+BENCHMARK_CAPTURE(RunFormula, Friction, [](auto... args) { return pm::Friction(args...); }, pu::Quantity<0, 0, 0>{0.3}, kForce);
+BENCHMARK_CAPTURE(RunFormula, StaticFrictionMax, [](auto... args) { return pm::StaticFrictionMax(args...); }, pu::Quantity<0, 0, 0>{0.5}, kForce);
+BENCHMARK_CAPTURE(RunFormula, ElasticForce, [](auto... args) { return pm::ElasticForce(args...); }, kSpring, kDistance);
+BENCHMARK_CAPTURE(RunFormula, ElasticPotentialEnergy, [](auto... args) { return pm::ElasticPotentialEnergy(args...); }, kSpring, kDistance);
+BENCHMARK_CAPTURE(RunFormula, GravitationalForce, [](auto... args) { return pg::GravitationalForce(args...); }, kMass, kMass, kDistance);
+BENCHMARK_CAPTURE(RunFormula, GravitationalAcceleration, [](auto... args) { return pg::GravitationalAcceleration(args...); }, kMass, kDistance);
+BENCHMARK_CAPTURE(RunFormula, GravitationalPotentialEnergy, [](auto... args) { return pg::GravitationalPotentialEnergy(args...); }, kMass, kMass,
+                  kDistance);
+BENCHMARK_CAPTURE(RunFormula, EscapeVelocity, [](auto... args) { return pg::EscapeVelocity(args...); }, kMass, kDistance);
+BENCHMARK_CAPTURE(RunFormula, OrbitalVelocity, [](auto... args) { return pg::OrbitalVelocity(args...); }, kMass, kDistance);
+
+// Формула над массивом из n элементов: скалярный цикл против перегрузки для массивов с threads потоками (0 - без пула)
+void BM_GravitationalForceLoop(benchmark::State& state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  const std::vector<pu::Weight> mass(n, kMass);
+  const std::vector<pu::Length> distance(n, kDistance);
+  std::vector<pu::Force> out(n);
+
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < n; ++i) {
+      out[i] = pg::GravitationalForce(mass[i], mass[i], distance[i]);
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(n));
+}
+BENCHMARK(BM_GravitationalForceLoop)->RangeMultiplier(100)->Range(100, 1000000);
+
+void BM_GravitationalForceArray(benchmark::State& state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  const auto threads = static_cast<std::size_t>(state.range(1));
+  const std::vector<pu::Weight> mass(n, kMass);
+  const std::vector<pu::Length> distance(n, kDistance);
+  std::vector<pu::Force> out(n);
+  auto pool = threads > 0 ? std::make_unique<physics::parallel::ThreadPool>(threads) : nullptr;
+
+  for (auto _ : state) {
+    pg::GravitationalForce(mass, mass, distance, out, pool.get());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(n));
+}
+BENCHMARK(BM_GravitationalForceArray)->ArgsProduct({{100, 10000, 1000000}, {0, 4}});
+
+}  // namespace
+
+BENCHMARK_MAIN();
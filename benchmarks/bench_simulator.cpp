@@ -0,0 +1,369 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <physics/object/object.hpp>
+#include <physics/simulator/ensemble.hpp>
+#include <physics/simulator/fixed_simulator.hpp>
+#include <physics/simulator/gravity_kernel.hpp>
+#include <physics/simulator/octree.hpp>
+#include <physics/simulator/particles.hpp>
+#include <physics/simulator/simulator.hpp>
+#include <physics/units/quantity.hpp>
+#include <physics/vector/vector.hpp>
+
+#include "bodies.hpp"
+
+namespace {
+
+namespace pb = physics::benchmarks;
+namespace ps = physics::simulator;
+namespace pu = physics::units;
+
+// Прямая сумма O(n^2) на миллионе тел идет часами, поэтому для нее диапазон короче
+const std::vector<std::int64_t> kAllSizes = benchmark::CreateRange(10, 1000000, 10);
+const std::vector<std::int64_t> kQuadraticSizes = benchmark::CreateRange(10, 10000, 10);
+const std::vector<std::int64_t> kDistributions = {static_cast<std::int64_t>(pb::Distribution::kUniform), static_cast<std::int64_t>(pb::Distribution::kClustered)};
+
+// Радиус столкновений - половина среднего расстояния между телами
+constexpr double kCollisionDistance = 0.5;
+
+struct Case {
+  std::size_t n;
+  pb::Distribution distribution;
+};
+
+Case Setup(benchmark::State& state) {
+  Case c{static_cast<std::size_t>(state.range(0)), static_cast<pb::Distribution>(state.range(1))};
+  state.SetLabel(pb::DistributionName(c.distribution));
+  return c;
+}
+
+void Finish(benchmark::State& state, std::size_t n) {
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(n));
+}
+
+void BM_StepDirect(benchmark::State& state) {
+  const auto c = Setup(state);
+  ps::Simulator sim(pb::MakeBodies(c.n, c.distribution), pu::Length{kCollisionDistance});
+  sim.SetGravitySolver(ps::GravitySolver::kDirect);
+
+  for (auto _ : state) {
+    sim.Step(pu::Time{1e-3});
+  }
+  Finish(state, c.n);
+}
+BENCHMARK(BM_StepDirect)->ArgsProduct({kQuadraticSizes, kDistributions})->Unit(benchmark::kMicrosecond);
+
+void BM_StepDirect32(benchmark::State& state) {
+  const auto c = Setup(state);
+  ps::Simulator32 sim(pb::MakeBodies(c.n, c.distribution), pu::Length{kCollisionDistance});
+  sim.SetGravitySolver(ps::GravitySolver::kDirect);
+
+  for (auto _ : state) {
+    sim.Step(pu::Time{1e-3});
+  }
+  Finish(state, c.n);
+}
+BENCHMARK(BM_StepDirect32)->ArgsProduct({kQuadraticSizes, kDistributions})->Unit(benchmark::kMicrosecond);
+
+// Цена диагностики на каждом шаге (второй аргумент - 1) против шага без нее (0): у Верле потенциал идет в том же проходе сил,
+// у чехарды (третий аргумент - 1) нужен отдельный проход
+void BM_StepDiagnostics(benchmark::State& state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  ps::Simulator sim(pb::MakeBodies(n, pb::Distribution::kUniform), pu::Length{kCollisionDistance});
+  sim.SetIntegrator(state.range(2) != 0 ? ps::Integrator::kLeapfrog : ps::Integrator::kVelocityVerlet);
+  sim.SetDiagnostics(static_cast<std::size_t>(state.range(1)));
+
+  // Ряд не читается внутри цикла: чтение досчитало бы отложенный потенциал отдельным проходом
+  for (auto _ : state) {
+    sim.Step(pu::Time{1e-3});
+  }
+  benchmark::DoNotOptimize(sim.DiagnosticsSeries().size());
+  Finish(state, n);
+}
+BENCHMARK(BM_StepDiagnostics)->ArgsProduct({{1000, 10000}, {0, 1}, {0, 1}})->Unit(benchmark::kMicrosecond);
+
+void BM_StepBarnesHut(benchmark::State& state) {
+  const auto c = Setup(state);
+  ps::Simulator sim(pb::MakeBodies(c.n, c.distribution), pu::Length{kCollisionDistance});
+  sim.SetGravitySolver(ps::GravitySolver::kBarnesHut);
+  sim.SetBroadPhase(ps::BroadPhase::kSpatialHash);
+
+  for (auto _ : state) {
+    sim.Step(pu::Time{1e-3});
+  }
+  Finish(state, c.n);
+}
+BENCHMARK(BM_StepBarnesHut)->ArgsProduct({kAllSizes, kDistributions})->Unit(benchmark::kMicrosecond);
+
+// Короткодействующие силы и столкновения по спискам соседей; третий аргумент - запас списков в сотых долях
+// При нулевом запасе списки строятся на каждом шаге, как поиск пар хеш-сеткой
+void BM_StepCutoff(benchmark::State& state) {
+  const auto c = Setup(state);
+  ps::Simulator sim(pb::MakeBodies(c.n, c.distribution), pu::Length{kCollisionDistance});
+  sim.SetGravitySolver(ps::GravitySolver::kCutoff);
+  sim.SetBroadPhase(ps::BroadPhase::kNeighborList);
+  sim.SetCutoff(pu::Length{4 * kCollisionDistance});
+  sim.SetSkin(pu::Length{0.01 * static_cast<double>(state.range(2))});
+
+  for (auto _ : state) {
+    sim.Step(pu::Time{1e-3});
+  }
+  Finish(state, c.n);
+  state.counters["rebuilds"] = static_cast<double>(sim.NeighborListRebuilds());
+}
+BENCHMARK(BM_StepCutoff)->ArgsProduct({{1000, 10000}, kDistributions, {0, 50}})->Unit(benchmark::kMicrosecond);
+
+// Ткань без гравитации: квадратная решетка со стороной в первом аргументе, пружины к соседям справа и снизу (около 2 * side^2)
+// Второй аргумент - число потоков
+void BM_StepSprings(benchmark::State& state) {
+  const auto side = static_cast<std::size_t>(state.range(0));
+  std::vector<physics::object::Object> objects;
+  for (std::size_t i = 0; i < side * side; ++i) {
+    const physics::vector::Vector<pu::Length, 3> r{pu::Length{0.1 * static_cast<double>(i % side)}, pu::Length{0.1 * static_cast<double>(i / side)},
+                                                   pu::Length{0.0}};
+    objects.emplace_back(pu::Weight{1e-3}, r, physics::vector::Vector<pu::Speed, 3>{});
+  }
+
+  // Нулевой радиус столкновений перебирал бы все пары, поэтому он меньше шага решетки, а пары берутся из списков соседей:
+  // ткань почти не движется, и шаг состоит в основном из прохода пружин
+  ps::Simulator sim(objects, pu::Length{0.01});
+  sim.EnableGravity(false);
+  sim.SetBroadPhase(ps::BroadPhase::kNeighborList);
+  sim.SetSkin(pu::Length{0.05});
+  sim.SetThreads(static_cast<std::size_t>(state.range(1)));
+  std::vector<std::uint32_t> a;
+  std::vector<std::uint32_t> b;
+  for (std::uint32_t i = 0; i < side * side; ++i) {
+    if (i % side + 1 < side) {
+      a.push_back(i);
+      b.push_back(i + 1);
+    }
+    if (i + side < side * side) {
+      a.push_back(i);
+      b.push_back(i + static_cast<std::uint32_t>(side));
+    }
+  }
+  const std::vector<double> rest(a.size(), 0.09);
+  sim.Springs().Add(a, b, rest, std::vector<double>(a.size(), 50.0), std::vector<double>(a.size(), 1e-3));
+
+  for (auto _ : state) {
+    sim.Step(pu::Time{1e-3});
+  }
+  Finish(state, side * side);
+  state.counters["springs"] = static_cast<double>(a.size());
+}
+BENCHMARK(BM_StepSprings)->ArgsProduct({{100, 224}, {1, 4}})->Unit(benchmark::kMicrosecond);
+
+// Сцена в покое: решетка неподвижных тел и каждое сотое тело в движении над ней, второй аргумент - засыпание
+// С засыпанием силы и узкая фаза достаются только бодрствующим телам
+void BM_StepSleeping(benchmark::State& state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  const auto side = static_cast<std::size_t>(std::sqrt(static_cast<double>(n)));
+  std::vector<physics::object::Object> objects;
+  for (std::size_t i = 0; i < n; ++i) {
+    const bool moving = i % 100 == 0;
+    const physics::vector::Vector<pu::Length, 3> r{pu::Length{static_cast<double>(i % side)}, pu::Length{static_cast<double>(i / side)},
+                                                   pu::Length{moving ? 5.0 : 0.0}};
+    const physics::vector::Vector<pu::Speed, 3> v{pu::Speed{moving ? 1.0 : 0.0}, pu::Speed{0.0}, pu::Speed{0.0}};
+    objects.emplace_back(pu::Weight{1.0}, r, v);
+  }
+
+  ps::Simulator sim(objects, pu::Length{kCollisionDistance});
+  sim.SetGravitySolver(ps::GravitySolver::kBarnesHut);
+  sim.SetBroadPhase(ps::BroadPhase::kSpatialHash);
+  if (state.range(1) != 0) {
+    sim.SetSleeping(pu::Speed{1e-3}, pu::Acceleration{1e-3}, 10);
+  }
+  for (int step = 0; step < 20; ++step) {
+    sim.Step(pu::Time{1e-3});
+  }
+
+  for (auto _ : state) {
+    sim.Step(pu::Time{1e-3});
+  }
+  Finish(state, n);
+  state.counters["awake"] = static_cast<double>(sim.AwakeCount());
+}
+BENCHMARK(BM_StepSleeping)->ArgsProduct({{10000, 100000}, {0, 1}})->Unit(benchmark::kMicrosecond);
+
+// Гравитация в Step собрана из этих двух частей: ядро прямой суммы и обход октодерева
+void BM_GravityDirect(benchmark::State& state) {
+  const auto c = Setup(state);
+  ps::ParticleStore p;
+  p.Assign(pb::MakeBodies(c.n, c.distribution));
+
+  ps::GravitySources sources{p.x.data(), p.y.data(), p.z.data(), p.mass.data(), p.Size()};
+  ps::GravityTargets targets{p.x.data(), p.y.data(), p.z.data(), p.ax.data(), p.ay.data(), p.az.data(), p.Size()};
+
+  for (auto _ : state) {
+    ps::AccumulateGravity(ps::DetectKernelIsa(), sources, targets, 0.0);
+    benchmark::DoNotOptimize(p.ax.data());
+    benchmark::ClobberMemory();
+  }
+  Finish(state, c.n);
+}
+BENCHMARK(BM_GravityDirect)->ArgsProduct({kQuadraticSizes, kDistributions})->Unit(benchmark::kMicrosecond);
+
+// Третий аргумент - накопление сумм float-ядра в double
+void BM_GravityDirect32(benchmark::State& state) {
+  const auto c = Setup(state);
+  const bool double_accumulators = state.range(2) != 0;
+  ps::ParticleStore32 p;
+  p.Assign(pb::MakeBodies(c.n, c.distribution));
+
+  ps::BasicGravitySources<float> sources{p.x.data(), p.y.data(), p.z.data(), p.mass.data(), p.Size()};
+  ps::BasicGravityTargets<float> targets{p.x.data(), p.y.data(), p.z.data(), p.ax.data(), p.ay.data(), p.az.data(), p.Size()};
+
+  for (auto _ : state) {
+    ps::AccumulateGravity(ps::DetectKernelIsa(), sources, targets, 0.0, double_accumulators);
+    benchmark::DoNotOptimize(p.ax.data());
+    benchmark::ClobberMemory();
+  }
+  Finish(state, c.n);
+}
+BENCHMARK(BM_GravityDirect32)->ArgsProduct({kQuadraticSizes, kDistributions, {0, 1}})->Unit(benchmark::kMicrosecond);
+
+void BM_GravityBarnesHut(benchmark::State& state) {
+  const auto c = Setup(state);
+  ps::ParticleStore p;
+  p.Assign(pb::MakeBodies(c.n, c.distribution));
+  ps::Octree octree;
+
+  for (auto _ : state) {
+    octree.Build(p);
+    for (std::size_t i = 0; i < c.n; ++i) {
+      benchmark::DoNotOptimize(octree.AccelerationOn(i, p, 0.5));
+    }
+  }
+  Finish(state, c.n);
+}
+BENCHMARK(BM_GravityBarnesHut)->ArgsProduct({kAllSizes, kDistributions})->Unit(benchmark::kMicrosecond);
+
+void BM_HandleCollisions(benchmark::State& state) {
+  const auto c = Setup(state);
+  const auto broad_phase = static_cast<ps::BroadPhase>(state.range(2));
+  ps::Simulator sim(pb::MakeBodies(c.n, c.distribution), pu::Length{kCollisionDistance});
+  sim.SetBroadPhase(broad_phase);
+
+  for (auto _ : state) {
+    sim.HandleCollisions();
+  }
+  Finish(state, c.n);
+}
+BENCHMARK(BM_HandleCollisions)
+    ->ArgsProduct({kQuadraticSizes, kDistributions, {static_cast<std::int64_t>(ps::BroadPhase::kBruteForce)}})
+    ->ArgsProduct({kAllSizes, kDistributions, {static_cast<std::int64_t>(ps::BroadPhase::kSpatialHash), static_cast<std::int64_t>(ps::BroadPhase::kSweepAndPrune)}})
+    ->Unit(benchmark::kMicrosecond);
+
+// Плотная упаковка без гравитации: радиус удара вчетверо больше обычного, около десятка контактов на тело
+// Второй аргумент - порядок ударов (ContactOrder), третий - число потоков
+void BM_StepGranular(benchmark::State& state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  ps::Simulator sim(pb::MakeBodies(n, pb::Distribution::kUniform), pu::Length{4 * kCollisionDistance});
+  sim.EnableGravity(false);
+  sim.SetBroadPhase(ps::BroadPhase::kSpatialHash);
+  sim.SetContactOrder(static_cast<ps::ContactOrder>(state.range(1)));
+  sim.SetThreads(static_cast<std::size_t>(state.range(2)));
+
+  for (auto _ : state) {
+    sim.Step(pu::Time{1e-3});
+  }
+  Finish(state, n);
+}
+BENCHMARK(BM_StepGranular)
+    ->ArgsProduct({{10000, 100000},
+                   {static_cast<std::int64_t>(ps::ContactOrder::kSequential), static_cast<std::int64_t>(ps::ContactOrder::kColored)},
+                   {1, 4}})
+    ->Unit(benchmark::kMicrosecond);
+
+// Попарное ядро kScalar; второй аргумент - детерминированный режим, третий - число потоков
+void BM_StepPairwise(benchmark::State& state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  ps::Simulator sim(pb::MakeBodies(n, pb::Distribution::kUniform), pu::Length{kCollisionDistance});
+  sim.SetKernelIsa(ps::KernelIsa::kScalar);
+  sim.SetDeterministic(state.range(1) != 0);
+  sim.SetThreads(static_cast<std::size_t>(state.range(2)));
+
+  for (auto _ : state) {
+    sim.Step(pu::Time{1e-3});
+  }
+  Finish(state, n);
+}
+BENCHMARK(BM_StepPairwise)->ArgsProduct({{1000, 10000}, {0, 1}, {1, 4}})->Unit(benchmark::kMicrosecond);
+
+// Маленькие системы: один шаг Simulator против FixedSimulator с тем же числом тел
+template <std::size_t N>
+void BM_StepSmall(benchmark::State& state) {
+  const auto bodies = pb::MakeBodies(N, pb::Distribution::kUniform);
+  ps::Simulator sim(bodies, pu::Length{kCollisionDistance});
+  sim.SetKernelIsa(ps::KernelIsa::kScalar);
+  sim.SetBroadPhase(ps::BroadPhase::kBruteForce);
+
+  for (auto _ : state) {
+    sim.Step(pu::Time{1e-3});
+  }
+  Finish(state, N);
+}
+BENCHMARK(BM_StepSmall<2>);
+BENCHMARK(BM_StepSmall<3>);
+BENCHMARK(BM_StepSmall<8>);
+
+template <std::size_t N>
+void BM_FixedStep(benchmark::State& state) {
+  const auto bodies = pb::MakeBodies(N, pb::Distribution::kUniform);
+  std::array<physics::object::Object, N> objects;
+  std::copy(bodies.begin(), bodies.end(), objects.begin());
+  ps::FixedSimulator<N> sim(objects, pu::Length{kCollisionDistance});
+
+  for (auto _ : state) {
+    sim.Step(pu::Time{1e-3});
+    benchmark::DoNotOptimize(sim);
+  }
+  Finish(state, N);
+}
+BENCHMARK(BM_FixedStep<2>);
+BENCHMARK(BM_FixedStep<3>);
+BENCHMARK(BM_FixedStep<8>);
+
+// Ансамбль из M копий трех тел против M отдельных Simulator с тем же шагом
+void BM_EnsembleStep(benchmark::State& state) {
+  const auto replicas = static_cast<std::size_t>(state.range(0));
+  ps::Ensemble ensemble(replicas, pb::MakeBodies(3, pb::Distribution::kUniform), pu::Length{kCollisionDistance});
+  ensemble.SetThreads(1);
+
+  for (auto _ : state) {
+    ensemble.Step(pu::Time{1e-3});
+  }
+  Finish(state, replicas);
+}
+BENCHMARK(BM_EnsembleStep)->RangeMultiplier(8)->Range(8, 4096)->Unit(benchmark::kMicrosecond);
+
+void BM_SeparateStep(benchmark::State& state) {
+  const auto replicas = static_cast<std::size_t>(state.range(0));
+  const auto bodies = pb::MakeBodies(3, pb::Distribution::kUniform);
+  std::vector<ps::Simulator> sims;
+  sims.reserve(replicas);
+  for (std::size_t r = 0; r < replicas; ++r) {
+    sims.emplace_back(bodies, pu::Length{kCollisionDistance});
+    sims.back().SetKernelIsa(ps::KernelIsa::kScalar);
+  }
+
+  for (auto _ : state) {
+    for (auto& sim : sims) {
+      sim.Step(pu::Time{1e-3});
+    }
+  }
+  Finish(state, replicas);
+}
+BENCHMARK(BM_SeparateStep)->RangeMultiplier(8)->Range(8, 4096)->Unit(benchmark::kMicrosecond);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <physics/object/object.hpp>
+#include <physics/units/quantity.hpp>
+#include <physics/vector/vector.hpp>
+
+namespace physics::benchmarks {
+
+// Пространственное распределение тел
+// kUniform - равномерно в кубе, kClustered - несколько плотных гауссовых сгустков
+enum class Distribution : std::int64_t {
+  kUniform = 0,
+  kClustered = 1,
+};
+
+inline const char* DistributionName(Distribution distribution) {
+  return distribution == Distribution::kUniform ? "uniform" : "clustered";
+}
+
+// Средняя плотность - одно тело на кубический метр, сторона куба n^(1/3) метров
+inline double BoxSide(std::size_t n) {
+  return std::cbrt(static_cast<double>(n));
+}
+
+inline std::vector<object::Object> MakeBodies(std::size_t n, Distribution distribution, std::uint32_t seed = 1) {
+  std::mt19937 gen(seed);
+  const double side = BoxSide(n);
+
+  std::uniform_real_distribution<double> uniform(0.0, side);
+  std::uniform_real_distribution<double> mass(1e3, 1e5);
+  std::normal_distribution<double> speed(0.0, 0.1);
+
+  constexpr std::size_t kClusters = 16;
+  std::vector<double> centers(3 * kClusters);
+  for (auto& c : centers) {
+    c = uniform(gen);
+  }
+  std::normal_distribution<double> offset(0.0, 0.05 * side);
+  std::uniform_int_distribution<std::size_t> cluster(0, kClusters - 1);
+
+  std::vector<object::Object> objects;
+  objects.reserve(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    double p[3];
+    if (distribution == Distribution::kUniform) {
+      for (auto& x : p) {
+        x = uniform(gen);
+      }
+    } else {
+      const std::size_t c = cluster(gen);
+      for (std::size_t k = 0; k < 3; ++k) {
+        p[k] = centers[3 * c + k] + offset(gen);
+      }
+    }
+
+    objects.emplace_back(units::Weight{mass(gen)}, vector::Vector<units::Length, 3>{units::Length{p[0]}, units::Length{p[1]}, units::Length{p[2]}},
+                         vector::Vector<units::Speed, 3>{units::Speed{speed(gen)}, units::Speed{speed(gen)}, units::Speed{speed(gen)}});
+  }
+  return objects;
+}
+
+}  // namespace physics::benchmarks
@@ -1,6 +1,24 @@
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <physics/io/checkpoint.hpp>
+#include <physics/io/trajectory.hpp>
+#include <physics/parallel/thread_pool.hpp>
+#include <physics/simulator/ensemble.hpp>
 #include <physics/simulator/simulator.hpp>
 #include <physics/units/quantity.hpp>
 #include <physics/vector/vector.hpp>
@@ -102,37 +120,636 @@ void bind_object(py::module_ &m) {
       .def("gravity_magnitude", &physics::object::Object::GravitationalForceMagnitude);
 }
 
+// Отдает буфер в NumPy без копирования: массив владеет вектором через capsule
+py::array_t<double> to_numpy(std::vector<double> &&data, std::vector<py::ssize_t> shape) {
+  auto *holder = new std::vector<double>(std::move(data));
+  py::capsule owner(holder, [](void *p) { delete static_cast<std::vector<double> *>(p); });
+  return py::array_t<double>(std::move(shape), holder->data(), owner);
+}
+
+// Входной массив NumPy: непрерывный, в double
+using DenseArray = py::array_t<double, py::array::c_style | py::array::forcecast>;
+
+// Общий пул формул над массивами: создается при первом вызове с threads != 1 и пересоздается, только если число потоков поменялось
+// Вызов держит свой shared_ptr, поэтому пересоздание из другого потока Python не разрушает пул под ним
+std::shared_ptr<physics::parallel::ThreadPool> formula_pool(size_t threads) {
+  static std::mutex mutex;
+  static std::shared_ptr<physics::parallel::ThreadPool> pool;
+
+  threads = threads == 0 ? physics::parallel::HardwareThreads() : threads;
+  std::lock_guard<std::mutex> lock(mutex);
+  if (!pool || pool->Size() != threads) {
+    pool = std::make_shared<physics::parallel::ThreadPool>(threads);
+  }
+  return pool;
+}
+
+// Формула над NumPy-массивами в единицах СИ: массивы из одного элемента растягиваются до общей формы, остальные должны с ней совпадать
+// Размерности проверяет типизированная перегрузка из C++; threads > 1 делит массив между потоками, 0 - по числу ядер
+template <typename>
+using ArrayArg = DenseArray;
+
+template <typename Out, typename... In, typename... Extra>
+void def_array_formula(py::module_ &m, const char *name, void (*fn)(std::span<const In>..., std::span<Out>, physics::parallel::ThreadPool *),
+                       const Extra &...extra) {
+  static_assert(((sizeof(In) == sizeof(double) && std::is_standard_layout_v<In>) && ...) && sizeof(Out) == sizeof(double),
+                "quantities must be laid out as plain doubles");
+
+  m.def(
+      name,
+      [fn](const ArrayArg<In> &...arrays, size_t threads) {
+        const std::array<const DenseArray *, sizeof...(In)> args{&arrays...};
+
+        const DenseArray *shape_of = args[0];
+        for (const auto *a : args) {
+          if (a->size() != 1) {
+            shape_of = a;
+            break;
+          }
+        }
+        const std::vector<py::ssize_t> shape(shape_of->shape(), shape_of->shape() + shape_of->ndim());
+        const size_t n = static_cast<size_t>(shape_of->size());
+
+        std::array<std::vector<double>, sizeof...(In)> expanded;
+        std::array<const double *, sizeof...(In)> data;
+        for (size_t k = 0; k < args.size(); ++k) {
+          const auto *a = args[k];
+          if (a->size() == 1 && n != 1) {
+            expanded[k].assign(n, *a->data());
+            data[k] = expanded[k].data();
+            continue;
+          }
+          if (a->ndim() != shape_of->ndim() || !std::equal(shape.begin(), shape.end(), a->shape())) {
+            throw std::invalid_argument("operands could not be broadcast together");
+          }
+          data[k] = a->data();
+        }
+
+        std::vector<double> result(n);
+        {
+          py::gil_scoped_release release;
+          std::shared_ptr<physics::parallel::ThreadPool> pool;
+          if (threads != 1) {
+            pool = formula_pool(threads);
+          }
+          [&]<size_t... I>(std::index_sequence<I...>) {
+            fn(std::span<const In>(reinterpret_cast<const In *>(data[I]), n)..., std::span<Out>(reinterpret_cast<Out *>(result.data()), n), pool.get());
+          }(std::index_sequence_for<In...>{});
+        }
+        return to_numpy(std::move(result), shape);
+      },
+      extra..., py::arg("threads") = 1);
+}
+
 void bind_mechanics(py::module_ &m) {
   using namespace physics::mech;
+  using physics::units::Acceleration;
+  using physics::units::Energy;
+  using physics::units::Force;
+  using physics::units::Length;
+  using physics::units::Quantity;
+  using physics::units::Speed;
+  using physics::units::SpringConstant;
+  using physics::units::Time;
+  using physics::units::Weight;
 
-  m.def("kinetic_energy", &KineticEnergy);
-  m.def("potential_energy", &PotentialEnergy);
-  m.def("newton_second_law", &NewtonSecondLaw);
-  m.def("average_speed", &AverageSpeed);
-  m.def("uniform_motion", &UniformMotion);
-  m.def("accelerated_motion", &AcceleratedMotion);
-  m.def("momentum", &Momentum);
-  m.def("work", &Work);
-  m.def("friction", &Friction);
-  m.def("static_friction_max", &StaticFrictionMax);
-  m.def("elastic_force", &ElasticForce);
-  m.def("elastic_potential_energy", &ElasticPotentialEnergy);
+  m.def("kinetic_energy", py::overload_cast<Weight, Speed>(&KineticEnergy));
+  m.def("potential_energy", py::overload_cast<Weight, Acceleration, Length>(&PotentialEnergy));
+  m.def("newton_second_law", py::overload_cast<Weight, Acceleration>(&NewtonSecondLaw));
+  m.def("average_speed", py::overload_cast<Length, Time>(&AverageSpeed));
+  m.def("uniform_motion", py::overload_cast<Length, Speed, Time>(&UniformMotion));
+  m.def("accelerated_motion", py::overload_cast<Length, Speed, Acceleration, Time>(&AcceleratedMotion));
+  m.def("momentum", py::overload_cast<Weight, Speed>(&Momentum));
+  m.def("work", py::overload_cast<Force, Length>(&Work));
+  m.def("friction", py::overload_cast<Quantity<0, 0, 0>, Force>(&Friction));
+  m.def("static_friction_max", py::overload_cast<Quantity<0, 0, 0>, Force>(&StaticFrictionMax));
+  m.def("elastic_force", py::overload_cast<SpringConstant, Length>(&ElasticForce));
+  m.def("elastic_potential_energy", py::overload_cast<SpringConstant, Length>(&ElasticPotentialEnergy));
+
+  // Те же имена для массивов: kinetic_energy(np.array(...), np.array(...), threads=4) возвращает ndarray
+  def_array_formula<Energy, Weight, Speed>(m, "kinetic_energy", &KineticEnergy, py::arg("mass"), py::arg("speed"));
+  def_array_formula<Energy, Weight, Acceleration, Length>(m, "potential_energy", &PotentialEnergy, py::arg("mass"), py::arg("g"), py::arg("height"));
+  def_array_formula<Force, Weight, Acceleration>(m, "newton_second_law", &NewtonSecondLaw, py::arg("mass"), py::arg("accel"));
+  def_array_formula<Speed, Length, Time>(m, "average_speed", &AverageSpeed, py::arg("distance"), py::arg("time"));
+  def_array_formula<Length, Length, Speed, Time>(m, "uniform_motion", &UniformMotion, py::arg("initial"), py::arg("speed"), py::arg("time"));
+  def_array_formula<Length, Length, Speed, Acceleration, Time>(m, "accelerated_motion", &AcceleratedMotion, py::arg("initial"), py::arg("v0"),
+                                                               py::arg("a"), py::arg("t"));
+  def_array_formula<Quantity<0, 1, 1>, Weight, Speed>(m, "momentum", &Momentum, py::arg("mass"), py::arg("speed"));
+  def_array_formula<Energy, Force, Length>(m, "work", &Work, py::arg("force"), py::arg("displacement"));
+  def_array_formula<Force, Quantity<0, 0, 0>, Force>(m, "friction", &Friction, py::arg("friction_coef"), py::arg("normal_force"));
+  def_array_formula<Force, Quantity<0, 0, 0>, Force>(m, "static_friction_max", &StaticFrictionMax, py::arg("static_coef"), py::arg("normal_force"));
+  def_array_formula<Force, SpringConstant, Length>(m, "elastic_force", &ElasticForce, py::arg("k"), py::arg("x"));
+  def_array_formula<Energy, SpringConstant, Length>(m, "elastic_potential_energy", &ElasticPotentialEnergy, py::arg("k"), py::arg("x"));
 }
 
-void bind_simulator(py::module_ &m) {
+void bind_gravity(py::module_ &m) {
+  using namespace physics::gravity;
+  using physics::units::Acceleration;
+  using physics::units::Energy;
+  using physics::units::Force;
+  using physics::units::Length;
+  using physics::units::Speed;
+  using physics::units::Weight;
+
+  m.def("gravitational_force", py::overload_cast<Weight, Weight, Length>(&GravitationalForce));
+  m.def("gravitational_acceleration", py::overload_cast<Weight, Length>(&GravitationalAcceleration));
+  m.def("gravitational_potential_energy", py::overload_cast<Weight, Weight, Length>(&GravitationalPotentialEnergy));
+  m.def("escape_velocity", py::overload_cast<Weight, Length>(&EscapeVelocity));
+  m.def("orbital_velocity", py::overload_cast<Weight, Length>(&OrbitalVelocity));
+
+  def_array_formula<Force, Weight, Weight, Length>(m, "gravitational_force", &GravitationalForce, py::arg("m1"), py::arg("m2"), py::arg("distance"));
+  def_array_formula<Acceleration, Weight, Length>(m, "gravitational_acceleration", &GravitationalAcceleration, py::arg("mass"), py::arg("radius"));
+  def_array_formula<Energy, Weight, Weight, Length>(m, "gravitational_potential_energy", &GravitationalPotentialEnergy, py::arg("m1"), py::arg("m2"),
+                                                    py::arg("distance"));
+  def_array_formula<Speed, Weight, Length>(m, "escape_velocity", &EscapeVelocity, py::arg("planet"), py::arg("radius"));
+  def_array_formula<Speed, Weight, Length>(m, "orbital_velocity", &OrbitalVelocity, py::arg("planet"), py::arg("radius"));
+}
+
+
+// Массив (n, 3) из трех компонент ParticleStore; float-компоненты расширяются до double
+template <typename S>
+py::array_t<double> stack_xyz(const std::vector<S> &x, const std::vector<S> &y, const std::vector<S> &z) {
+  std::vector<double> data(3 * x.size());
+  for (size_t i = 0; i < x.size(); i++) {
+    data[3 * i] = x[i];
+    data[3 * i + 1] = y[i];
+    data[3 * i + 2] = z[i];
+  }
+  return to_numpy(std::move(data), {static_cast<py::ssize_t>(x.size()), 3});
+}
+
+// Ряд диагностики как словарь NumPy-массивов: скаляры формы (k,), векторы формы (k, 3)
+py::dict diagnostics_arrays(const std::vector<physics::simulator::Diagnostics> &series) {
+  const auto k = static_cast<py::ssize_t>(series.size());
+  std::vector<double> step;
+  std::vector<double> time;
+  std::vector<double> mass;
+  std::vector<double> kinetic;
+  std::vector<double> potential;
+  std::vector<double> total;
+  std::vector<double> momentum;
+  std::vector<double> angular_momentum;
+  std::vector<double> center_of_mass;
+  for (const auto &d : series) {
+    step.push_back(static_cast<double>(d.step));
+    time.push_back(d.time);
+    mass.push_back(d.mass);
+    kinetic.push_back(d.kinetic);
+    potential.push_back(d.potential);
+    total.push_back(d.Total());
+    momentum.insert(momentum.end(), d.momentum, d.momentum + 3);
+    angular_momentum.insert(angular_momentum.end(), d.angular_momentum, d.angular_momentum + 3);
+    center_of_mass.insert(center_of_mass.end(), d.center_of_mass, d.center_of_mass + 3);
+  }
+
+  py::dict result;
+  result["step"] = to_numpy(std::move(step), {k});
+  result["time"] = to_numpy(std::move(time), {k});
+  result["mass"] = to_numpy(std::move(mass), {k});
+  result["kinetic"] = to_numpy(std::move(kinetic), {k});
+  result["potential"] = to_numpy(std::move(potential), {k});
+  result["total"] = to_numpy(std::move(total), {k});
+  result["momentum"] = to_numpy(std::move(momentum), {k, 3});
+  result["angular_momentum"] = to_numpy(std::move(angular_momentum), {k, 3});
+  result["center_of_mass"] = to_numpy(std::move(center_of_mass), {k, 3});
+  return result;
+}
+
+// Номера тел из NumPy: непрерывный массив целых
+using IndexArray = py::array_t<std::int64_t, py::array::c_style | py::array::forcecast>;
+
+// Пакетное добавление пружин: a и b одной длины, параметры такой же длины или из одного элемента
+// Без rest_length длиной покоя становится текущее расстояние между телами
+template <typename Simulator>
+void add_springs(Simulator &sim, const IndexArray &a, const IndexArray &b, const DenseArray &stiffness, const DenseArray &damping,
+                 const py::object &rest_length) {
+  const size_t n = static_cast<size_t>(a.size());
+  if (static_cast<size_t>(b.size()) != n) {
+    throw std::invalid_argument("a and b must have the same length");
+  }
+
+  const size_t bodies = sim.Size();
+  std::vector<std::uint32_t> first(n);
+  std::vector<std::uint32_t> second(n);
+  for (size_t s = 0; s < n; s++) {
+    const std::int64_t i = a.data()[s];
+    const std::int64_t j = b.data()[s];
+    if (i < 0 || j < 0 || static_cast<size_t>(i) >= bodies || static_cast<size_t>(j) >= bodies) {
+      throw std::out_of_range("spring " + std::to_string(s) + " connects a body outside of " + std::to_string(bodies));
+    }
+    first[s] = static_cast<std::uint32_t>(i);
+    second[s] = static_cast<std::uint32_t>(j);
+  }
+
+  const auto expand = [n](const DenseArray &values, const char *name) {
+    if (values.size() == 1) {
+      return std::vector<double>(n, *values.data());
+    }
+    if (static_cast<size_t>(values.size()) != n) {
+      throw std::invalid_argument(std::string(name) + " must have one value or one per spring");
+    }
+    return std::vector<double>(values.data(), values.data() + n);
+  };
+  const auto k = expand(stiffness, "stiffness");
+  const auto c = expand(damping, "damping");
+
+  std::vector<double> rest;
+  if (rest_length.is_none()) {
+    const auto &p = std::as_const(sim).Particles();
+    rest.resize(n);
+    for (size_t s = 0; s < n; s++) {
+      const double dx = p.x[second[s]] - p.x[first[s]];
+      const double dy = p.y[second[s]] - p.y[first[s]];
+      const double dz = p.z[second[s]] - p.z[first[s]];
+      rest[s] = std::sqrt(dx * dx + dy * dy + dz * dz);
+    }
+  } else {
+    rest = expand(rest_length.cast<DenseArray>(), "rest_length");
+  }
+
+  py::gil_scoped_release release;
+  sim.Springs().Add(first, second, rest, k, c);
+}
+
+// Simulator и Simulator32 отличаются только типом хранения тел, интерфейс в Python одинаковый
+template <typename Simulator>
+void bind_simulator_class(py::module_ &m, const char *name) {
   using physics::object::Object;
-  using physics::simulator::Simulator;
   using physics::units::Length;
   using physics::units::Time;
 
-  py::class_<Simulator>(m, "Simulator")
+  py::class_<Simulator>(m, name)
       .def(py::init<>())
       .def(py::init<Length>(), py::arg("collision_distance"))
       .def(py::init<std::vector<Object>, Length>(), py::arg("objects"), py::arg("collision_distance"))
-      .def("step", &Simulator::Step, py::arg("dt"))
-      .def("objects", static_cast<std::vector<Object> &(Simulator::*)()>(&Simulator::Objects), py::return_value_policy::reference_internal)
+      .def("step", &Simulator::Step, py::arg("dt"), py::call_guard<py::gil_scoped_release>())
+      // Копия: ссылки на элементы устарели бы после шага
+      .def("objects", static_cast<const std::vector<Object> &(Simulator::*)() const>(&Simulator::Objects), py::return_value_policy::copy)
+      .def(
+          "run",
+          [](Simulator &sim, size_t steps, Time dt, size_t record_every, bool velocities) -> py::object {
+            physics::simulator::Trajectory trajectory;
+            {
+              py::gil_scoped_release release;
+              trajectory = sim.Run(steps, dt, record_every, velocities);
+            }
+
+            std::vector<py::ssize_t> shape{static_cast<py::ssize_t>(trajectory.frames), static_cast<py::ssize_t>(trajectory.bodies), 3};
+            auto positions = to_numpy(std::move(trajectory.positions), shape);
+            if (!velocities) {
+              return positions;
+            }
+            return py::make_tuple(positions, to_numpy(std::move(trajectory.velocities), shape));
+          },
+          py::arg("steps"), py::arg("dt"), py::arg("record_every") = 1, py::arg("velocities") = false,
+          "Runs steps steps and returns positions of shape (frames, bodies, 3), plus velocities if requested")
+      .def("positions", [](const Simulator &sim) {
+        const auto &p = sim.Particles();
+        return stack_xyz(p.x, p.y, p.z);
+      })
+      .def("velocities", [](const Simulator &sim) {
+        const auto &p = sim.Particles();
+        return stack_xyz(p.vx, p.vy, p.vz);
+      })
       .def("enable_gravity", &Simulator::EnableGravity, py::arg("enabled"))
-      .def("gravity_enabled", &Simulator::GravityEnabled);
+      .def("gravity_enabled", &Simulator::GravityEnabled)
+      .def("set_gravity_solver", &Simulator::SetGravitySolver, py::arg("solver"))
+      .def("gravity_solver", &Simulator::GetGravitySolver)
+      .def("set_mesh_options", &Simulator::SetMeshOptions, py::arg("options"))
+      .def("mesh_options", &Simulator::GetMeshOptions)
+      .def("set_theta", &Simulator::SetTheta, py::arg("theta"))
+      .def("theta", &Simulator::Theta)
+      .def("set_cutoff", &Simulator::SetCutoff, py::arg("cutoff"))
+      .def("cutoff", &Simulator::Cutoff)
+      .def("set_skin", &Simulator::SetSkin, py::arg("skin"))
+      .def("skin", &Simulator::Skin)
+      .def("neighbor_list_rebuilds", &Simulator::NeighborListRebuilds)
+      .def("set_softening", &Simulator::SetSoftening, py::arg("softening"))
+      .def("softening", &Simulator::Softening)
+      .def("set_kernel_isa", &Simulator::SetKernelIsa, py::arg("isa"))
+      .def("kernel_isa", &Simulator::GetKernelIsa)
+      .def("set_double_accumulators", &Simulator::SetDoubleAccumulators, py::arg("enabled"))
+      .def("double_accumulators", &Simulator::DoubleAccumulators)
+      .def("set_deterministic", &Simulator::SetDeterministic, py::arg("enabled"))
+      .def("deterministic", &Simulator::Deterministic)
+      .def("set_threads", &Simulator::SetThreads, py::arg("threads"))
+      .def("threads", &Simulator::Threads)
+      .def("set_collision_mode", &Simulator::SetCollisionMode, py::arg("mode"))
+      .def("collision_mode", &Simulator::GetCollisionMode)
+      .def("set_contact_order", &Simulator::SetContactOrder, py::arg("order"))
+      .def("contact_order", &Simulator::GetContactOrder)
+      .def("set_broad_phase", &Simulator::SetBroadPhase, py::arg("broad_phase"))
+      .def("broad_phase", &Simulator::GetBroadPhase)
+      .def("set_integrator", &Simulator::SetIntegrator, py::arg("integrator"))
+      .def("integrator", &Simulator::GetIntegrator)
+      .def("set_block_time_steps", &Simulator::SetBlockTimeSteps, py::arg("max_level"))
+      .def("block_time_steps", &Simulator::BlockTimeSteps)
+      .def("set_time_step_accuracy", &Simulator::SetTimeStepAccuracy, py::arg("eta"))
+      .def("time_step_accuracy", &Simulator::TimeStepAccuracy)
+      .def("time_step_level", &Simulator::TimeStepLevel, py::arg("index"))
+      .def("set_collision_distance", &Simulator::SetCollisionDistance, py::arg("distance"))
+      .def("collision_distance", &Simulator::CollisionDistance)
+      .def("step_count", &Simulator::StepCount)
+      .def("elapsed_time", &Simulator::ElapsedTime)
+      .def("set_clock", &Simulator::SetClock, py::arg("step_count"), py::arg("elapsed_time"))
+      .def("stats", &Simulator::Stats, py::return_value_policy::copy)
+      .def("reset_stats", &Simulator::ResetStats)
+      .def("enable_trace", &Simulator::EnableTrace, py::arg("enabled"))
+      .def("write_trace", &Simulator::WriteTrace, py::arg("path"))
+      .def("set_recorder", &Simulator::SetRecorder, py::arg("recorder"))
+      .def("recorder", &Simulator::Recorder)
+      .def("set_diagnostics", &Simulator::SetDiagnostics, py::arg("every"))
+      .def("diagnostics_every", &Simulator::DiagnosticsEvery)
+      .def(
+          "diagnostics",
+          [](Simulator &sim) {
+            const std::vector<physics::simulator::Diagnostics> *series = nullptr;
+            {
+              py::gil_scoped_release release;
+              series = &sim.DiagnosticsSeries();
+            }
+            return diagnostics_arrays(*series);
+          },
+          "Recorded time series as a dict of arrays: step, time, mass, kinetic, potential, total of shape (k,) "
+          "and momentum, angular_momentum, center_of_mass of shape (k, 3)")
+      .def("clear_diagnostics", &Simulator::ClearDiagnostics)
+      .def("compute_diagnostics", &Simulator::ComputeDiagnostics, py::call_guard<py::gil_scoped_release>())
+      .def("add_springs", &add_springs<Simulator>, py::arg("a"), py::arg("b"), py::arg("stiffness"), py::arg("damping") = 0.0,
+           py::arg("rest_length") = py::none(),
+           "Adds springs between bodies a[i] and b[i]; stiffness, damping and rest_length take one value or one per spring, "
+           "rest_length defaults to the current distances")
+      .def("set_sleeping", &Simulator::SetSleeping, py::arg("speed"), py::arg("acceleration"), py::arg("steps"),
+           "Puts bodies to sleep after steps steps with |v| <= speed and |a| <= acceleration; steps = 0 disables sleeping")
+      .def("sleep_speed", &Simulator::SleepSpeed)
+      .def("sleep_acceleration", &Simulator::SleepAcceleration)
+      .def("sleep_steps", &Simulator::SleepSteps)
+      .def("asleep", &Simulator::Asleep, py::arg("index"))
+      .def("awake_count", &Simulator::AwakeCount)
+      .def("wake_up", &Simulator::WakeUp, py::arg("index"))
+      .def("wake_all", &Simulator::WakeAll)
+      .def("spring_count", [](const Simulator &sim) { return sim.Springs().Size(); })
+      .def("clear_springs", [](Simulator &sim) { sim.Springs().Clear(); })
+      .def(
+          "spring_tensions",
+          [](const Simulator &sim) {
+            std::vector<double> tensions(sim.Springs().Size());
+            {
+              py::gil_scoped_release release;
+              auto *out = reinterpret_cast<physics::units::Force *>(tensions.data());
+              sim.Springs().Tensions(sim.Particles(), std::span<physics::units::Force>(out, tensions.size()));
+            }
+            const auto m = static_cast<py::ssize_t>(tensions.size());
+            return to_numpy(std::move(tensions), {m});
+          },
+          "Elastic force k * (L - L0) of every spring without damping, positive when stretched");
+}
+
+// Проверяет форму массива (replicas, bodies[, 3]) перед копированием в Ensemble
+
+const double *ensemble_data(const physics::simulator::Ensemble &ensemble, const DenseArray &array, bool xyz) {
+  const bool ok = array.ndim() == (xyz ? 3 : 2) && static_cast<size_t>(array.shape(0)) == ensemble.Replicas() &&
+                  static_cast<size_t>(array.shape(1)) == ensemble.Bodies() && (!xyz || array.shape(2) == 3);
+  if (!ok) {
+    throw std::invalid_argument(xyz ? "expected array of shape (replicas, bodies, 3)" : "expected array of shape (replicas, bodies)");
+  }
+  return array.data();
+}
+
+void bind_ensemble(py::module_ &m) {
+  using physics::object::Object;
+  using physics::simulator::Ensemble;
+  using physics::units::Length;
+  using physics::units::Time;
+
+  const auto xyz_shape = [](const Ensemble &ensemble) {
+    return std::vector<py::ssize_t>{static_cast<py::ssize_t>(ensemble.Replicas()), static_cast<py::ssize_t>(ensemble.Bodies()), 3};
+  };
+
+  py::class_<Ensemble>(m, "Ensemble")
+      .def(py::init<size_t, std::vector<Object>, Length>(), py::arg("replicas"), py::arg("objects"), py::arg("collision_distance"))
+      .def("replicas", &Ensemble::Replicas)
+      .def("bodies", &Ensemble::Bodies)
+      .def("set", &Ensemble::Set, py::arg("replica"), py::arg("body"), py::arg("object"))
+      .def("get", &Ensemble::Get, py::arg("replica"), py::arg("body"))
+      .def(
+          "set_positions", [](Ensemble &ensemble, const DenseArray &data) { ensemble.SetPositions(ensemble_data(ensemble, data, true)); },
+          py::arg("positions"), "Sets positions from an array of shape (replicas, bodies, 3)")
+      .def(
+          "set_velocities", [](Ensemble &ensemble, const DenseArray &data) { ensemble.SetVelocities(ensemble_data(ensemble, data, true)); },
+          py::arg("velocities"), "Sets velocities from an array of shape (replicas, bodies, 3)")
+      .def(
+          "set_masses", [](Ensemble &ensemble, const DenseArray &data) { ensemble.SetMasses(ensemble_data(ensemble, data, false)); },
+          py::arg("masses"), "Sets masses from an array of shape (replicas, bodies)")
+      .def("positions",
+           [xyz_shape](const Ensemble &ensemble) {
+             std::vector<double> data(ensemble.Replicas() * ensemble.Bodies() * 3);
+             ensemble.GetPositions(data.data());
+             return to_numpy(std::move(data), xyz_shape(ensemble));
+           })
+      .def("velocities",
+           [xyz_shape](const Ensemble &ensemble) {
+             std::vector<double> data(ensemble.Replicas() * ensemble.Bodies() * 3);
+             ensemble.GetVelocities(data.data());
+             return to_numpy(std::move(data), xyz_shape(ensemble));
+           })
+      .def("masses",
+           [](const Ensemble &ensemble) {
+             std::vector<double> data(ensemble.Replicas() * ensemble.Bodies());
+             ensemble.GetMasses(data.data());
+             return to_numpy(std::move(data), {static_cast<py::ssize_t>(ensemble.Replicas()), static_cast<py::ssize_t>(ensemble.Bodies())});
+           })
+      .def("collision_counts", &Ensemble::CollisionCounts, "Resolved collisions per replica since construction")
+      .def("step", &Ensemble::Step, py::arg("dt"), py::call_guard<py::gil_scoped_release>())
+      .def("run", &Ensemble::Run, py::arg("steps"), py::arg("dt"), py::call_guard<py::gil_scoped_release>())
+      .def("enable_gravity", &Ensemble::EnableGravity, py::arg("enabled"))
+      .def("gravity_enabled", &Ensemble::GravityEnabled)
+      .def("set_softening", &Ensemble::SetSoftening, py::arg("softening"))
+      .def("softening", &Ensemble::Softening)
+      .def("set_integrator", &Ensemble::SetIntegrator, py::arg("integrator"))
+      .def("integrator", &Ensemble::GetIntegrator)
+      .def("set_kernel_isa", &Ensemble::SetKernelIsa, py::arg("isa"))
+      .def("kernel_isa", &Ensemble::GetKernelIsa)
+      .def("set_threads", &Ensemble::SetThreads, py::arg("threads"))
+      .def("threads", &Ensemble::Threads)
+      .def("set_collision_distance", &Ensemble::SetCollisionDistance, py::arg("distance"))
+      .def("collision_distance", &Ensemble::CollisionDistance)
+      .def("step_count", &Ensemble::StepCount)
+      .def("elapsed_time", &Ensemble::ElapsedTime);
+}
+
+void bind_simulator(py::module_ &m) {
+  using physics::simulator::BroadPhase;
+  using physics::simulator::CollisionMode;
+  using physics::simulator::ContactOrder;
+  using physics::simulator::GravitySolver;
+  using physics::simulator::Integrator;
+  using physics::simulator::KernelIsa;
+  using physics::simulator::MeshAssignment;
+  using physics::simulator::MeshBoundary;
+  using physics::simulator::MeshOptions;
+  using physics::simulator::StepPhase;
+  using physics::simulator::StepStats;
+
+  py::enum_<GravitySolver>(m, "GravitySolver")
+      .value("DIRECT", GravitySolver::kDirect)
+      .value("BARNES_HUT", GravitySolver::kBarnesHut)
+      .value("PARTICLE_MESH", GravitySolver::kParticleMesh)
+      .value("CUTOFF", GravitySolver::kCutoff);
+
+  py::enum_<MeshAssignment>(m, "MeshAssignment")
+      .value("CIC", MeshAssignment::kCic)
+      .value("TSC", MeshAssignment::kTsc);
+
+  py::enum_<MeshBoundary>(m, "MeshBoundary")
+      .value("PERIODIC", MeshBoundary::kPeriodic)
+      .value("ISOLATED", MeshBoundary::kIsolated);
+
+  py::class_<MeshOptions>(m, "MeshOptions")
+      .def(py::init<>())
+      .def_readwrite("grid", &MeshOptions::grid)
+      .def_readwrite("assignment", &MeshOptions::assignment)
+      .def_readwrite("boundary", &MeshOptions::boundary)
+      .def_readwrite("box_size", &MeshOptions::box_size)
+      .def_readwrite("short_range", &MeshOptions::short_range)
+      .def_readwrite("split", &MeshOptions::split)
+      .def_readwrite("cutoff", &MeshOptions::cutoff);
+
+  py::enum_<KernelIsa>(m, "KernelIsa")
+      .value("SCALAR", KernelIsa::kScalar)
+      .value("SSE2", KernelIsa::kSse2)
+      .value("AVX2", KernelIsa::kAvx2)
+      .value("AVX512", KernelIsa::kAvx512);
+
+  m.def("detect_kernel_isa", &physics::simulator::DetectKernelIsa);
+
+  py::enum_<BroadPhase>(m, "BroadPhase")
+      .value("BRUTE_FORCE", BroadPhase::kBruteForce)
+      .value("SPATIAL_HASH", BroadPhase::kSpatialHash)
+      .value("SWEEP_AND_PRUNE", BroadPhase::kSweepAndPrune)
+      .value("NEIGHBOR_LIST", BroadPhase::kNeighborList);
+
+  py::enum_<Integrator>(m, "Integrator")
+      .value("SEMI_IMPLICIT_EULER", Integrator::kSemiImplicitEuler)
+      .value("VELOCITY_VERLET", Integrator::kVelocityVerlet)
+      .value("LEAPFROG", Integrator::kLeapfrog)
+      .value("YOSHIDA4", Integrator::kYoshida4)
+      .value("RK4", Integrator::kRungeKutta4);
+
+  py::enum_<CollisionMode>(m, "CollisionMode")
+      .value("DISCRETE", CollisionMode::kDiscrete)
+      .value("CONTINUOUS", CollisionMode::kContinuous)
+      .value("EVENT_DRIVEN", CollisionMode::kEventDriven);
+
+  py::enum_<ContactOrder>(m, "ContactOrder")
+      .value("SEQUENTIAL", ContactOrder::kSequential)
+      .value("COLORED", ContactOrder::kColored);
+
+  py::enum_<StepPhase>(m, "StepPhase")
+      .value("STEP", StepPhase::kStep)
+      .value("GRAVITY", StepPhase::kGravity)
+      .value("INTEGRATION", StepPhase::kIntegration)
+      .value("COLLISIONS", StepPhase::kCollisions)
+      .value("RECORDING", StepPhase::kRecording);
+
+  m.attr("stats_enabled") = physics::simulator::kStatsEnabled;
+
+  py::class_<StepStats>(m, "StepStats")
+      .def_readonly("steps", &StepStats::steps)
+      .def_readonly("pairs_examined", &StepStats::pairs_examined)
+      .def_readonly("collisions_resolved", &StepStats::collisions_resolved)
+      .def_readonly("bodies_integrated", &StepStats::bodies_integrated)
+      .def("seconds", &StepStats::Seconds, py::arg("phase"))
+      .def("phase_seconds",
+           [](const StepStats &stats) {
+             py::dict result;
+             for (size_t k = 0; k < physics::simulator::kStepPhaseCount; ++k) {
+               result[physics::simulator::StepPhaseName(static_cast<StepPhase>(k))] = stats.phase_seconds[k];
+             }
+             return result;
+           },
+           "Wall time per phase in seconds, keyed by phase name");
+
+  using physics::simulator::Diagnostics;
+  auto xyz = [](const double(&v)[3]) { return py::make_tuple(v[0], v[1], v[2]); };
+  py::class_<Diagnostics>(m, "Diagnostics")
+      .def_readonly("step", &Diagnostics::step)
+      .def_readonly("time", &Diagnostics::time)
+      .def_readonly("mass", &Diagnostics::mass)
+      .def_readonly("kinetic", &Diagnostics::kinetic)
+      .def_readonly("potential", &Diagnostics::potential)
+      .def_property_readonly("total", &Diagnostics::Total)
+      .def_property_readonly("momentum", [xyz](const Diagnostics &d) { return xyz(d.momentum); })
+      .def_property_readonly("angular_momentum", [xyz](const Diagnostics &d) { return xyz(d.angular_momentum); })
+      .def_property_readonly("center_of_mass", [xyz](const Diagnostics &d) { return xyz(d.center_of_mass); });
+
+  bind_simulator_class<physics::simulator::Simulator>(m, "Simulator");
+  bind_simulator_class<physics::simulator::Simulator32>(m, "Simulator32");
+
+  m.def("save_checkpoint", &physics::io::SaveCheckpoint<double>, py::arg("simulator"), py::arg("path"), py::call_guard<py::gil_scoped_release>());
+  m.def("save_checkpoint", &physics::io::SaveCheckpoint<float>, py::arg("simulator"), py::arg("path"), py::call_guard<py::gil_scoped_release>());
+  m.def("load_checkpoint", &physics::io::LoadCheckpoint<double>, py::arg("path"), py::arg("simulator"), py::call_guard<py::gil_scoped_release>());
+  m.def("load_checkpoint", &physics::io::LoadCheckpoint<float>, py::arg("path"), py::arg("simulator"), py::call_guard<py::gil_scoped_release>());
+
+  bind_ensemble(m);
+}
+
+void bind_io(py::module_ &m) {
+  using physics::io::Compression;
+  using physics::io::TrajectoryReader;
+  using physics::io::TrajectoryWriter;
+  using physics::io::TrajectoryWriterOptions;
+
+  py::enum_<Compression>(m, "Compression")
+      .value("NONE", Compression::kNone)
+      .value("ZLIB", Compression::kZlib);
+
+  m.def("compression_available", &physics::io::CompressionAvailable, py::arg("compression"));
+
+  py::class_<TrajectoryWriterOptions>(m, "TrajectoryWriterOptions")
+      .def(py::init<>())
+      .def_readwrite("record_every", &TrajectoryWriterOptions::record_every)
+      .def_readwrite("velocities", &TrajectoryWriterOptions::velocities)
+      .def_readwrite("frames_per_chunk", &TrajectoryWriterOptions::frames_per_chunk)
+      .def_readwrite("buffers", &TrajectoryWriterOptions::buffers)
+      .def_readwrite("compression", &TrajectoryWriterOptions::compression)
+      .def_readwrite("compression_level", &TrajectoryWriterOptions::compression_level);
+
+  py::class_<TrajectoryWriter, std::shared_ptr<TrajectoryWriter>>(m, "TrajectoryWriter")
+      .def(py::init<const std::string &, const TrajectoryWriterOptions &>(), py::arg("path"), py::arg("options") = TrajectoryWriterOptions{})
+      .def("close", &TrajectoryWriter::Close, py::call_guard<py::gil_scoped_release>())
+      .def("record_every", &TrajectoryWriter::RecordEvery)
+      .def("frames_recorded", &TrajectoryWriter::FramesRecorded)
+      .def("__enter__", [](std::shared_ptr<TrajectoryWriter> writer) { return writer; })
+      .def("__exit__", [](TrajectoryWriter &writer, py::object, py::object, py::object) {
+        py::gil_scoped_release release;
+        writer.Close();
+      });
+
+  py::class_<TrajectoryReader>(m, "TrajectoryReader")
+      .def(py::init<const std::string &>(), py::arg("path"))
+      .def("__len__", &TrajectoryReader::Frames)
+      .def("frames", &TrajectoryReader::Frames)
+      .def("bodies", &TrajectoryReader::Bodies)
+      .def("has_velocities", &TrajectoryReader::HasVelocities)
+      .def("record_every", &TrajectoryReader::RecordEvery)
+      .def("step", &TrajectoryReader::Step, py::arg("frame"))
+      .def("time", &TrajectoryReader::Time, py::arg("frame"))
+      .def(
+          "positions",
+          [](const TrajectoryReader &reader, size_t frame) {
+            std::vector<double> data(3 * reader.Bodies());
+            reader.ReadPositions(frame, data.data());
+            return to_numpy(std::move(data), {static_cast<py::ssize_t>(reader.Bodies()), 3});
+          },
+          py::arg("frame"), "Positions of one frame, shape (bodies, 3)")
+      .def(
+          "velocities",
+          [](const TrajectoryReader &reader, size_t frame) {
+            std::vector<double> data(3 * reader.Bodies());
+            reader.ReadVelocities(frame, data.data());
+            return to_numpy(std::move(data), {static_cast<py::ssize_t>(reader.Bodies()), 3});
+          },
+          py::arg("frame"), "Velocities of one frame, shape (bodies, 3)");
 }
 
 PYBIND11_MODULE(_core, m) {
@@ -147,6 +764,8 @@ PYBIND11_MODULE(_core, m) {
   bind_vector<physics::units::Force, 3>(m, "Vector3Force");
 
   bind_mechanics(m);
+  bind_gravity(m);
   bind_object(m);
   bind_simulator(m);
+  bind_io(m);
 }
\ No newline at end of file
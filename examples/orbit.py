@@ -2,7 +2,6 @@ import physics
 import matplotlib.pyplot as plt
 from matplotlib.animation import FuncAnimation, FFMpegWriter
 import numpy as np
-from tqdm import tqdm
 
 sun = physics.Object(
     physics.Mass(1.98847e30),
@@ -35,26 +34,17 @@ asteroid = physics.Object(
 )
 
 sim = physics.Simulator([sun, earth, asteroid], physics.Length(1e7))
+sim.set_integrator(physics.Integrator.VELOCITY_VERLET)
 
 dt = physics.Time(60 * 60)
 steps = 365 * 24
 
-earth_xs, earth_ys = [], []
-ast_xs, ast_ys = [], []
-
-for _ in tqdm(range(steps)):
-    sim.step(dt)
-    e = sim.objects()[1]
-    a = sim.objects()[2]
-    earth_xs.append(e.position[0].value)
-    earth_ys.append(e.position[1].value)
-    ast_xs.append(a.position[0].value)
-    ast_ys.append(a.position[1].value)
-
-earth_xs = np.array(earth_xs) / 1e9
-earth_ys = np.array(earth_ys) / 1e9
-ast_xs = np.array(ast_xs) / 1e9
-ast_ys = np.array(ast_ys) / 1e9
+positions = sim.run(steps, dt) / 1e9
+
+earth_xs = positions[:, 1, 0]
+earth_ys = positions[:, 1, 1]
+ast_xs = positions[:, 2, 0]
+ast_ys = positions[:, 2, 1]
 
 fig, ax = plt.subplots(figsize=(8, 8))
 ax.set_facecolor("black")
@@ -34,19 +34,11 @@ dt = physics.Time(0.005)
 steps = 500
 
 
-b1, b2, b3 = [], [], []
+positions = sim.run(steps, dt)
 
-for _ in range(steps):
-    sim.step(dt)
-    o1, o2, o3 = sim.objects()
-
-    b1.append((o1.position[0].value, o1.position[1].value))
-    b2.append((o2.position[0].value, o2.position[1].value))
-    b3.append((o3.position[0].value, o3.position[1].value))
-
-b1 = np.array(b1)
-b2 = np.array(b2)
-b3 = np.array(b3)
+b1 = positions[:, 0, :2]
+b2 = positions[:, 1, :2]
+b3 = positions[:, 2, :2]
 
 fig, ax = plt.subplots(figsize=(7, 7))
 ax.set_aspect("equal")
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <string>
+
+#include <physics/parallel/thread_pool.hpp>
+#include <physics/parallel/simd.hpp>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define PHYSICS_ELEMENTWISE_X86 1
+#endif
+
+namespace physics::formulas {
+
+// Минимальный кусок массива на поток: меньшие куски не окупают передачу работы в пул
+inline constexpr std::size_t kElementwiseGrain = 16384;
+
+namespace detail {
+
+template <typename Out, typename F, typename... In>
+void ElementwiseLoop(const F& f, std::size_t begin, std::size_t end, Out* out, const In*... in) {
+  for (std::size_t i = begin; i < end; ++i) {
+    out[i] = f(in[i]...);
+  }
+}
+
+#ifdef PHYSICS_ELEMENTWISE_X86
+// Тот же цикл, собранный под более широкие регистры; f встраивается и векторизуется уже под них
+template <typename Out, typename F, typename... In>
+__attribute__((target("avx2"))) void ElementwiseLoopAvx2(const F& f, std::size_t begin, std::size_t end, Out* out, const In*... in) {
+  for (std::size_t i = begin; i < end; ++i) {
+    out[i] = f(in[i]...);
+  }
+}
+
+template <typename Out, typename F, typename... In>
+__attribute__((target("avx512f"))) void ElementwiseLoopAvx512(const F& f, std::size_t begin, std::size_t end, Out* out, const In*... in) {
+  for (std::size_t i = begin; i < end; ++i) {
+    out[i] = f(in[i]...);
+  }
+}
+#endif
+
+}  // namespace detail
+
+// out[i] = f(in[i]...) для всех i; размеры всех массивов должны совпадать
+// f - скалярная формула из той же единицы трансляции: она встраивается, и цикл векторизуется под самый широкий набор инструкций процессора
+// Если задан pool, массив делится на куски между его потоками; результат от числа потоков не зависит
+template <typename Out, typename F, typename... In>
+void Elementwise(parallel::ThreadPool* pool, F f, std::span<Out> out, std::span<const In>... in) {
+  const std::size_t n = out.size();
+  if (((in.size() != n) || ...)) {
+    throw std::invalid_argument("array sizes differ: output has " + std::to_string(n) + " elements");
+  }
+
+  const parallel::SimdIsa isa = parallel::DetectSimdIsa();
+  const auto run = [&](std::size_t begin, std::size_t end) {
+    switch (isa) {
+#ifdef PHYSICS_ELEMENTWISE_X86
+      case parallel::SimdIsa::kAvx512:
+        detail::ElementwiseLoopAvx512(f, begin, end, out.data(), in.data()...);
+        return;
+      case parallel::SimdIsa::kAvx2:
+        detail::ElementwiseLoopAvx2(f, begin, end, out.data(), in.data()...);
+        return;
+#endif
+      default:
+        detail::ElementwiseLoop(f, begin, end, out.data(), in.data()...);
+        return;
+    }
+  };
+
+  if (pool == nullptr || pool->Size() == 1 || n < 2 * kElementwiseGrain) {
+    run(0, n);
+    return;
+  }
+  pool->ParallelFor(n, kElementwiseGrain, [&](std::size_t begin, std::size_t end, std::size_t) { run(begin, end); });
+}
+
+}  // namespace physics::formulas
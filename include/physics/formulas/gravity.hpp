@@ -1,5 +1,8 @@
 #pragma once
 
+#include <span>
+
+#include <physics/parallel/thread_pool.hpp>
 #include <physics/units/quantity.hpp>
 
 namespace physics::gravity {
@@ -14,4 +17,21 @@ units::Speed EscapeVelocity(units::Weight planet, units::Length radius);
 
 units::Speed OrbitalVelocity(units::Weight planet, units::Length radius);
 
+// Те же формулы над массивами: out[i] = f(a[i], b[i], ...), размеры всех массивов должны совпадать (иначе std::invalid_argument)
+// Размерности проверяются по типам элементов; pool делит большие массивы между потоками
+void GravitationalForce(std::span<const units::Weight> m1, std::span<const units::Weight> m2, std::span<const units::Length> distance,
+                        std::span<units::Force> out, parallel::ThreadPool* pool = nullptr);
+
+void GravitationalAcceleration(std::span<const units::Weight> mass, std::span<const units::Length> radius, std::span<units::Acceleration> out,
+                               parallel::ThreadPool* pool = nullptr);
+
+void GravitationalPotentialEnergy(std::span<const units::Weight> m1, std::span<const units::Weight> m2, std::span<const units::Length> distance,
+                                  std::span<units::Energy> out, parallel::ThreadPool* pool = nullptr);
+
+void EscapeVelocity(std::span<const units::Weight> planet, std::span<const units::Length> radius, std::span<units::Speed> out,
+                    parallel::ThreadPool* pool = nullptr);
+
+void OrbitalVelocity(std::span<const units::Weight> planet, std::span<const units::Length> radius, std::span<units::Speed> out,
+                     parallel::ThreadPool* pool = nullptr);
+
 }  // namespace physics::gravity
\ No newline at end of file
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <span>
+
+#include <physics/parallel/thread_pool.hpp>
 #include <physics/units/quantity.hpp>
 
 namespace physics::mech {
@@ -28,4 +31,42 @@ units::Force ElasticForce(units::SpringConstant k, units::Length x);
 
 units::Energy ElasticPotentialEnergy(units::SpringConstant k, units::Length x);
 
+// Те же формулы над массивами: out[i] = f(a[i], b[i], ...), размеры всех массивов должны совпадать (иначе std::invalid_argument)
+// Размерности проверяются по типам элементов; pool делит большие массивы между потоками
+void KineticEnergy(std::span<const units::Weight> mass, std::span<const units::Speed> speed, std::span<units::Energy> out,
+                   parallel::ThreadPool* pool = nullptr);
+
+void PotentialEnergy(std::span<const units::Weight> mass, std::span<const units::Acceleration> g, std::span<const units::Length> height,
+                     std::span<units::Energy> out, parallel::ThreadPool* pool = nullptr);
+
+void NewtonSecondLaw(std::span<const units::Weight> mass, std::span<const units::Acceleration> accel, std::span<units::Force> out,
+                     parallel::ThreadPool* pool = nullptr);
+
+void AverageSpeed(std::span<const units::Length> distance, std::span<const units::Time> time, std::span<units::Speed> out,
+                  parallel::ThreadPool* pool = nullptr);
+
+void UniformMotion(std::span<const units::Length> initial, std::span<const units::Speed> speed, std::span<const units::Time> time,
+                   std::span<units::Length> out, parallel::ThreadPool* pool = nullptr);
+
+void AcceleratedMotion(std::span<const units::Length> initial, std::span<const units::Speed> v0, std::span<const units::Acceleration> a,
+                       std::span<const units::Time> t, std::span<units::Length> out, parallel::ThreadPool* pool = nullptr);
+
+void Momentum(std::span<const units::Weight> mass, std::span<const units::Speed> speed, std::span<units::Quantity<0, 1, 1>> out,
+              parallel::ThreadPool* pool = nullptr);
+
+void Work(std::span<const units::Force> force, std::span<const units::Length> displacement, std::span<units::Energy> out,
+          parallel::ThreadPool* pool = nullptr);
+
+void Friction(std::span<const units::Quantity<0, 0, 0>> friction_coef, std::span<const units::Force> normal_force, std::span<units::Force> out,
+              parallel::ThreadPool* pool = nullptr);
+
+void StaticFrictionMax(std::span<const units::Quantity<0, 0, 0>> static_coef, std::span<const units::Force> normal_force, std::span<units::Force> out,
+                       parallel::ThreadPool* pool = nullptr);
+
+void ElasticForce(std::span<const units::SpringConstant> k, std::span<const units::Length> x, std::span<units::Force> out,
+                  parallel::ThreadPool* pool = nullptr);
+
+void ElasticPotentialEnergy(std::span<const units::SpringConstant> k, std::span<const units::Length> x, std::span<units::Energy> out,
+                            parallel::ThreadPool* pool = nullptr);
+
 }  // namespace physics::mech
\ No newline at end of file
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <physics/simulator/simulator.hpp>
+
+namespace physics::io {
+
+// Формат контрольной точки, все числа little-endian:
+//   заголовок 64 байта: "PHYSCKPT", версия u32, флаги u32, число тел u64, число шагов u64, время f64, collision_distance f64, резерв
+//   затем массивы по n значений f64 подряд: x, y, z, vx, vy, vz, ax, ay, az, mass
+// Массивы выровнены по 8 байт от начала файла, поэтому при чтении копируются из отображения целиком
+inline constexpr std::uint32_t kCheckpointVersion = 1;
+
+// Записывает состояние тел и часы симулятора; файл пишется во временный path + ".tmp" и атомарно переименовывается,
+// поэтому падение во время записи не портит прошлую контрольную точку
+// Ошибки ввода-вывода выбрасываются как std::runtime_error
+// Формат не зависит от точности симулятора: float-симулятор пишет и читает те же массивы f64
+template <typename S>
+void SaveCheckpoint(const simulator::BasicSimulator<S>& sim, const std::string& path);
+
+// Заменяет тела, флаг гравитации, collision_distance и часы симулятора данными из файла
+// Остальные настройки (решатель, интегратор, потоки) остаются как были
+// Файл читается через mmap; неверная сигнатура, версия или размер - std::runtime_error
+template <typename S>
+void LoadCheckpoint(const std::string& path, simulator::BasicSimulator<S>& sim);
+
+}  // namespace physics::io
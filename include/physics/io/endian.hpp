@@ -0,0 +1,22 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+
+namespace physics::io {
+
+// Файлы пишутся в little-endian; на little-endian машинах преобразование ничего не делает
+template <typename T>
+T ToLittleEndian(T value) {
+  if constexpr (std::endian::native == std::endian::little) {
+    return value;
+  } else {
+    auto bytes = std::bit_cast<std::array<std::uint8_t, sizeof(T)>>(value);
+    std::reverse(bytes.begin(), bytes.end());
+    return std::bit_cast<T>(bytes);
+  }
+}
+
+}  // namespace physics::io
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace physics::io {
+
+// Закрывает дескриптор при выходе из области видимости
+class FileDescriptor {
+ public:
+  explicit FileDescriptor(int fd = -1) : fd_(fd) {
+  }
+  ~FileDescriptor();
+
+  FileDescriptor(const FileDescriptor&) = delete;
+  FileDescriptor& operator=(const FileDescriptor&) = delete;
+
+  int Get() const {
+    return fd_;
+  }
+  int Release() {
+    int fd = fd_;
+    fd_ = -1;
+    return fd;
+  }
+
+ private:
+  int fd_;
+};
+
+// Ошибка с текстом errno, std::system_error
+[[noreturn]] void ThrowErrno(const std::string& what, const std::string& path);
+
+// Пишет все байты, повторяя write после частичной записи и EINTR
+void WriteAll(int fd, const void* data, std::size_t size, const std::string& path);
+
+// Читает ровно size байт со смещения offset; false, если файл кончился раньше
+bool ReadAt(int fd, void* data, std::size_t size, std::uint64_t offset, const std::string& path);
+
+}  // namespace physics::io
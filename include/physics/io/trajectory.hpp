@@ -0,0 +1,164 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <physics/simulator/particles.hpp>
+
+namespace physics::io {
+
+// Сжатие кусков траектории
+// kZlib - байты чисел переставляются по разрядам (shuffle) и сжимаются deflate; доступно, если библиотека собрана с zlib
+enum class Compression {
+  kNone,
+  kZlib,
+};
+
+bool CompressionAvailable(Compression compression);
+
+struct TrajectoryWriterOptions {
+  // Кадр пишется после каждого record_every-го шага симулятора
+  std::size_t record_every = 1;
+  bool velocities = false;
+  // Кадров в одном куске файла, кусок - единица сжатия и чтения
+  std::size_t frames_per_chunk = 16;
+  // Буферов-кусков в кольце; когда все заняты, Record ждет фоновый поток
+  std::size_t buffers = 4;
+  Compression compression = Compression::kNone;
+  int compression_level = 1;
+};
+
+// Формат файла, все числа little-endian:
+//   заголовок 64 байта: "PHYSTRAJ", версия u32, флаги u32, число тел u64, record_every u64, кадров в куске u32, резерв
+//   куски: кадров u32, сжатие u32, размер кадров u64, размер на диске u64, затем данные
+//   кадр: шаг u64, время f64, положения 3n f64 (тело, координата), скорости 3n f64, если записывались
+// Оглавления нет: читатель проходит по заголовкам кусков, недописанный хвост после аварии отбрасывается
+inline constexpr std::uint32_t kTrajectoryVersion = 1;
+
+// Потоковая запись траектории: Record копирует кадр в заранее выделенный буфер,
+// а сжатие и запись на диск идут в фоновом потоке
+// Record вызывается из одного потока; ошибки фонового потока выбрасываются из следующего Record или Close
+class TrajectoryWriter {
+ public:
+  explicit TrajectoryWriter(const std::string& path, const TrajectoryWriterOptions& options = {});
+  ~TrajectoryWriter();
+
+  TrajectoryWriter(const TrajectoryWriter&) = delete;
+  TrajectoryWriter& operator=(const TrajectoryWriter&) = delete;
+
+  // Число тел фиксируется первым кадром; кадры float-симулятора пишутся в файл как double
+  template <typename S>
+  void Record(std::uint64_t step, double time, const simulator::BasicParticleStore<S>& particles);
+
+  // Дописывает неполный кусок, дожидается фонового потока и закрывает файл
+  void Close();
+
+  std::size_t RecordEvery() const {
+    return options_.record_every;
+  }
+  std::uint64_t FramesRecorded() const {
+    return frames_recorded_;
+  }
+
+ private:
+  static constexpr std::size_t kNoChunk = static_cast<std::size_t>(-1);
+
+  struct Chunk {
+    std::vector<char> data;
+    std::size_t frames = 0;
+  };
+
+  std::string path_;
+  TrajectoryWriterOptions options_;
+  int fd_ = -1;
+  bool started_ = false;
+  bool closed_ = false;
+  std::size_t bodies_ = 0;
+  std::size_t frame_size_ = 0;
+  std::uint64_t frames_recorded_ = 0;
+
+  std::vector<Chunk> chunks_;
+  std::size_t current_ = kNoChunk;
+  // Буфер сжатия принадлежит фоновому потоку
+  std::vector<char> packed_;
+
+  std::mutex mutex_;
+  std::condition_variable full_ready_;
+  std::condition_variable free_ready_;
+  std::deque<std::size_t> full_;
+  std::deque<std::size_t> free_;
+  bool closing_ = false;
+  std::exception_ptr error_;
+  std::thread thread_;
+
+  void Start(std::size_t bodies);
+  void Submit();
+  void ThrowIfFailed();
+  void WriterLoop();
+  void WriteChunk(const Chunk& chunk);
+};
+
+// Ленивое чтение: при открытии читаются только заголовки кусков, кусок распаковывается при первом обращении к его кадру
+class TrajectoryReader {
+ public:
+  explicit TrajectoryReader(const std::string& path);
+  ~TrajectoryReader();
+
+  TrajectoryReader(const TrajectoryReader&) = delete;
+  TrajectoryReader& operator=(const TrajectoryReader&) = delete;
+
+  std::size_t Frames() const {
+    return frames_;
+  }
+  std::size_t Bodies() const {
+    return bodies_;
+  }
+  bool HasVelocities() const {
+    return velocities_;
+  }
+  std::size_t RecordEvery() const {
+    return record_every_;
+  }
+
+  std::uint64_t Step(std::size_t frame) const;
+  double Time(std::size_t frame) const;
+
+  // 3 * Bodies() значений в порядке (тело, координата)
+  void ReadPositions(std::size_t frame, double* out) const;
+  void ReadVelocities(std::size_t frame, double* out) const;
+
+ private:
+  struct ChunkInfo {
+    std::uint64_t offset;
+    std::uint64_t stored_size;
+    std::uint64_t raw_size;
+    std::uint32_t frames;
+    std::uint32_t compression;
+    std::size_t first_frame;
+  };
+
+  std::string path_;
+  int fd_ = -1;
+  std::size_t bodies_ = 0;
+  bool velocities_ = false;
+  std::size_t record_every_ = 1;
+  std::size_t frames_ = 0;
+  std::size_t frame_size_ = 0;
+  std::vector<ChunkInfo> chunks_;
+
+  // Последний распакованный кусок
+  mutable std::size_t cached_chunk_ = static_cast<std::size_t>(-1);
+  mutable std::vector<char> cache_;
+  mutable std::vector<char> packed_;
+
+  const char* LoadFrame(std::size_t frame) const;
+};
+
+}  // namespace physics::io
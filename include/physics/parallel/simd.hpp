@@ -0,0 +1,17 @@
+#pragma once
+
+namespace physics::parallel {
+
+// Набор векторных инструкций для ядер с ручной диспетчеризацией
+// Порядок важен: каждый следующий шире предыдущего
+enum class SimdIsa {
+  kScalar,
+  kSse2,
+  kAvx2,
+  kAvx512,
+};
+
+// Самый широкий набор, который поддерживает текущий процессор; определяется один раз
+SimdIsa DetectSimdIsa();
+
+}  // namespace physics::parallel
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace physics::parallel {
+
+// Постоянный пул потоков с кражей работы
+// У каждого потока своя очередь кусков; опустошив ее, поток забирает куски с конца чужих очередей
+// Вызывающий поток тоже работает и имеет номер 0
+class ThreadPool {
+ public:
+  // fn(begin, end, thread) - обработать полуинтервал [begin, end) в потоке с номером thread
+  using RangeFn = std::function<void(std::size_t, std::size_t, std::size_t)>;
+
+  explicit ThreadPool(std::size_t threads);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // Число потоков вместе с вызывающим
+  std::size_t Size() const {
+    return queues_.size();
+  }
+
+  // Делит [0, count) на куски, кратные grain (кроме последнего), и выполняет их на всех потоках
+  // Возвращается, когда все куски выполнены; одновременные вызовы выполняются по очереди
+  // Если fn бросает исключение, оставшиеся куски пропускаются, а первое исключение пробрасывается из ParallelFor
+  // Вложенный вызов из fn на этом же пуле выполняет весь диапазон в текущем потоке с его номером
+  void ParallelFor(std::size_t count, std::size_t grain, const RangeFn& fn);
+
+ private:
+  struct Range {
+    std::size_t begin;
+    std::size_t end;
+  };
+
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Range> ranges;
+  };
+
+  std::vector<std::unique_ptr<Queue>> queues_;
+  std::vector<std::thread> workers_;
+
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  std::uint64_t generation_ = 0;
+  bool stop_ = false;
+
+  std::mutex submit_mutex_;
+  const RangeFn* job_ = nullptr;
+  std::atomic<std::size_t> pending_{0};
+  // Первое исключение из кусков текущего вызова
+  std::exception_ptr error_;
+  std::atomic<bool> failed_{false};
+
+  void WorkerLoop(std::size_t thread);
+  void RunRanges(std::size_t thread);
+  bool Pop(std::size_t thread, Range& range);
+  bool Steal(std::size_t thread, Range& range);
+};
+
+// Число потоков по умолчанию
+std::size_t HardwareThreads();
+
+}  // namespace physics::parallel
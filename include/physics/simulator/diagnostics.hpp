@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+
+namespace physics::simulator {
+
+// Сводка по всей системе после шага step: энергии, импульс, момент импульса относительно начала координат и центр масс
+// Моменты копятся в double при любом типе хранения тел
+struct Diagnostics {
+  std::uint64_t step = 0;
+  double time = 0.0;
+  double mass = 0.0;
+  double kinetic = 0.0;
+  // Гравитационная энергия 1/2 sum m_i phi_i с тем же сглаживанием и решателем, что и силы; для kParticleMesh - NaN
+  // плюс упругая энергия пружин Springs()
+  double potential = 0.0;
+  double momentum[3] = {0.0, 0.0, 0.0};
+  double angular_momentum[3] = {0.0, 0.0, 0.0};
+  double center_of_mass[3] = {0.0, 0.0, 0.0};
+
+  double Total() const {
+    return kinetic + potential;
+  }
+};
+
+}  // namespace physics::simulator
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cmath>
+
+namespace physics::simulator {
+
+// Упругое столкновение двух шаров, общее для Object, ParticleStore и FixedSimulator
+// Возвращает true, если скорости были изменены
+inline bool ResolveElastic(double pa[3], double va[3], double m_a, double pb[3], double vb[3], double m_b, double collision_distance) {
+  double delta[3] = {pb[0] - pa[0], pb[1] - pa[1], pb[2] - pa[2]};
+  const double norm = std::sqrt(delta[0] * delta[0] + delta[1] * delta[1] + delta[2] * delta[2]);
+  double dist = norm;
+
+  constexpr double kEps = 1e-9;
+  if (dist < kEps) {
+    dist = kEps;
+  }
+
+  double n[3] = {0.0, 0.0, 0.0};
+  if (norm != 0.0) {
+    for (int k = 0; k < 3; ++k) {
+      n[k] = delta[k] / norm;
+    }
+  }
+
+  double rel_vel = (vb[0] - va[0]) * n[0] + (vb[1] - va[1]) * n[1] + (vb[2] - va[2]) * n[2];
+
+  if (rel_vel >= 0.0) {
+    return false;
+  }
+
+  double inv_a = 1.0 / m_a;
+  double inv_b = 1.0 / m_b;
+
+  constexpr double kRestitution = 1.0;
+  double j = -(1.0 + kRestitution) * rel_vel / (inv_a + inv_b);
+
+  for (int k = 0; k < 3; ++k) {
+    va[k] -= j * inv_a * n[k];
+    vb[k] += j * inv_b * n[k];
+  }
+
+  double overlap = collision_distance - dist;
+  if (overlap > 0.0) {
+    double total_mass = m_a + m_b;
+    double share_a = m_b / total_mass;
+    double share_b = m_a / total_mass;
+
+    for (int k = 0; k < 3; ++k) {
+      pa[k] -= share_a * overlap * n[k];
+      pb[k] += share_b * overlap * n[k];
+    }
+  }
+
+  return true;
+}
+
+}  // namespace physics::simulator
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <physics/object/object.hpp>
+#include <physics/parallel/thread_pool.hpp>
+#include <physics/simulator/gravity_kernel.hpp>
+#include <physics/simulator/simulator.hpp>
+#include <physics/units/quantity.hpp>
+
+namespace physics::simulator {
+
+// Ансамбль из M независимых копий одной системы из n тел, которые шагают синхронно
+// Компоненты хранятся по телам, а внутри тела - по копиям: одна копия - одна линия SIMD-регистра
+// Правила шага те же, что у Simulator::Step с KernelIsa::kScalar и дискретными столкновениями в порядке ContactOrder::kSequential, каждая копия
+// совпадает бит в бит с отдельным Simulator; блочных шагов, деревьев, сетки и непрерывных столкновений нет
+class Ensemble {
+ public:
+  // Все копии начинаются с одинаковых тел objects, разброс задается через Set* или SetPositions/SetVelocities/SetMasses
+  Ensemble(std::size_t replicas, const std::vector<object::Object>& objects, units::Length collision_distance);
+
+  std::size_t Replicas() const {
+    return replicas_;
+  }
+  std::size_t Bodies() const {
+    return bodies_;
+  }
+
+  void Set(std::size_t replica, std::size_t body, const object::Object& obj);
+  object::Object Get(std::size_t replica, std::size_t body) const;
+
+  // Плотные массивы в порядке (копия, тело, координата), как NumPy-массивы формы (M, n, 3) и (M, n)
+  void SetPositions(const double* data);
+  void SetVelocities(const double* data);
+  void SetMasses(const double* data);
+  void GetPositions(double* out) const;
+  void GetVelocities(double* out) const;
+  void GetMasses(double* out) const;
+
+  // Число разрешенных столкновений в каждой копии с начала расчета
+  const std::vector<std::uint64_t>& CollisionCounts() const {
+    return collision_counts_;
+  }
+
+  void SetCollisionDistance(units::Length distance) {
+    collision_distance_ = distance;
+  }
+  units::Length CollisionDistance() const {
+    return collision_distance_;
+  }
+
+  void EnableGravity(bool enabled) {
+    use_gravity_ = enabled;
+    accelerations_valid_ = false;
+  }
+  bool GravityEnabled() const {
+    return use_gravity_;
+  }
+
+  void SetSoftening(units::Length softening) {
+    softening_ = softening;
+    accelerations_valid_ = false;
+  }
+  units::Length Softening() const {
+    return softening_;
+  }
+
+  void SetIntegrator(Integrator integrator) {
+    integrator_ = integrator;
+    accelerations_valid_ = false;
+  }
+  Integrator GetIntegrator() const {
+    return integrator_;
+  }
+
+  // Ширина пачки копий: kScalar - по одной, kSse2 - 2, kAvx2 - 4, kAvx512 - 8
+  void SetKernelIsa(KernelIsa isa);
+  KernelIsa GetKernelIsa() const {
+    return kernel_isa_;
+  }
+
+  // Число потоков, 0 - по числу ядер; потоки делят между собой пачки копий
+  void SetThreads(std::size_t threads);
+  std::size_t Threads() const {
+    return pool_ ? pool_->Size() : 1;
+  }
+
+  void Step(units::Time dt);
+  void Run(std::size_t steps, units::Time dt);
+
+  std::uint64_t StepCount() const {
+    return step_count_;
+  }
+  units::Time ElapsedTime() const {
+    return elapsed_time_;
+  }
+
+ private:
+  // Число копий округляется вверх до ширины AVX-512, лишние линии заполнены нулевыми телами и не влияют на остальные
+  static constexpr std::size_t kLaneAlign = 8;
+
+  std::size_t replicas_;
+  std::size_t bodies_;
+  std::size_t stride_;
+
+  // Элемент (тело i, копия r) лежит по индексу i * stride_ + r
+  std::vector<double> x_;
+  std::vector<double> y_;
+  std::vector<double> z_;
+  std::vector<double> vx_;
+  std::vector<double> vy_;
+  std::vector<double> vz_;
+  std::vector<double> ax_;
+  std::vector<double> ay_;
+  std::vector<double> az_;
+  std::vector<double> mass_;
+  std::vector<std::uint64_t> collision_counts_;
+
+  bool use_gravity_ = true;
+  units::Length collision_distance_{0.0};
+  units::Length softening_{0.0};
+  Integrator integrator_ = Integrator::kSemiImplicitEuler;
+  KernelIsa kernel_isa_ = DetectKernelIsa();
+  // Настройки и состояние не менялись с прошлого шага; тогда Верле берет ускорения пачек, где не было ударов
+  bool accelerations_valid_ = false;
+  std::vector<std::uint8_t> block_valid_;
+  std::uint64_t step_count_ = 0;
+  units::Time elapsed_time_{0.0};
+
+  std::shared_ptr<parallel::ThreadPool> pool_;
+  // Начальное состояние и наклоны для Рунге-Кутты, по 6 массивов
+  std::vector<double> rk_state_;
+  std::vector<double> rk_sum_;
+
+  std::size_t Index(std::size_t replica, std::size_t body) const {
+    return body * stride_ + replica;
+  }
+
+  // Шаг одной пачки из kLaneAlign копий; пачки независимы и делятся между потоками
+  void StepBlock(double h, std::size_t block);
+  void ComputeAccelerations(std::size_t begin, std::size_t end);
+  void Kick(double h, std::size_t begin, std::size_t end);
+  void Drift(double h, std::size_t begin, std::size_t end);
+  void StepRungeKutta4(double h, std::size_t begin, std::size_t end);
+  bool HandleCollisions(std::size_t begin, std::size_t end);
+};
+
+}  // namespace physics::simulator
@@ -0,0 +1,333 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include <physics/constants.hpp>
+#include <physics/object/object.hpp>
+#include <physics/simulator/elastic.hpp>
+#include <physics/simulator/simulator.hpp>
+#include <physics/units/quantity.hpp>
+#include <physics/vector/vector.hpp>
+
+namespace physics::simulator {
+
+// Вызывает f(std::integral_constant<std::size_t, I>{}) для I = 0 .. N - 1; цикл разворачивается при компиляции
+template <std::size_t N, typename F>
+constexpr void Unroll(F&& f) {
+  [&]<std::size_t... I>(std::index_sequence<I...>) { (f(std::integral_constant<std::size_t, I>{}), ...); }(std::make_index_sequence<N>{});
+}
+
+// Все пары i < j в порядке вложенного цикла, индексы - константы времени компиляции
+template <std::size_t N, typename F>
+constexpr void UnrollPairs(F&& f) {
+  Unroll<N>([&](auto i) {
+    constexpr std::size_t kI = decltype(i)::value;
+    Unroll<N - kI - 1>([&](auto k) { f(i, std::integral_constant<std::size_t, kI + 1 + decltype(k)::value>{}); });
+  });
+}
+
+// Симулятор для небольшого числа тел N, известного при компиляции: планета со спутником, три шара и т.п.
+// Состояние лежит внутри объекта без выделений памяти, циклы по телам и парам развернуты
+// Step повторяет Simulator::Step с KernelIsa::kScalar и дискретными столкновениями в порядке ContactOrder::kSequential:
+// при тех же настройках результат совпадает бит в бит
+// Блочных шагов, непрерывных столкновений, решателей кроме прямой суммы, статистики и записи траектории здесь нет
+template <std::size_t N>
+class FixedSimulator {
+  static_assert(N > 0, "FixedSimulator needs at least one body");
+
+ public:
+  // Компонента по всем телам, как массивы ParticleStore
+  using Components = vector::Vector<double, N>;
+
+  FixedSimulator() = default;
+
+  explicit FixedSimulator(units::Length collision_distance) : collision_distance_(collision_distance) {
+  }
+
+  FixedSimulator(const std::array<object::Object, N>& objects, units::Length collision_distance) : collision_distance_(collision_distance) {
+    for (std::size_t i = 0; i < N; ++i) {
+      Set(i, objects[i]);
+    }
+  }
+
+  static constexpr std::size_t Size() {
+    return N;
+  }
+
+  void Set(std::size_t i, const object::Object& obj) {
+    mass_[i] = obj.weight.value;
+    for (std::size_t k = 0; k < 3; ++k) {
+      pos_[k][i] = obj.position[k].value;
+      vel_[k][i] = obj.speed[k].value;
+      acc_[k][i] = obj.acceleration[k].value;
+    }
+    accelerations_valid_ = false;
+  }
+
+  object::Object Get(std::size_t i) const {
+    object::Object obj(units::Weight{mass_[i]}, Position(i), Velocity(i));
+    obj.acceleration = {units::Acceleration{acc_[0][i]}, units::Acceleration{acc_[1][i]}, units::Acceleration{acc_[2][i]}};
+    return obj;
+  }
+
+  std::array<object::Object, N> Objects() const {
+    std::array<object::Object, N> objects;
+    for (std::size_t i = 0; i < N; ++i) {
+      objects[i] = Get(i);
+    }
+    return objects;
+  }
+
+  vector::Vector<units::Length, 3> Position(std::size_t i) const {
+    return {units::Length{pos_[0][i]}, units::Length{pos_[1][i]}, units::Length{pos_[2][i]}};
+  }
+  vector::Vector<units::Speed, 3> Velocity(std::size_t i) const {
+    return {units::Speed{vel_[0][i]}, units::Speed{vel_[1][i]}, units::Speed{vel_[2][i]}};
+  }
+
+  // Координата k (0 - x, 1 - y, 2 - z) всех тел
+  const Components& Positions(std::size_t k) const {
+    return pos_[k];
+  }
+  const Components& Velocities(std::size_t k) const {
+    return vel_[k];
+  }
+  const Components& Masses() const {
+    return mass_;
+  }
+
+  void SetCollisionDistance(units::Length distance) {
+    collision_distance_ = distance;
+  }
+  units::Length CollisionDistance() const {
+    return collision_distance_;
+  }
+
+  void EnableGravity(bool enabled) {
+    use_gravity_ = enabled;
+    accelerations_valid_ = false;
+  }
+  bool GravityEnabled() const {
+    return use_gravity_;
+  }
+
+  void SetSoftening(units::Length softening) {
+    softening_ = softening;
+    accelerations_valid_ = false;
+  }
+  units::Length Softening() const {
+    return softening_;
+  }
+
+  void SetIntegrator(Integrator integrator) {
+    integrator_ = integrator;
+    accelerations_valid_ = false;
+  }
+  Integrator GetIntegrator() const {
+    return integrator_;
+  }
+
+  std::uint64_t StepCount() const {
+    return step_count_;
+  }
+  units::Time ElapsedTime() const {
+    return elapsed_time_;
+  }
+  void SetClock(std::uint64_t step_count, units::Time elapsed_time) {
+    step_count_ = step_count;
+    elapsed_time_ = elapsed_time;
+  }
+
+  void HandleCollisions() {
+    const double distance = collision_distance_.value;
+    const double dist2 = distance * distance;
+    bool changed = false;
+
+    UnrollPairs<N>([&](auto i, auto j) {
+      const double dx = pos_[0][j] - pos_[0][i];
+      const double dy = pos_[1][j] - pos_[1][i];
+      const double dz = pos_[2][j] - pos_[2][i];
+      if (dx * dx + dy * dy + dz * dz <= dist2) {
+        changed = ResolveCollision(i, j) || changed;
+      }
+    });
+
+    if (changed) {
+      accelerations_valid_ = false;
+    }
+  }
+
+  void Step(units::Time dt) {
+    const double h = dt.value;
+
+    switch (integrator_) {
+      case Integrator::kSemiImplicitEuler:
+        ComputeAccelerations();
+        Unroll<3>([&](auto k) {
+          Unroll<N>([&](auto i) {
+            vel_[k][i] += acc_[k][i] * h;
+            pos_[k][i] += vel_[k][i] * h;
+          });
+        });
+        break;
+
+      case Integrator::kVelocityVerlet:
+        if (!accelerations_valid_) {
+          ComputeAccelerations();
+        }
+        Kick(0.5 * h);
+        Drift(h);
+        ComputeAccelerations();
+        Kick(0.5 * h);
+        break;
+
+      case Integrator::kLeapfrog:
+        Drift(0.5 * h);
+        ComputeAccelerations();
+        Kick(h);
+        Drift(0.5 * h);
+        break;
+
+      case Integrator::kYoshida4: {
+        static const double kW1 = 1.0 / (2.0 - std::cbrt(2.0));
+        static const double kW0 = -std::cbrt(2.0) * kW1;
+        const double drift[4] = {0.5 * kW1, 0.5 * (kW0 + kW1), 0.5 * (kW0 + kW1), 0.5 * kW1};
+        const double kick[3] = {kW1, kW0, kW1};
+
+        for (std::size_t k = 0; k < 3; ++k) {
+          Drift(drift[k] * h);
+          ComputeAccelerations();
+          Kick(kick[k] * h);
+        }
+        Drift(drift[3] * h);
+        break;
+      }
+
+      case Integrator::kRungeKutta4:
+        StepRungeKutta4(h);
+        break;
+    }
+
+    accelerations_valid_ = integrator_ == Integrator::kVelocityVerlet;
+    HandleCollisions();
+
+    ++step_count_;
+    elapsed_time_ = elapsed_time_ + dt;
+  }
+
+ private:
+  std::array<Components, 3> pos_{};
+  std::array<Components, 3> vel_{};
+  std::array<Components, 3> acc_{};
+  Components mass_{};
+
+  bool use_gravity_ = true;
+  units::Length collision_distance_{0.0};
+  units::Length softening_{0.0};
+  Integrator integrator_ = Integrator::kSemiImplicitEuler;
+  bool accelerations_valid_ = false;
+  std::uint64_t step_count_ = 0;
+  units::Time elapsed_time_{0.0};
+
+  // Попарная сумма с третьим законом Ньютона, порядок операций как в Simulator::ApplyGravityPairwise
+  void ComputeAccelerations() {
+    acc_ = {};
+    if (!use_gravity_) {
+      return;
+    }
+
+    const double g = constants::kG.value;
+    const double eps2 = softening_.value * softening_.value;
+
+    Unroll<N>([&](auto i) {
+      const double gmi = g * mass_[i];
+      double acc_i[3] = {0.0, 0.0, 0.0};
+
+      Unroll<N - decltype(i)::value - 1>([&](auto k) {
+        constexpr std::size_t kJ = decltype(i)::value + 1 + decltype(k)::value;
+        const double d[3] = {pos_[0][kJ] - pos_[0][i], pos_[1][kJ] - pos_[1][i], pos_[2][kJ] - pos_[2][i]};
+        const double r2 = d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+        if (r2 == 0.0) {
+          return;
+        }
+
+        const double d2 = r2 + eps2;
+        const double inv_r3 = 1.0 / (d2 * std::sqrt(d2));
+        const double si = g * mass_[kJ] * inv_r3;
+        const double sj = gmi * inv_r3;
+        for (std::size_t c = 0; c < 3; ++c) {
+          acc_i[c] += si * d[c];
+          acc_[c][kJ] -= sj * d[c];
+        }
+      });
+
+      for (std::size_t c = 0; c < 3; ++c) {
+        acc_[c][i] += acc_i[c];
+      }
+    });
+  }
+
+  void Kick(double h) {
+    Unroll<3>([&](auto k) { Unroll<N>([&](auto i) { vel_[k][i] += acc_[k][i] * h; }); });
+  }
+
+  void Drift(double h) {
+    Unroll<3>([&](auto k) { Unroll<N>([&](auto i) { pos_[k][i] += vel_[k][i] * h; }); });
+  }
+
+  void StepRungeKutta4(double h) {
+    const auto pos0 = pos_;
+    const auto vel0 = vel_;
+    std::array<Components, 3> sum_pos{};
+    std::array<Components, 3> sum_vel{};
+
+    constexpr double kWeight[4] = {1.0, 2.0, 2.0, 1.0};
+    constexpr double kNext[3] = {0.5, 0.5, 1.0};
+
+    for (std::size_t stage = 0; stage < 4; ++stage) {
+      ComputeAccelerations();
+
+      Unroll<3>([&](auto c) {
+        Unroll<N>([&](auto i) {
+          sum_pos[c][i] += kWeight[stage] * vel_[c][i];
+          sum_vel[c][i] += kWeight[stage] * acc_[c][i];
+
+          if (stage < 3) {
+            const double t = kNext[stage] * h;
+            pos_[c][i] = pos0[c][i] + t * vel_[c][i];
+            vel_[c][i] = vel0[c][i] + t * acc_[c][i];
+          } else {
+            pos_[c][i] = pos0[c][i] + h / 6.0 * sum_pos[c][i];
+            vel_[c][i] = vel0[c][i] + h / 6.0 * sum_vel[c][i];
+          }
+        });
+      });
+    }
+  }
+
+  bool ResolveCollision(std::size_t i, std::size_t j) {
+    double pa[3] = {pos_[0][i], pos_[1][i], pos_[2][i]};
+    double va[3] = {vel_[0][i], vel_[1][i], vel_[2][i]};
+    double pb[3] = {pos_[0][j], pos_[1][j], pos_[2][j]};
+    double vb[3] = {vel_[0][j], vel_[1][j], vel_[2][j]};
+
+    if (!ResolveElastic(pa, va, mass_[i], pb, vb, mass_[j], collision_distance_.value)) {
+      return false;
+    }
+
+    for (std::size_t k = 0; k < 3; ++k) {
+      pos_[k][i] = pa[k];
+      vel_[k][i] = va[k];
+      pos_[k][j] = pb[k];
+      vel_[k][j] = vb[k];
+    }
+    return true;
+  }
+};
+
+}  // namespace physics::simulator
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+
+#include <physics/parallel/simd.hpp>
+
+namespace physics::simulator {
+
+// Набор инструкций для ядра прямого суммирования гравитации
+using KernelIsa = parallel::SimdIsa;
+
+// Самый широкий набор, который поддерживает текущий процессор
+KernelIsa DetectKernelIsa();
+
+// Тела, на которые действует сила
+template <typename S>
+struct BasicGravityTargets {
+  const S* x;
+  const S* y;
+  const S* z;
+  S* ax;
+  S* ay;
+  S* az;
+  std::size_t count;
+  // Если задан, к нему прибавляется потенциал phi_i = -G * sum m_j / sqrt(|d|^2 + eps^2) (для диагностики энергии)
+  S* potential = nullptr;
+};
+
+// Тела, которые создают поле
+template <typename S>
+struct BasicGravitySources {
+  const S* x;
+  const S* y;
+  const S* z;
+  const S* mass;
+  std::size_t count;
+};
+
+using GravityTargets = BasicGravityTargets<double>;
+using GravitySources = BasicGravitySources<double>;
+
+// Прибавляет к ускорениям целей a += G * m_j * d / (|d|^2 + eps^2)^(3/2) по всем источникам
+// Цели обрабатываются пачками по 2/4/8 (float - по 4/8/16) в зависимости от isa, пары с нулевым расстоянием пропускаются
+// softening - длина сглаживания Пламмера eps, при 0 получаем обычный закон Ньютона
+// double_accumulators - для float сумма по источникам копится в double, разности и 1/r^3 остаются во float;
+// для double не влияет
+void AccumulateGravity(KernelIsa isa, const GravitySources& sources, const GravityTargets& targets, double softening, bool double_accumulators = false);
+void AccumulateGravity(KernelIsa isa, const BasicGravitySources<float>& sources, const BasicGravityTargets<float>& targets, double softening,
+                       bool double_accumulators = false);
+
+}  // namespace physics::simulator
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <physics/parallel/thread_pool.hpp>
+#include <physics/simulator/particles.hpp>
+#include <physics/simulator/spatial_hash.hpp>
+
+namespace physics::simulator {
+
+// Списки соседей Верле: все пары ближе radius + skin, найденные хеш-сеткой
+// Пока ни одно тело не сдвинулось больше чем на skin / 2 от положения при перестройке, любая пара ближе radius
+// остается в списке, поэтому перестройка нужна только после такого сдвига, а не на каждом шаге
+class NeighborList {
+ public:
+  using Pair = SpatialHash::Pair;
+
+  // Готовит список для текущих положений и возвращает true, если он был перестроен
+  // Смена числа тел, radius или skin тоже вызывает перестройку
+  template <typename S>
+  bool Update(const BasicParticleStore<S>& particles, double radius, double skin, parallel::ThreadPool* pool = nullptr);
+
+  // Пары (i < j), отсортированные по (i, j), как в полном переборе
+  const std::vector<Pair>& Pairs() const {
+    return pairs_;
+  }
+
+  // Соседи тела i по возрастанию номера лежат в Neighbors() с Start(i) до Start(i + 1)
+  std::size_t Start(std::size_t i) const {
+    return start_[i];
+  }
+  const std::vector<std::uint32_t>& Neighbors() const {
+    return neighbors_;
+  }
+
+  // Число перестроек с создания
+  std::uint64_t Rebuilds() const {
+    return rebuilds_;
+  }
+
+ private:
+  SpatialHash hash_;
+  std::vector<Pair> pairs_;
+  std::vector<std::size_t> start_;
+  std::vector<std::uint32_t> neighbors_;
+  // Положения тел при последней перестройке, по n значений x, y, z
+  std::vector<double> reference_;
+  std::size_t bodies_ = 0;
+  double radius_ = -1.0;
+  double skin_ = -1.0;
+  std::uint64_t rebuilds_ = 0;
+
+  template <typename S>
+  bool Moved(const BasicParticleStore<S>& particles) const;
+  template <typename S>
+  void Rebuild(const BasicParticleStore<S>& particles, parallel::ThreadPool* pool);
+};
+
+}  // namespace physics::simulator
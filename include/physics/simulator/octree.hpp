@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <physics/simulator/particles.hpp>
+#include <physics/units/quantity.hpp>
+#include <physics/vector/vector.hpp>
+
+namespace physics::simulator {
+
+// Октодерево для приближенного расчета гравитации методом Барнса-Хата
+// Перестраивается на каждом шаге, узлы хранятся плоским массивом
+class Octree {
+ public:
+  template <typename S>
+  void Build(const BasicParticleStore<S>& particles);
+
+  // Ускорение тела index от всех остальных тел
+  // theta - угол раскрытия, при theta = 0 получаем точную попарную сумму
+  // softening - длина сглаживания Пламмера
+  // Если задан potential, к нему прибавляется потенциал в точке тела -G * sum m / sqrt(r^2 + eps^2) по тем же узлам
+  template <typename S>
+  vector::Vector<units::Acceleration, 3> AccelerationOn(std::size_t index, const BasicParticleStore<S>& particles, double theta,
+                                                        double softening = 0.0, double* potential = nullptr) const;
+
+  std::size_t NodeCount() const {
+    return nodes_.size();
+  }
+
+ private:
+  static constexpr std::size_t kLeafSize = 8;
+  static constexpr int kMaxDepth = 48;
+
+  struct Node {
+    double center[3];
+    double half;
+    double mass;
+    double com[3];
+    std::uint32_t begin;
+    std::uint32_t end;
+    std::int32_t first_child;
+    std::int32_t child_count;
+  };
+
+  std::vector<Node> nodes_;
+  std::vector<std::uint32_t> order_;
+  std::vector<std::uint32_t> scratch_;
+
+  template <typename S>
+  void BuildNode(std::size_t node, const BasicParticleStore<S>& particles, int depth);
+};
+
+}  // namespace physics::simulator
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <physics/parallel/thread_pool.hpp>
+#include <physics/simulator/particles.hpp>
+
+namespace physics::simulator {
+
+// Схема раздачи массы на сетку и сбора сил обратно
+// kCic - облако в ячейке, 8 узлов; kTsc - треугольное облако, 27 узлов, глаже и дороже
+enum class MeshAssignment {
+  kCic,
+  kTsc,
+};
+
+// kPeriodic - периодическая коробка [0, box_size)^3
+// kIsolated - открытое пространство: коробка строится по телам, сетка дополняется нулями вдвое (метод Хокни-Иствуда)
+enum class MeshBoundary {
+  kPeriodic,
+  kIsolated,
+};
+
+struct MeshOptions {
+  // Узлов сетки на сторону, степень двойки; для kIsolated свертка идет на сетке вдвое больше
+  std::size_t grid = 64;
+  MeshAssignment assignment = MeshAssignment::kCic;
+  MeshBoundary boundary = MeshBoundary::kIsolated;
+  double box_size = 1.0;
+  // P3M: сетка считает только дальнодействие с гауссовым срезом r_s = split * шаг сетки,
+  // ближние пары до cutoff * r_s досчитываются прямой суммой с множителем erfc
+  bool short_range = false;
+  double split = 1.25;
+  double cutoff = 4.5;
+};
+
+// Гравитация методом частица-сетка: масса раздается на сетку, уравнение Пуассона решается через БПФ,
+// ускорения интерполируются обратно в тела той же схемой, что и при раздаче
+class ParticleMesh {
+ public:
+  // Прибавляет ускорения всех тел к ax, ay, az (массивы по particles.Size())
+  // softening - сглаживание Пламмера для ближней прямой суммы, на сетке сглаживает сама схема раздачи
+  template <typename S>
+  void AddAccelerations(const BasicParticleStore<S>& particles, const MeshOptions& options, double softening, S* ax, S* ay, S* az,
+                        parallel::ThreadPool* pool = nullptr);
+
+ private:
+  using Complex = std::complex<double>;
+
+  // Геометрия текущего вызова: узел (i, j, k) сетки лежит в точке origin + h * (i, j, k)
+  struct Grid {
+    std::size_t n = 0;
+    std::size_t size = 0;
+    double origin[3] = {0.0, 0.0, 0.0};
+    double h = 1.0;
+    bool periodic = false;
+  };
+
+  Grid grid_;
+  std::vector<Complex> density_;
+  std::vector<Complex> work_;
+  std::vector<Complex> twiddles_;
+
+  // Фурье-образы ядра (Kx + i Ky) и Kz для изолированных границ в единицах шага сетки
+  // Ядро не зависит от шага, поэтому пересчитывается только при смене размера сетки или параметров P3M
+  std::vector<Complex> kernel_xy_;
+  std::vector<Complex> kernel_z_;
+  std::size_t kernel_size_ = 0;
+  bool kernel_short_range_ = false;
+  double kernel_split_ = 0.0;
+
+  // Ячейки для ближней суммы
+  std::vector<std::uint32_t> cell_start_;
+  std::vector<std::uint32_t> cell_entries_;
+  std::vector<std::uint32_t> cell_of_;
+
+  void Fft3d(std::vector<Complex>& data, bool inverse, parallel::ThreadPool* pool);
+  template <typename S>
+  void Deposit(const BasicParticleStore<S>& particles, MeshAssignment assignment, double scale);
+  template <typename S>
+  void Gather(const BasicParticleStore<S>& particles, MeshAssignment assignment, const std::vector<Complex>& field, double scale, S* first, S* second,
+              parallel::ThreadPool* pool) const;
+  void SolvePeriodic(const MeshOptions& options, parallel::ThreadPool* pool);
+  void SolveIsolated(const MeshOptions& options, parallel::ThreadPool* pool);
+  void BuildKernel(const MeshOptions& options, parallel::ThreadPool* pool);
+  template <typename S>
+  void AddShortRange(const BasicParticleStore<S>& particles, const MeshOptions& options, double softening, S* ax, S* ay, S* az,
+                     parallel::ThreadPool* pool);
+};
+
+}  // namespace physics::simulator
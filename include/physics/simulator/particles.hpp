@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <physics/object/object.hpp>
+
+namespace physics::simulator {
+
+// Хранилище тел в виде структуры массивов (SoA)
+// Каждая компонента лежит в своем непрерывном массиве, по которым бегут все горячие циклы симулятора
+// S - тип чисел: double или float; Object всегда в double, при переносе значения приводятся
+template <typename S>
+class BasicParticleStore {
+ public:
+  using Scalar = S;
+
+  std::vector<S> x, y, z;
+  std::vector<S> vx, vy, vz;
+  std::vector<S> ax, ay, az;
+  std::vector<S> mass;
+
+  std::size_t Size() const {
+    return mass.size();
+  }
+
+  void Clear();
+  void Reserve(std::size_t n);
+  void Resize(std::size_t n);
+
+  void PushBack(const object::Object& obj);
+  object::Object Get(std::size_t i) const;
+  void Set(std::size_t i, const object::Object& obj);
+
+  // Перенос из массива объектов и обратно
+  void Assign(const std::vector<object::Object>& objects);
+  void Store(std::vector<object::Object>& objects) const;
+};
+
+using ParticleStore = BasicParticleStore<double>;
+using ParticleStore32 = BasicParticleStore<float>;
+
+extern template class BasicParticleStore<double>;
+extern template class BasicParticleStore<float>;
+
+}  // namespace physics::simulator
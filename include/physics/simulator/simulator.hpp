@@ -1,53 +1,585 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <tuple>
 #include <vector>
 
+#include <physics/io/trajectory.hpp>
 #include <physics/object/object.hpp>
+#include <physics/parallel/thread_pool.hpp>
+#include <physics/simulator/diagnostics.hpp>
+#include <physics/simulator/gravity_kernel.hpp>
+#include <physics/simulator/neighbor_list.hpp>
+#include <physics/simulator/octree.hpp>
+#include <physics/simulator/particle_mesh.hpp>
+#include <physics/simulator/particles.hpp>
+#include <physics/simulator/spatial_hash.hpp>
+#include <physics/simulator/spring_network.hpp>
+#include <physics/simulator/stats.hpp>
+#include <physics/simulator/sweep_and_prune.hpp>
 #include <physics/units/quantity.hpp>
 
 namespace physics::simulator {
 
-class Simulator {
+// Способ расчета гравитации
+// kDirect - точная попарная сумма O(n^2), kBarnesHut - октодерево O(n log n)
+// kParticleMesh - поле на сетке через БПФ, O(n + G^3 log G), настраивается через SetMeshOptions
+// kCutoff - короткодействующий вариант: прямая сумма только по парам ближе SetCutoff, пары берутся из списков соседей Верле
+enum class GravitySolver {
+  kDirect,
+  kBarnesHut,
+  kParticleMesh,
+  kCutoff,
+};
+
+// Широкая фаза поиска столкновений
+// kBruteForce - перебор всех пар по текущим положениям: удар, расталкивающий тела, сразу находит и новый контакт с третьим телом
+// kSpatialHash - хеш-сетка с ячейкой collision_distance; пары собираются до ударов, поэтому такие новые контакты ждут следующего шага
+// kSweepAndPrune - отсортированные концы по трем осям, досортировываются между шагами; выгоден, когда тела почти не двигаются
+// kNeighborList - списки соседей Верле, общие с GravitySolver::kCutoff; перестраиваются после сдвига тела на половину SetSkin
+enum class BroadPhase {
+  kBruteForce,
+  kSpatialHash,
+  kSweepAndPrune,
+  kNeighborList,
+};
+
+// Схема интегрирования шага
+// kSemiImplicitEuler - полунеявный Эйлер, как в Object::Update, 1-й порядок
+// kVelocityVerlet - скоростной Верле (kick-drift-kick), 2-й порядок, одно вычисление сил за шаг
+// kLeapfrog - чехарда drift-kick-drift, 2-й порядок, одно вычисление сил за шаг
+// kYoshida4 - симплектическая схема Йошиды 4-го порядка, три вычисления сил за шаг
+// kRungeKutta4 - классический Рунге-Кутта 4-го порядка, четыре вычисления сил, не симплектический
+enum class Integrator {
+  kSemiImplicitEuler,
+  kVelocityVerlet,
+  kLeapfrog,
+  kYoshida4,
+  kRungeKutta4,
+};
+
+// Обработка столкновений
+// kDiscrete - проверка перекрытий после шага, быстрые тела могут пролететь друг сквозь друга
+// kContinuous - заметание сфер: за шаг тело движется по отрезку, удар обрабатывается в момент касания, не больше одного на тело за шаг
+// kEventDriven - событийная динамика твердых шаров: силы дают один толчок в начале шага, дальше тела летят по прямым,
+// и все удары внутри шага обрабатываются точно по времени
+enum class CollisionMode {
+  kDiscrete,
+  kContinuous,
+  kEventDriven,
+};
+
+// Порядок ударов в дискретной проверке HandleCollisions
+// kSequential (по умолчанию) - пары по очереди в порядке (i, j): каждый удар видит результат предыдущих, только в одном потоке
+// kColored - граф контактов раскрашивается так, что в одном цвете тело встречается не больше раза; цвета решаются по очереди,
+// удары внутри цвета - параллельно; результат не зависит от числа потоков, но отличается от kSequential: граф строится
+// до ударов, и цепочки контактов, возникшие в ходе проверки, ждут следующей
+enum class ContactOrder {
+  kSequential,
+  kColored,
+};
+
+// Записанная траектория, массивы в порядке (кадр, тело, координата)
+struct Trajectory {
+  std::size_t frames = 0;
+  std::size_t bodies = 0;
+  std::vector<double> positions;
+  // Пусто, если скорости не записывались
+  std::vector<double> velocities;
+};
+
+// S - тип хранения координат, скоростей, масс и ускорений тел: double или float
+// Настройки, время и Objects() остаются в double; float вдвое сокращает память и трафик и удваивает ширину SIMD
+template <typename S>
+class BasicSimulator {
  public:
-  Simulator() = default;
+  using Scalar = S;
+  using Store = BasicParticleStore<S>;
 
-  explicit Simulator(units::Length collision_distance) : collision_distance_(collision_distance) {
+  BasicSimulator() = default;
+
+  explicit BasicSimulator(units::Length collision_distance) : collision_distance_(collision_distance) {
   }
 
-  Simulator(std::vector<object::Object> objects, units::Length collision_distance)
-      : objects_(std::move(objects)), collision_distance_(collision_distance) {
+  BasicSimulator(std::vector<object::Object> objects, units::Length collision_distance)
+      : objects_(std::move(objects)), storage_(Storage::kObjects), collision_distance_(collision_distance) {
+  }
+
+  void SetCollisionDistance(units::Length distance) {
+    collision_distance_ = distance;
+  }
+  units::Length CollisionDistance() const {
+    return collision_distance_;
   }
 
   void EnableGravity(bool enabled) {
     use_gravity_ = enabled;
+    InvalidateAccelerations();
   }
   bool GravityEnabled() const {
     return use_gravity_;
   }
 
-  std::vector<object::Object>& Objects() {
-    return objects_;
+  void SetGravitySolver(GravitySolver solver) {
+    gravity_solver_ = solver;
+    InvalidateAccelerations();
+  }
+  GravitySolver GetGravitySolver() const {
+    return gravity_solver_;
+  }
+
+  // Угол раскрытия для Барнса-Хата, обычно 0.3 - 0.8
+  void SetTheta(double theta) {
+    theta_ = theta;
+    InvalidateAccelerations();
+  }
+  double Theta() const {
+    return theta_;
+  }
+
+  // Сетка, граничные условия и ближняя поправка P3M для kParticleMesh
+  void SetMeshOptions(const MeshOptions& options) {
+    mesh_options_ = options;
+    InvalidateAccelerations();
+  }
+  const MeshOptions& GetMeshOptions() const {
+    return mesh_options_;
+  }
+
+  // Радиус действия сил для kCutoff: пары дальше cutoff не притягиваются
+  void SetCutoff(units::Length cutoff) {
+    cutoff_ = cutoff;
+    InvalidateAccelerations();
+  }
+  units::Length Cutoff() const {
+    return cutoff_;
+  }
+
+  // Запас списков соседей: в списки попадают пары ближе радиус + skin, и они живут, пока тела не сдвинутся на skin / 2
+  // Больший запас - реже перестройка, но длиннее списки; 0 - перестройка на каждом шаге
+  void SetSkin(units::Length skin) {
+    skin_ = skin;
+  }
+  units::Length Skin() const {
+    return skin_;
+  }
+
+  // Число перестроек списков соседей с создания симулятора
+  std::uint64_t NeighborListRebuilds() const {
+    return neighbor_list_.Rebuilds();
+  }
+
+  // Сглаживание Пламмера: |r|^2 заменяется на |r|^2 + eps^2, убирает сингулярность при сближении
+  void SetSoftening(units::Length softening) {
+    softening_ = softening;
+    InvalidateAccelerations();
+  }
+  units::Length Softening() const {
+    return softening_;
+  }
+
+  // Ядро прямого суммирования, по умолчанию выбирается по процессору
+  // kScalar использует третий закон Ньютона и считает каждую пару один раз
+  void SetKernelIsa(KernelIsa isa) {
+    kernel_isa_ = std::min(isa, DetectKernelIsa());
+    InvalidateAccelerations();
+  }
+  KernelIsa GetKernelIsa() const {
+    return kernel_isa_;
+  }
+
+  // Для float: суммы сил по источникам копятся в double, а разности координат и 1/r^3 считаются во float
+  // Ошибка суммы перестает расти с числом тел ценой примерно вдвое более медленного ядра; для double не влияет
+  void SetDoubleAccumulators(bool enabled) {
+    double_accumulators_ = enabled;
+    InvalidateAccelerations();
+  }
+  bool DoubleAccumulators() const {
+    return double_accumulators_;
+  }
+
+  // Детерминированный режим: шаг дает побитово одинаковый результат при любом числе потоков
+  // Меняет только прямое ядро kScalar: каждое тело само суммирует вклады всех остальных по порядку номеров, без буферов потоков;
+  // векторные ядра, Барнс-Хат, сетка, cutoff и удары (kSequential, kColored) от числа потоков не зависят
+  // Цена - вдвое больше пар: на одном потоке шаг с kScalar медленнее примерно на 30% при 1000 телах и на 20% при 10000
+  void SetDeterministic(bool enabled) {
+    deterministic_ = enabled;
+    InvalidateAccelerations();
+  }
+  bool Deterministic() const {
+    return deterministic_;
+  }
+
+  void SetIntegrator(Integrator integrator) {
+    integrator_ = integrator;
+    InvalidateAccelerations();
+  }
+  Integrator GetIntegrator() const {
+    return integrator_;
+  }
+
+  // Иерархические блочные шаги: тело уровня L шагает с dt / 2^L, 0 <= L <= max_level, max_level не больше 16
+  // Уровень выбирается по критерию eta * |a| / |da/dt|, новому телу - по рывку из пробного дрейфа на dt / 2^max_level
+  // Шаг проходит только границы самого мелкого занятого уровня, силы на них считаются только для активных тел
+  // Схема - kick-drift-kick, настройка интегратора при этом не используется; 0 - выключено
+  void SetBlockTimeSteps(std::size_t max_level) {
+    block_max_level_ = std::min<std::size_t>(max_level, kMaxBlockLevel);
+    levels_.clear();
+  }
+  std::size_t BlockTimeSteps() const {
+    return block_max_level_;
+  }
+
+  void SetTimeStepAccuracy(double eta) {
+    block_eta_ = eta;
+  }
+  double TimeStepAccuracy() const {
+    return block_eta_;
+  }
+
+  // Уровень тела после последнего шага; тело после удара до оценки в следующем шаге числится на уровне 0
+  std::size_t TimeStepLevel(std::size_t index) const {
+    return index < levels_.size() && levels_[index] != kUnknownLevel ? levels_[index] : 0;
+  }
+
+  void SetCollisionMode(CollisionMode mode) {
+    collision_mode_ = mode;
+    InvalidateAccelerations();
+  }
+  CollisionMode GetCollisionMode() const {
+    return collision_mode_;
+  }
+
+  void SetContactOrder(ContactOrder order) {
+    contact_order_ = order;
+  }
+  ContactOrder GetContactOrder() const {
+    return contact_order_;
+  }
+
+  void SetBroadPhase(BroadPhase broad_phase) {
+    broad_phase_ = broad_phase;
   }
-  const std::vector<object::Object>& Objects() const {
-    return objects_;
+  BroadPhase GetBroadPhase() const {
+    return broad_phase_;
   }
 
-  void AddObject(const object::Object& obj) {
-    objects_.push_back(obj);
+  // Число потоков для Step, 0 - по числу ядер
+  // Пул создается один раз и переиспользуется всеми фазами шага
+  void SetThreads(std::size_t threads);
+  std::size_t Threads() const {
+    return pool_ ? pool_->Size() : 1;
   }
 
+  // Тела хранятся в ParticleStore, а Objects() - совместимое представление в виде массива объектов
+  // Оно собирается лениво при вызове: правки через полученную ссылку подхватывает следующий Step() или HandleCollisions(),
+  // после них ссылка устаревает, пока Objects() не обновит тот же массив заново; правки через устаревшую ссылку теряются
+  std::vector<object::Object>& Objects();
+  const std::vector<object::Object>& Objects() const;
+
+  Store& Particles();
+  const Store& Particles() const;
+
+  // Пружины между телами; их силы прибавляются к гравитации на каждом вычислении сил, а энергия входит в потенциальную
+  // Номера тел проверяются при первом шаге после изменения сети
+  SpringNetwork& Springs() {
+    InvalidateAccelerations();
+    return springs_;
+  }
+  const SpringNetwork& Springs() const {
+    return springs_;
+  }
+
+  // Засыпание тел в покое: тело, у которого |v| <= speed и |a| <= acceleration держатся steps шагов подряд, засыпает
+  // со скоростью и ускорением ноль, если все тела, связанные с ним пружинами, тоже готовы уснуть
+  // Спящее тело не получает сил и стоит на месте, но остается источником гравитации, концом пружин и участником столкновений
+  // Будят его удар, пружина к движущемуся телу, ускорение выше acceleration, ненулевая скорость, заданная через
+  // Particles() или Objects(), и WakeUp
+  // Силы считаются только для бодрствующих тел, а для спящих - раз в steps шагов; пары из двух спящих тел не проверяются
+  // С блочными шагами не действует; steps = 0 выключает засыпание и будит все тела
+  void SetSleeping(units::Speed speed, units::Acceleration acceleration, std::size_t steps);
+  units::Speed SleepSpeed() const {
+    return sleep_speed_;
+  }
+  units::Acceleration SleepAcceleration() const {
+    return sleep_acceleration_;
+  }
+  std::size_t SleepSteps() const {
+    return sleep_steps_;
+  }
+
+  bool Asleep(std::size_t index) const {
+    return index < asleep_.size() && asleep_[index] != 0;
+  }
+  std::size_t AwakeCount() const {
+    return Size() - sleeping_;
+  }
+  void WakeUp(std::size_t index);
+  void WakeAll();
+
+  std::size_t Size() const {
+    return storage_ == Storage::kObjects ? objects_.size() : particles_.Size();
+  }
+
+  void AddObject(const object::Object& obj);
+
   void HandleElasticCollision(object::Object& a, object::Object& b);
   void HandleCollisions();
 
   void Step(units::Time dt);
 
+  // Число сделанных шагов и модельное время с начала расчета, восстанавливаются из контрольной точки
+  std::uint64_t StepCount() const {
+    return step_count_;
+  }
+  units::Time ElapsedTime() const {
+    return elapsed_time_;
+  }
+  void SetClock(std::uint64_t step_count, units::Time elapsed_time) {
+    step_count_ = step_count;
+    elapsed_time_ = elapsed_time;
+  }
+
+  // Время фаз и счетчики шагов с последнего ResetStats; без PHYSICS_ENABLE_STATS всегда нули
+  const StepStats& Stats() const {
+    return stats_.Stats();
+  }
+  void ResetStats() {
+    stats_.Reset();
+  }
+
+  // Запись фаз каждого шага для просмотра в chrome://tracing или Perfetto
+  void EnableTrace(bool enabled) {
+    stats_.EnableTrace(enabled);
+  }
+  void WriteTrace(const std::string& path) const {
+    stats_.WriteTrace(path);
+  }
+
+  // Потоковая запись: после каждого шага с номером, кратным recorder->RecordEvery(), кадр уходит в recorder
+  // Копии симулятора пишут в тот же файл; nullptr отключает запись
+  void SetRecorder(std::shared_ptr<io::TrajectoryWriter> recorder) {
+    recorder_ = std::move(recorder);
+  }
+  const std::shared_ptr<io::TrajectoryWriter>& Recorder() const {
+    return recorder_;
+  }
+
+  // steps шагов подряд с записью состояния после каждого record_every-го шага
+  // Массивы выделяются один раз заранее, кадров получается steps / record_every
+  Trajectory Run(std::size_t steps, units::Time dt, std::size_t record_every = 1, bool record_velocities = false);
+
+  // Диагностика: после каждого шага с номером, кратным every, в ряд добавляется Diagnostics; 0 - выключено
+  // Моменты считаются одним проходом по телам в конце шага, потенциал - в том же вычислении сил, что и ускорения:
+  // у Верле это последнее вычисление сил шага, у Эйлера, Рунге-Кутты и событийного режима - первое вычисление следующего шага
+  // Чехарде, Йошиде, блочным шагам и Верле после удара нужен отдельный проход сил; ускорения и траектория от диагностики не меняются
+  void SetDiagnostics(std::size_t every) {
+    diagnostics_every_ = every;
+  }
+  std::size_t DiagnosticsEvery() const {
+    return diagnostics_every_;
+  }
+
+  // Ряд с начала расчета или с ClearDiagnostics; недосчитанный потенциал последней точки досчитывается здесь
+  const std::vector<Diagnostics>& DiagnosticsSeries();
+  void ClearDiagnostics() {
+    diagnostics_.clear();
+    potential_pending_ = false;
+  }
+
+  // Сводка по текущему состоянию отдельным проходом сил, в ряд не попадает
+  Diagnostics ComputeDiagnostics();
+
  private:
-  std::vector<object::Object> objects_;
+  // 2^16 подшагов на шаг уже дают разброс шагов в 65536 раз
+  static constexpr std::size_t kMaxBlockLevel = 16;
+  // Уровень нового тела или тела после удара, оценивается в начале блочного шага
+  static constexpr std::size_t kUnknownLevel = std::numeric_limits<std::size_t>::max();
+
+  // Какое из представлений тел сейчас актуально
+  enum class Storage {
+    kSynced,
+    kParticles,
+    kObjects,
+  };
+
+  mutable std::vector<object::Object> objects_;
+  mutable Store particles_;
+  mutable Storage storage_ = Storage::kSynced;
+  // Ссылка на objects_ отдана наружу и еще не устарела: правки через нее надо забрать даже после чтения обратно
+  bool objects_shared_ = false;
+
   bool use_gravity_ = true;
   units::Length collision_distance_{units::Length{0.0}};
+  std::uint64_t step_count_ = 0;
+  units::Time elapsed_time_{0.0};
+  std::shared_ptr<io::TrajectoryWriter> recorder_;
+  StatsCollector stats_;
+  GravitySolver gravity_solver_ = GravitySolver::kDirect;
+  double theta_ = 0.5;
+  units::Length softening_{0.0};
+  KernelIsa kernel_isa_ = DetectKernelIsa();
+  bool double_accumulators_ = false;
+  bool deterministic_ = false;
+  Integrator integrator_ = Integrator::kSemiImplicitEuler;
+  // Ускорения в particles_ посчитаны для текущих положений; Верле берет их из прошлого шага
+  bool accelerations_valid_ = false;
+  Octree octree_;
+  MeshOptions mesh_options_;
+  ParticleMesh mesh_;
+  // Ускорения всех тел от сетки, когда силы нужны только активным телам блочных шагов
+  std::vector<S> mesh_acc_;
+  BroadPhase broad_phase_ = BroadPhase::kBruteForce;
+  SpatialHash spatial_hash_;
+  SweepAndPrune sweep_and_prune_;
+  std::vector<SpatialHash::Pair> pairs_;
+  // Радиус списков соседей - наибольший из cutoff_ (для kCutoff) и collision_distance_ (для kNeighborList)
+  NeighborList neighbor_list_;
+  units::Length cutoff_{0.0};
+  units::Length skin_{0.0};
+  SpringNetwork springs_;
+  CollisionMode collision_mode_ = CollisionMode::kDiscrete;
+  ContactOrder contact_order_ = ContactOrder::kSequential;
+  // Граф контактов: пары в порядке обнаружения, они же по цветам с началом каждого цвета, занятые цвета тел и исход ударов
+  std::vector<SpatialHash::Pair> contacts_;
+  std::vector<SpatialHash::Pair> colored_;
+  std::vector<std::size_t> color_start_;
+  std::vector<std::uint8_t> contact_color_;
+  std::vector<std::uint64_t> body_colors_;
+  std::vector<std::uint8_t> resolved_;
+
+  // Удар внутри шага: доля шага (или время для событийного режима) и пара тел
+  struct Impact {
+    double time;
+    std::uint32_t i;
+    std::uint32_t j;
+    std::uint32_t count_i;
+    std::uint32_t count_j;
+
+    bool operator>(const Impact& other) const {
+      return std::tie(time, i, j) > std::tie(other.time, other.i, other.j);
+    }
+  };
+
+  // Положения в начале шага для заметания сфер, по n значений x, y, z
+  std::vector<S> step_start_;
+  std::vector<Impact> impacts_;
+  std::vector<std::uint8_t> collided_;
+  // Событийный режим: время, к которому относится положение тела, число ударов тела и соседи в формате CSR
+  std::vector<double> body_time_;
+  std::vector<std::uint32_t> collision_count_;
+  std::vector<std::size_t> neighbor_start_;
+  std::vector<std::uint32_t> neighbors_;
+
+  std::size_t block_max_level_ = 0;
+  double block_eta_ = 0.02;
+  std::vector<std::size_t> levels_;
+  // Номера тел каждого уровня и положения до пробного дрейфа, по 3 * n значений
+  std::vector<std::vector<std::size_t>> level_bodies_;
+  std::vector<S> probe_pos_;
+  // Активные тела подшага, их координаты и новые ускорения, по 3 * active_.size() значений
+  std::vector<std::size_t> active_;
+  std::vector<S> active_pos_;
+  std::vector<S> active_acc_;
+
+  // Начальное состояние и накопленные наклоны для Рунге-Кутты, по 3 * n значений
+  std::vector<S> rk_state_;
+  std::vector<S> rk_sum_;
+
+  // Засыпание: пороги, число спокойных шагов подряд и флаг сна каждого тела, список бодрствующих тел
+  units::Speed sleep_speed_{0.0};
+  units::Acceleration sleep_acceleration_{0.0};
+  std::size_t sleep_steps_ = 0;
+  std::vector<std::uint32_t> quiet_steps_;
+  std::vector<std::uint8_t> asleep_;
+  std::vector<std::size_t> awake_;
+  std::vector<std::size_t> falling_asleep_;
+  std::size_t sleeping_ = 0;
+  // Шагов с последней проверки сил на спящих телах
+  std::size_t steps_since_force_check_ = 0;
+  // Тела менялись снаружи: спящие с ненулевой скоростью надо разбудить перед шагом
+  bool sleep_check_ = false;
+
+  // Копии симулятора делят один пул
+  std::shared_ptr<parallel::ThreadPool> pool_;
+  // Буферы ускорений для каждого потока в попарном суммировании
+  std::vector<std::vector<double>> thread_acc_;
+  std::vector<std::size_t> row_bounds_;
+
+  std::size_t diagnostics_every_ = 0;
+  std::vector<Diagnostics> diagnostics_;
+  // У последней точки ряда еще нет потенциала, а состояние с тех пор не менялось
+  bool potential_pending_ = false;
+  // Следующее вычисление сил заодно считает потенциальную энергию в potential_energy_
+  bool potential_requested_ = false;
+  double potential_energy_ = 0.0;
+  // Потенциал в точке каждого тела, суммы по кускам тел или строк пар и сохраненные на время отдельного прохода ускорения
+  std::vector<S> potential_;
+  std::vector<double> partial_potential_;
+  std::vector<Diagnostics> partial_moments_;
+  std::vector<S> saved_acc_;
+
+  void ParallelFor(std::size_t count, std::size_t grain, const parallel::ThreadPool::RangeFn& fn);
+
+  void SyncObjects() const;
+  void SyncParticles() const;
+  // Начало шага или проверки ударов: актуальные тела в particles_ вместе с правками через отданный Objects(), затем сон
+  void SyncBodies();
+
+  // Настройки или тела меняются: отложенный потенциал досчитывается по старому состоянию, затем ускорения сбрасываются
+  void InvalidateAccelerations() {
+    CompletePotential();
+    accelerations_valid_ = false;
+  }
 
   void ResetAccelerations();
-  void ApplyGravity();
+  void ComputeAccelerations();
+  void ApplyGravity(bool potential);
+  void ApplyGravityDirect(bool potential);
+  void ApplyGravityPairwise(bool potential);
+  void ApplyGravityBarnesHut(bool potential);
+  void ApplyGravityParticleMesh(bool potential);
+  void ApplyGravityCutoff(bool potential);
+  void UpdateNeighborList();
+  void CutoffSum(std::size_t i, double acc[3], double* potential) const;
+  double SumPotential();
+  double PotentialPass();
+  void CompletePotential();
+  bool ForcesAtStepStart() const;
+  Diagnostics Moments();
+  void Integrate(units::Time dt);
+  void Kick(double h);
+  void Drift(double h);
+  void StepRungeKutta4(double h);
+  void StepBlock(double dt);
+  std::size_t BlockLevel(double dt, double acc, double jerk) const;
+  void EstimateBlockLevels(double dt);
+  void ComputeActiveAccelerations();
+  void ActiveForces();
+  void ApplyActiveGravity();
+  void ComputeAwakeAccelerations();
+  void SyncSleep();
+  void Wake(std::size_t index);
+  void CheckSleepingForces(double acceleration2);
+  void UpdateSleep();
+  void HandleDiscreteCollisions();
+  bool ResolveCollision(std::size_t i, std::size_t j);
+  bool ResolvePair(std::size_t i, std::size_t j);
+  bool ResolveContacts();
+  void FindCandidatePairs(double distance);
+  void SaveStepStart();
+  void HandleContinuousCollisions(double h);
+  void DriftEventDriven(double h);
 };
 
+using Simulator = BasicSimulator<double>;
+using Simulator32 = BasicSimulator<float>;
+
+extern template class BasicSimulator<double>;
+extern template class BasicSimulator<float>;
+
 }  // namespace physics::simulator
\ No newline at end of file
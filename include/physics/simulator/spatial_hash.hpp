@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <physics/parallel/thread_pool.hpp>
+#include <physics/simulator/particles.hpp>
+
+namespace physics::simulator {
+
+// Равномерная сетка с хешированием ячеек для поиска пар близких тел
+// Размер ячейки равен радиусу поиска, поэтому достаточно проверить 27 соседних ячеек
+class SpatialHash {
+ public:
+  using Pair = std::pair<std::uint32_t, std::uint32_t>;
+
+  // Находит все пары (i < j) с расстоянием не больше distance
+  // Пары отсортированы по (i, j), как в полном переборе, в том числе при поиске на пуле потоков
+  template <typename S>
+  void FindPairs(const BasicParticleStore<S>& particles, double distance, std::vector<Pair>& pairs, parallel::ThreadPool* pool = nullptr);
+
+ private:
+  std::vector<std::int64_t> cells_;
+  std::vector<std::uint32_t> bucket_start_;
+  std::vector<std::uint32_t> cursor_;
+  std::vector<std::uint32_t> entries_;
+  std::size_t mask_ = 0;
+  std::vector<std::vector<Pair>> block_pairs_;
+
+  std::size_t Bucket(std::int64_t x, std::int64_t y, std::int64_t z) const;
+  template <typename S>
+  void Query(const BasicParticleStore<S>& particles, double dist2, std::size_t begin, std::size_t end, std::vector<Pair>& pairs) const;
+};
+
+}  // namespace physics::simulator
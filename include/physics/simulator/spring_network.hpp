@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <physics/parallel/thread_pool.hpp>
+#include <physics/simulator/particles.hpp>
+#include <physics/units/quantity.hpp>
+
+namespace physics::simulator {
+
+// Сеть пружин между телами: сила вдоль пружины F = k * (L - L0) + c * (v_b - v_a) . u, как mech::ElasticForce плюс вязкое трение
+// Пружины хранятся списком, а для прохода сил - в формате CSR: у каждого тела подряд лежат его пружины вместе с параметрами,
+// поэтому тело читает один непрерывный кусок и пишет только свое ускорение, и потоки не мешают друг другу
+// Каждая пружина считается с обоих концов одними и теми же операциями, поэтому силы на концах равны и противоположны бит в бит
+class SpringNetwork {
+ public:
+  // Пружина между телами a и b с длиной покоя rest_length, жесткостью stiffness и коэффициентом затухания damping (Н*с/м)
+  void Add(std::uint32_t a, std::uint32_t b, units::Length rest_length, units::SpringConstant stiffness, double damping = 0.0);
+
+  // Пакетное добавление: все массивы одной длины, иначе std::invalid_argument
+  void Add(std::span<const std::uint32_t> a, std::span<const std::uint32_t> b, std::span<const double> rest_length, std::span<const double> stiffness,
+           std::span<const double> damping);
+
+  void Clear();
+
+  std::size_t Size() const {
+    return a_.size();
+  }
+  bool Empty() const {
+    return a_.empty();
+  }
+
+  std::uint32_t BodyA(std::size_t spring) const {
+    return a_[spring];
+  }
+  std::uint32_t BodyB(std::size_t spring) const {
+    return b_[spring];
+  }
+  units::Length RestLength(std::size_t spring) const {
+    return rest_[spring];
+  }
+  units::SpringConstant Stiffness(std::size_t spring) const {
+    return stiffness_[spring];
+  }
+  double Damping(std::size_t spring) const {
+    return damping_[spring];
+  }
+
+  // Вызывает fn(j) для каждого тела j, связанного пружиной с index, в порядке добавления; bodies - число тел
+  template <typename Fn>
+  void ForEachLinked(std::size_t index, std::size_t bodies, const Fn& fn) const {
+    if (!built_ || bodies_ != bodies) {
+      Build(bodies);
+    }
+    for (std::size_t e = start_[index]; e < start_[index + 1]; ++e) {
+      fn(links_[e].other);
+    }
+  }
+
+  // Прибавляет ускорения от пружин к ax, ay, az (массивы по particles.Size())
+  // Номер тела за пределами particles - std::out_of_range
+  template <typename S>
+  void AddAccelerations(const BasicParticleStore<S>& particles, S* ax, S* ay, S* az, parallel::ThreadPool* pool = nullptr) const;
+
+  // То же для одного тела, в double; для блочных шагов, где силы нужны только активным телам
+  template <typename S>
+  void AccelerationOn(std::size_t index, const BasicParticleStore<S>& particles, double acc[3]) const;
+
+  // Упругая сила k * (L - L0) каждой пружины без затухания, положительная при растяжении, через mech::ElasticForce
+  template <typename S>
+  void Tensions(const BasicParticleStore<S>& particles, std::span<units::Force> out, parallel::ThreadPool* pool = nullptr) const;
+
+  // Упругая энергия всей сети, сумма mech::ElasticPotentialEnergy по пружинам
+  template <typename S>
+  double Energy(const BasicParticleStore<S>& particles, parallel::ThreadPool* pool = nullptr) const;
+
+ private:
+  // Пружина глазами одного из концов; 32 байта, два элемента на строку кеша
+  struct Link {
+    std::uint32_t other;
+    double rest;
+    double stiffness;
+    double damping;
+  };
+
+  std::vector<std::uint32_t> a_;
+  std::vector<std::uint32_t> b_;
+  std::vector<units::Length> rest_;
+  std::vector<units::SpringConstant> stiffness_;
+  std::vector<double> damping_;
+
+  // CSR строится лениво при первом проходе после изменений или смены числа тел, как Objects() у симулятора
+  mutable std::vector<std::size_t> start_;
+  mutable std::vector<Link> links_;
+  mutable std::size_t bodies_ = 0;
+  mutable bool built_ = false;
+  // Удлинения и их результаты для Tensions и Energy
+  mutable std::vector<units::Length> stretch_;
+  mutable std::vector<units::Energy> energy_;
+
+  void Build(std::size_t bodies) const;
+  template <typename S>
+  void Row(std::size_t index, const BasicParticleStore<S>& particles, double acc[3]) const;
+  template <typename S>
+  void Stretches(const BasicParticleStore<S>& particles, parallel::ThreadPool* pool) const;
+};
+
+}  // namespace physics::simulator
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace physics::simulator {
+
+// Сборка с -DPHYSICS_ENABLE_STATS=OFF убирает замеры и счетчики целиком, Stats() тогда всегда нулевая
+#ifdef PHYSICS_ENABLE_STATS
+inline constexpr bool kStatsEnabled = true;
+#else
+inline constexpr bool kStatsEnabled = false;
+#endif
+
+// Фазы шага; kStep - весь шаг целиком, остальные вложены в него
+enum class StepPhase {
+  kStep,
+  kGravity,
+  kIntegration,
+  kCollisions,
+  kRecording,
+};
+
+inline constexpr std::size_t kStepPhaseCount = 5;
+
+const char* StepPhaseName(StepPhase phase);
+
+// Накопленные с последнего сброса значения
+struct StepStats {
+  std::uint64_t steps = 0;
+  double phase_seconds[kStepPhaseCount] = {};
+  // Пары, для которых узкая фаза проверяла расстояние или время удара
+  std::uint64_t pairs_examined = 0;
+  std::uint64_t collisions_resolved = 0;
+  // Сумма по шагам числа тел, получивших обновление скорости (в блочных шагах - только активные)
+  std::uint64_t bodies_integrated = 0;
+
+  double Seconds(StepPhase phase) const {
+    return phase_seconds[static_cast<std::size_t>(phase)];
+  }
+};
+
+// Счетчики и таймеры шага с необязательной записью событий в формате Chrome trace
+class StatsCollector {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  // Замер фазы от конструктора до деструктора
+  class Scope {
+   public:
+    Scope(StatsCollector& collector, StepPhase phase) : collector_(collector), phase_(phase) {
+      if constexpr (kStatsEnabled) {
+        start_ = Clock::now();
+        if (phase == StepPhase::kStep) {
+          counters_at_start_ = collector.stats_;
+        }
+      }
+    }
+    ~Scope() {
+      if constexpr (kStatsEnabled) {
+        collector_.Finish(*this, Clock::now());
+      }
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    friend class StatsCollector;
+
+    StatsCollector& collector_;
+    StepPhase phase_;
+    Clock::time_point start_;
+    StepStats counters_at_start_;
+  };
+
+  const StepStats& Stats() const {
+    return stats_;
+  }
+  void Reset();
+
+  void AddPairs(std::uint64_t count) {
+    if constexpr (kStatsEnabled) {
+      stats_.pairs_examined += count;
+    }
+  }
+  void AddCollisions(std::uint64_t count) {
+    if constexpr (kStatsEnabled) {
+      stats_.collisions_resolved += count;
+    }
+  }
+  void AddBodies(std::uint64_t count) {
+    if constexpr (kStatsEnabled) {
+      stats_.bodies_integrated += count;
+    }
+  }
+
+  // События копятся в памяти, пока запись включена; включение очищает прошлые события
+  void EnableTrace(bool enabled);
+  bool TraceEnabled() const {
+    return trace_enabled_;
+  }
+  std::size_t TraceEvents() const {
+    return events_.size();
+  }
+
+  // JSON для chrome://tracing и Perfetto: фазы - события "X", счетчики шага - события "C"
+  void WriteTrace(const std::string& path) const;
+
+ private:
+  struct TraceEvent {
+    StepPhase phase;
+    std::int64_t start_ns;
+    std::int64_t duration_ns;
+    // Для kStep - приращения счетчиков за шаг
+    std::uint64_t pairs;
+    std::uint64_t collisions;
+    std::uint64_t bodies;
+  };
+
+  StepStats stats_;
+  bool trace_enabled_ = false;
+  Clock::time_point trace_origin_ = Clock::now();
+  std::vector<TraceEvent> events_;
+
+  void Finish(const Scope& scope, Clock::time_point end);
+};
+
+using StatsScope = StatsCollector::Scope;
+
+}  // namespace physics::simulator
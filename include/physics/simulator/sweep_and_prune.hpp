@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <physics/simulator/particles.hpp>
+
+namespace physics::simulator {
+
+// Инкрементальный sweep-and-prune по трем осям
+// Концы кубов со стороной distance вокруг тел хранятся отсортированными между вызовами и досортировываются вставками,
+// а множество пересекающихся кубов обновляется только при перестановке концов, поэтому почти неподвижная система обходится в O(n)
+class SweepAndPrune {
+ public:
+  using Pair = std::pair<std::uint32_t, std::uint32_t>;
+
+  // Находит все пары (i < j) с расстоянием не больше distance, отсортированные по (i, j)
+  // При смене числа тел или distance структура строится заново
+  template <typename S>
+  void FindPairs(const BasicParticleStore<S>& particles, double distance, std::vector<Pair>& pairs);
+
+  // Число пар с пересекающимися кубами, которое хранится между вызовами
+  std::size_t OverlapCount() const {
+    return overlaps_.size();
+  }
+
+ private:
+  struct Endpoint {
+    double value;
+    std::uint32_t body;
+    bool is_min;
+  };
+
+  // Границы кубов: для тела i и оси k минимум в bounds_[6 * i + 2 * k], максимум следом
+  std::vector<double> bounds_;
+  std::vector<Endpoint> axes_[3];
+  std::unordered_set<std::uint64_t> overlaps_;
+  std::size_t bodies_ = 0;
+  double distance_ = 0.0;
+
+  static std::uint64_t Key(std::uint32_t a, std::uint32_t b);
+
+  template <typename S>
+  void Rebuild(const BasicParticleStore<S>& particles, double distance);
+  template <typename S>
+  void UpdateBounds(const BasicParticleStore<S>& particles);
+  void SortAxis(std::size_t axis);
+  bool BoxesOverlap(std::uint32_t a, std::uint32_t b) const;
+};
+
+}  // namespace physics::simulator
@@ -1,23 +1,39 @@
 #pragma once
 
 #include <cmath>
+#include <type_traits>
 
 namespace physics::units {
 
 // Класс представляющий собой величину для дальнейших вычислений
-template <int T, int L, int M>
+// S - тип числа; по умолчанию double, float вдвое экономит память и полосу SIMD
+template <int T, int L, int M, typename S = double>
 struct Quantity {
-  double value;
+  S value;
 };
 
 template <typename>
 inline constexpr bool kIsQuantityV = false;
 
-template <int T, int L, int M>
-inline constexpr bool kIsQuantityV<Quantity<T, L, M>> = true;
+template <int T, int L, int M, typename S>
+inline constexpr bool kIsQuantityV<Quantity<T, L, M, S>> = true;
 
+// Тип числа внутри величины, для чисел - сам тип
 template <typename U>
-constexpr double ScalarValue(const U& x) {
+struct ScalarOf {
+  using Type = U;
+};
+
+template <int T, int L, int M, typename S>
+struct ScalarOf<Quantity<T, L, M, S>> {
+  using Type = S;
+};
+
+template <typename U>
+using ScalarOfT = typename ScalarOf<U>::Type;
+
+template <typename U>
+constexpr ScalarOfT<U> ScalarValue(const U& x) {
   if constexpr (std::is_arithmetic_v<U>) {
     return x;
   } else {
@@ -25,52 +41,58 @@ constexpr double ScalarValue(const U& x) {
   }
 }
 
+// Та же величина с другим типом числа
+template <typename To, int T, int L, int M, typename S>
+constexpr Quantity<T, L, M, To> QuantityCast(const Quantity<T, L, M, S>& q) {
+  return Quantity<T, L, M, To>{static_cast<To>(q.value)};
+}
+
 // Операторы для вычисления величин
 // Определены для двух величин и для величины и числа
 // Очень еще удобно что умножение и сложение со скаляром некоммутативно потому что мне лень было определять левый операнд
-template <int T, int L, int M>
-constexpr Quantity<T, L, M> operator*(const Quantity<T, L, M>& left, double right) {
-  return Quantity<T, L, M>{left.value * right};
+template <int T, int L, int M, typename S>
+constexpr Quantity<T, L, M, S> operator*(const Quantity<T, L, M, S>& left, double right) {
+  return Quantity<T, L, M, S>{static_cast<S>(left.value * right)};
 };
 
-template <int T, int L, int M>
-constexpr Quantity<T, L, M> operator/(const Quantity<T, L, M>& left, double right) {
-  return Quantity<T, L, M>{left.value / right};
+template <int T, int L, int M, typename S>
+constexpr Quantity<T, L, M, S> operator/(const Quantity<T, L, M, S>& left, double right) {
+  return Quantity<T, L, M, S>{static_cast<S>(left.value / right)};
 };
 
-template <int Power, int T, int L, int M>
-constexpr Quantity<T * Power, L * Power, M * Power> Pow(const Quantity<T, L, M>& left) {
-  return Quantity<T * Power, L * Power, M * Power>{std::pow(left.value, Power)};
+template <int Power, int T, int L, int M, typename S>
+constexpr Quantity<T * Power, L * Power, M * Power, S> Pow(const Quantity<T, L, M, S>& left) {
+  return Quantity<T * Power, L * Power, M * Power, S>{static_cast<S>(std::pow(left.value, Power))};
 };
 
-template <int T, int L, int M>
-constexpr Quantity<T, L, M> operator+(const Quantity<T, L, M>& left, double right) {
-  return Quantity<T, L, M>{left.value + right};
+template <int T, int L, int M, typename S>
+constexpr Quantity<T, L, M, S> operator+(const Quantity<T, L, M, S>& left, double right) {
+  return Quantity<T, L, M, S>{static_cast<S>(left.value + right)};
 };
 
-template <int T, int L, int M>
-constexpr Quantity<T, L, M> operator-(const Quantity<T, L, M>& left, double right) {
-  return Quantity<T, L, M>{left.value - right};
+template <int T, int L, int M, typename S>
+constexpr Quantity<T, L, M, S> operator-(const Quantity<T, L, M, S>& left, double right) {
+  return Quantity<T, L, M, S>{static_cast<S>(left.value - right)};
 };
 
-template <int T, int L, int M>
-constexpr Quantity<T, L, M> operator+(const Quantity<T, L, M>& left, const Quantity<T, L, M>& right) {
-  return Quantity<T, L, M>{left.value + right.value};
+template <int T, int L, int M, typename S>
+constexpr Quantity<T, L, M, S> operator+(const Quantity<T, L, M, S>& left, const Quantity<T, L, M, S>& right) {
+  return Quantity<T, L, M, S>{left.value + right.value};
 };
 
-template <int T, int L, int M>
-constexpr Quantity<T, L, M> operator-(const Quantity<T, L, M>& left, const Quantity<T, L, M>& right) {
-  return Quantity<T, L, M>{left.value - right.value};
+template <int T, int L, int M, typename S>
+constexpr Quantity<T, L, M, S> operator-(const Quantity<T, L, M, S>& left, const Quantity<T, L, M, S>& right) {
+  return Quantity<T, L, M, S>{left.value - right.value};
 };
 
-template <int T1, int L1, int M1, int T2, int L2, int M2>
-constexpr Quantity<T1 + T2, L1 + L2, M1 + M2> operator*(const Quantity<T1, L1, M1>& left, const Quantity<T2, L2, M2>& right) {
-  return Quantity<T1 + T2, L1 + L2, M1 + M2>{left.value * right.value};
+template <int T1, int L1, int M1, int T2, int L2, int M2, typename S>
+constexpr Quantity<T1 + T2, L1 + L2, M1 + M2, S> operator*(const Quantity<T1, L1, M1, S>& left, const Quantity<T2, L2, M2, S>& right) {
+  return Quantity<T1 + T2, L1 + L2, M1 + M2, S>{left.value * right.value};
 };
 
-template <int T1, int L1, int M1, int T2, int L2, int M2>
-constexpr Quantity<T1 - T2, L1 - L2, M1 - M2> operator/(const Quantity<T1, L1, M1>& left, const Quantity<T2, L2, M2>& right) {
-  return Quantity<T1 - T2, L1 - L2, M1 - M2>{left.value / right.value};
+template <int T1, int L1, int M1, int T2, int L2, int M2, typename S>
+constexpr Quantity<T1 - T2, L1 - L2, M1 - M2, S> operator/(const Quantity<T1, L1, M1, S>& left, const Quantity<T2, L2, M2, S>& right) {
+  return Quantity<T1 - T2, L1 - L2, M1 - M2, S>{left.value / right.value};
 };
 
 // Основные единицы измерения
@@ -83,6 +105,18 @@ using Force = Quantity<-2, 1, 1>;
 using Energy = Quantity<-2, 2, 1>;
 using SpringConstant = Quantity<-2, 1, 1>;
 
+// Те же единицы с произвольным типом числа
+template <typename S>
+using BasicTime = Quantity<1, 0, 0, S>;
+template <typename S>
+using BasicLength = Quantity<0, 1, 0, S>;
+template <typename S>
+using BasicWeight = Quantity<0, 0, 1, S>;
+template <typename S>
+using BasicSpeed = Quantity<-1, 1, 0, S>;
+template <typename S>
+using BasicAcceleration = Quantity<-2, 1, 0, S>;
+
 // Удобство для задания переменных суффиксами
 constexpr inline Time operator""_s(long double value) {
   return {static_cast<double>(value)};
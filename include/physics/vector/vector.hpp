@@ -91,7 +91,7 @@ class Vector {
 template <typename T1, typename T2, std::size_t N>
 constexpr auto Dot(const Vector<T1, N>& left, const Vector<T2, N>& right) {
   using MulType = decltype(left[0] * right[0]);
-  MulType sum{0.0};
+  MulType sum{};
 
   for (std::size_t i = 0; i < N; ++i) {
     sum = sum + (left[i] * right[i]);
@@ -106,13 +106,14 @@ constexpr T Norm(const Vector<T, N>& v) {
 }
 
 template <typename T, std::size_t N>
-constexpr Vector<units::Quantity<0, 0, 0>, N> Normalize(const Vector<T, N>& v) {
-  using Dimensionless = units::Quantity<0, 0, 0>;
+constexpr Vector<units::Quantity<0, 0, 0, units::ScalarOfT<T>>, N> Normalize(const Vector<T, N>& v) {
+  using Scalar = units::ScalarOfT<T>;
+  using Dimensionless = units::Quantity<0, 0, 0, Scalar>;
 
   Vector<Dimensionless, N> result{};
 
   T norm = Norm(v);
-  double len = units::ScalarValue(norm);
+  Scalar len = units::ScalarValue(norm);
 
   for (std::size_t i = 0; i < N; ++i) {
     result[i] = len != 0 ? Dimensionless{units::ScalarValue(v[i]) / len} : Dimensionless{0};
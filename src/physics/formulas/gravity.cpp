@@ -1,4 +1,5 @@
 #include <physics/constants.hpp>
+#include <physics/formulas/elementwise.hpp>
 #include <physics/formulas/gravity.hpp>
 #include <physics/units/quantity.hpp>
 
@@ -24,4 +25,29 @@ units::Speed OrbitalVelocity(units::Weight planet, units::Length radius) {
   return units::Speed{std::sqrt(physics::constants::kG.value * planet.value / radius.value)};
 }
 
+void GravitationalForce(std::span<const units::Weight> m1, std::span<const units::Weight> m2, std::span<const units::Length> distance,
+                        std::span<units::Force> out, parallel::ThreadPool* pool) {
+  formulas::Elementwise(pool, [](auto... args) { return GravitationalForce(args...); }, out, m1, m2, distance);
+}
+
+void GravitationalAcceleration(std::span<const units::Weight> mass, std::span<const units::Length> radius, std::span<units::Acceleration> out,
+                               parallel::ThreadPool* pool) {
+  formulas::Elementwise(pool, [](auto... args) { return GravitationalAcceleration(args...); }, out, mass, radius);
+}
+
+void GravitationalPotentialEnergy(std::span<const units::Weight> m1, std::span<const units::Weight> m2, std::span<const units::Length> distance,
+                                  std::span<units::Energy> out, parallel::ThreadPool* pool) {
+  formulas::Elementwise(pool, [](auto... args) { return GravitationalPotentialEnergy(args...); }, out, m1, m2, distance);
+}
+
+void EscapeVelocity(std::span<const units::Weight> planet, std::span<const units::Length> radius, std::span<units::Speed> out,
+                    parallel::ThreadPool* pool) {
+  formulas::Elementwise(pool, [](auto... args) { return EscapeVelocity(args...); }, out, planet, radius);
+}
+
+void OrbitalVelocity(std::span<const units::Weight> planet, std::span<const units::Length> radius, std::span<units::Speed> out,
+                     parallel::ThreadPool* pool) {
+  formulas::Elementwise(pool, [](auto... args) { return OrbitalVelocity(args...); }, out, planet, radius);
+}
+
 }  // namespace physics::gravity
\ No newline at end of file
@@ -1,3 +1,5 @@
+#include <physics/formulas/elementwise.hpp>
+#include <physics/formulas/mech.hpp>
 #include <physics/units/quantity.hpp>
 
 namespace physics::mech {
@@ -50,4 +52,64 @@ units::Energy ElasticPotentialEnergy(units::Quantity<-2, 1, 1> k, units::Length
   return units::Energy{0.5 * k.value * x.value * x.value};
 }
 
+void KineticEnergy(std::span<const units::Weight> mass, std::span<const units::Speed> speed, std::span<units::Energy> out,
+                   parallel::ThreadPool* pool) {
+  formulas::Elementwise(pool, [](auto... args) { return KineticEnergy(args...); }, out, mass, speed);
+}
+
+void PotentialEnergy(std::span<const units::Weight> mass, std::span<const units::Acceleration> g, std::span<const units::Length> height,
+                     std::span<units::Energy> out, parallel::ThreadPool* pool) {
+  formulas::Elementwise(pool, [](auto... args) { return PotentialEnergy(args...); }, out, mass, g, height);
+}
+
+void NewtonSecondLaw(std::span<const units::Weight> mass, std::span<const units::Acceleration> accel, std::span<units::Force> out,
+                     parallel::ThreadPool* pool) {
+  formulas::Elementwise(pool, [](auto... args) { return NewtonSecondLaw(args...); }, out, mass, accel);
+}
+
+void AverageSpeed(std::span<const units::Length> distance, std::span<const units::Time> time, std::span<units::Speed> out,
+                  parallel::ThreadPool* pool) {
+  formulas::Elementwise(pool, [](auto... args) { return AverageSpeed(args...); }, out, distance, time);
+}
+
+void UniformMotion(std::span<const units::Length> initial, std::span<const units::Speed> speed, std::span<const units::Time> time,
+                   std::span<units::Length> out, parallel::ThreadPool* pool) {
+  formulas::Elementwise(pool, [](auto... args) { return UniformMotion(args...); }, out, initial, speed, time);
+}
+
+void AcceleratedMotion(std::span<const units::Length> initial, std::span<const units::Speed> v0, std::span<const units::Acceleration> a,
+                       std::span<const units::Time> t, std::span<units::Length> out, parallel::ThreadPool* pool) {
+  formulas::Elementwise(pool, [](auto... args) { return AcceleratedMotion(args...); }, out, initial, v0, a, t);
+}
+
+void Momentum(std::span<const units::Weight> mass, std::span<const units::Speed> speed, std::span<units::Quantity<0, 1, 1>> out,
+              parallel::ThreadPool* pool) {
+  formulas::Elementwise(pool, [](auto... args) { return Momentum(args...); }, out, mass, speed);
+}
+
+void Work(std::span<const units::Force> force, std::span<const units::Length> displacement, std::span<units::Energy> out,
+          parallel::ThreadPool* pool) {
+  formulas::Elementwise(pool, [](auto... args) { return Work(args...); }, out, force, displacement);
+}
+
+void Friction(std::span<const units::Quantity<0, 0, 0>> friction_coef, std::span<const units::Force> normal_force, std::span<units::Force> out,
+              parallel::ThreadPool* pool) {
+  formulas::Elementwise(pool, [](auto... args) { return Friction(args...); }, out, friction_coef, normal_force);
+}
+
+void StaticFrictionMax(std::span<const units::Quantity<0, 0, 0>> static_coef, std::span<const units::Force> normal_force, std::span<units::Force> out,
+                       parallel::ThreadPool* pool) {
+  formulas::Elementwise(pool, [](auto... args) { return StaticFrictionMax(args...); }, out, static_coef, normal_force);
+}
+
+void ElasticForce(std::span<const units::SpringConstant> k, std::span<const units::Length> x, std::span<units::Force> out,
+                  parallel::ThreadPool* pool) {
+  formulas::Elementwise(pool, [](auto... args) { return ElasticForce(args...); }, out, k, x);
+}
+
+void ElasticPotentialEnergy(std::span<const units::SpringConstant> k, std::span<const units::Length> x, std::span<units::Energy> out,
+                            parallel::ThreadPool* pool) {
+  formulas::Elementwise(pool, [](auto... args) { return ElasticPotentialEnergy(args...); }, out, k, x);
+}
+
 }  // namespace physics::mech
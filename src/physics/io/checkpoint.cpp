@@ -0,0 +1,207 @@
+#include "physics/io/checkpoint.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include <physics/io/endian.hpp>
+#include <physics/io/file.hpp>
+
+namespace physics::io {
+
+namespace {
+
+constexpr char kMagic[8] = {'P', 'H', 'Y', 'S', 'C', 'K', 'P', 'T'};
+constexpr std::uint32_t kFlagGravity = 1u << 0;
+constexpr std::size_t kArrays = 10;
+// Порция для перестановки байт на big-endian машинах
+constexpr std::size_t kSwapChunk = 1 << 16;
+
+struct Header {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t flags;
+  std::uint64_t bodies;
+  std::uint64_t steps;
+  double time;
+  double collision_distance;
+  std::uint8_t reserved[16];
+};
+static_assert(sizeof(Header) == 64, "checkpoint header must stay 64 bytes");
+
+// Массивы float-симулятора хранятся в файле как double, поэтому переводятся порциями
+template <typename S>
+void WriteArray(int fd, const std::vector<S>& values, const std::string& path) {
+  if constexpr (std::is_same_v<S, double> && std::endian::native == std::endian::little) {
+    // Один большой последовательный write на массив
+    WriteAll(fd, values.data(), values.size() * sizeof(double), path);
+  } else {
+    std::vector<double> chunk;
+    for (std::size_t begin = 0; begin < values.size(); begin += kSwapChunk) {
+      const std::size_t end = std::min(values.size(), begin + kSwapChunk);
+      chunk.resize(end - begin);
+      std::transform(values.begin() + begin, values.begin() + end, chunk.begin(), [](S v) { return ToLittleEndian(static_cast<double>(v)); });
+      WriteAll(fd, chunk.data(), chunk.size() * sizeof(double), path);
+    }
+  }
+}
+
+template <typename S>
+void ReadArray(const char* source, std::size_t n, std::vector<S>& values) {
+  values.resize(n);
+  if constexpr (std::is_same_v<S, double>) {
+    std::memcpy(values.data(), source, n * sizeof(double));
+    if constexpr (std::endian::native != std::endian::little) {
+      std::transform(values.begin(), values.end(), values.begin(), ToLittleEndian<double>);
+    }
+  } else {
+    for (std::size_t i = 0; i < n; ++i) {
+      double value;
+      std::memcpy(&value, source + i * sizeof(double), sizeof(double));
+      values[i] = static_cast<S>(ToLittleEndian(value));
+    }
+  }
+}
+
+// Отображение файла только для чтения, снимается в деструкторе
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string& path) {
+    FileDescriptor fd(::open(path.c_str(), O_RDONLY | O_CLOEXEC));
+    if (fd.Get() < 0) {
+      ThrowErrno("cannot open checkpoint", path);
+    }
+
+    struct stat info {};
+    if (::fstat(fd.Get(), &info) != 0) {
+      ThrowErrno("cannot stat checkpoint", path);
+    }
+    size_ = static_cast<std::size_t>(info.st_size);
+    if (size_ < sizeof(Header)) {
+      throw std::runtime_error("checkpoint is truncated: " + path);
+    }
+
+    data_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd.Get(), 0);
+    if (data_ == MAP_FAILED) {
+      data_ = nullptr;
+      ThrowErrno("cannot map checkpoint", path);
+    }
+    // Файл читается один раз от начала до конца
+    ::madvise(data_, size_, MADV_SEQUENTIAL);
+  }
+
+  ~MappedFile() {
+    if (data_ != nullptr) {
+      ::munmap(data_, size_);
+    }
+  }
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  const char* Data() const {
+    return static_cast<const char*>(data_);
+  }
+  std::size_t Size() const {
+    return size_;
+  }
+
+ private:
+  void* data_ = nullptr;
+  std::size_t size_ = 0;
+};
+
+}  // namespace
+
+template <typename S>
+void SaveCheckpoint(const simulator::BasicSimulator<S>& sim, const std::string& path) {
+  const auto& p = sim.Particles();
+
+  Header header{};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = ToLittleEndian(kCheckpointVersion);
+  header.flags = ToLittleEndian(sim.GravityEnabled() ? kFlagGravity : 0u);
+  header.bodies = ToLittleEndian<std::uint64_t>(p.Size());
+  header.steps = ToLittleEndian<std::uint64_t>(sim.StepCount());
+  header.time = ToLittleEndian(sim.ElapsedTime().value);
+  header.collision_distance = ToLittleEndian(sim.CollisionDistance().value);
+
+  const std::string tmp_path = path + ".tmp";
+  FileDescriptor fd(::open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644));
+  if (fd.Get() < 0) {
+    ThrowErrno("cannot create checkpoint", tmp_path);
+  }
+
+  try {
+    WriteAll(fd.Get(), &header, sizeof(header), tmp_path);
+    for (const auto* values : {&p.x, &p.y, &p.z, &p.vx, &p.vy, &p.vz, &p.ax, &p.ay, &p.az, &p.mass}) {
+      WriteArray(fd.Get(), *values, tmp_path);
+    }
+    if (::fsync(fd.Get()) != 0) {
+      ThrowErrno("cannot flush checkpoint", tmp_path);
+    }
+    if (::close(fd.Release()) != 0) {
+      ThrowErrno("cannot close checkpoint", tmp_path);
+    }
+  } catch (...) {
+    ::unlink(tmp_path.c_str());
+    throw;
+  }
+
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    const int error = errno;
+    ::unlink(tmp_path.c_str());
+    errno = error;
+    ThrowErrno("cannot rename checkpoint to", path);
+  }
+}
+
+template <typename S>
+void LoadCheckpoint(const std::string& path, simulator::BasicSimulator<S>& sim) {
+  MappedFile file(path);
+
+  Header header{};
+  std::memcpy(&header, file.Data(), sizeof(header));
+  if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+    throw std::runtime_error("not a physics checkpoint: " + path);
+  }
+
+  const std::uint32_t version = ToLittleEndian(header.version);
+  if (version != kCheckpointVersion) {
+    throw std::runtime_error("unsupported checkpoint version " + std::to_string(version) + ": " + path);
+  }
+
+  const std::uint64_t n = ToLittleEndian(header.bodies);
+  const std::uint64_t payload = file.Size() - sizeof(Header);
+  if (n > payload / (kArrays * sizeof(double)) || payload != n * kArrays * sizeof(double)) {
+    throw std::runtime_error("checkpoint size does not match body count: " + path);
+  }
+
+  auto& p = sim.Particles();
+  const char* source = file.Data() + sizeof(Header);
+  for (auto* values : {&p.x, &p.y, &p.z, &p.vx, &p.vy, &p.vz, &p.ax, &p.ay, &p.az, &p.mass}) {
+    ReadArray(source, n, *values);
+    source += n * sizeof(double);
+  }
+
+  sim.EnableGravity((ToLittleEndian(header.flags) & kFlagGravity) != 0);
+  sim.SetCollisionDistance(units::Length{ToLittleEndian(header.collision_distance)});
+  sim.SetClock(ToLittleEndian(header.steps), units::Time{ToLittleEndian(header.time)});
+}
+
+template void SaveCheckpoint(const simulator::Simulator&, const std::string&);
+template void SaveCheckpoint(const simulator::Simulator32&, const std::string&);
+template void LoadCheckpoint(const std::string&, simulator::Simulator&);
+template void LoadCheckpoint(const std::string&, simulator::Simulator32&);
+
+}  // namespace physics::io
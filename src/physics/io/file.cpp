@@ -0,0 +1,55 @@
+#include "physics/io/file.hpp"
+
+#include <unistd.h>
+
+#include <cerrno>
+#include <system_error>
+
+namespace physics::io {
+
+FileDescriptor::~FileDescriptor() {
+  if (fd_ >= 0) {
+    ::close(fd_);
+  }
+}
+
+void ThrowErrno(const std::string& what, const std::string& path) {
+  throw std::system_error(errno, std::generic_category(), what + " " + path);
+}
+
+void WriteAll(int fd, const void* data, std::size_t size, const std::string& path) {
+  const auto* bytes = static_cast<const char*>(data);
+  while (size > 0) {
+    const ssize_t written = ::write(fd, bytes, size);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      ThrowErrno("cannot write", path);
+    }
+    bytes += written;
+    size -= static_cast<std::size_t>(written);
+  }
+}
+
+bool ReadAt(int fd, void* data, std::size_t size, std::uint64_t offset, const std::string& path) {
+  auto* bytes = static_cast<char*>(data);
+  while (size > 0) {
+    const ssize_t read = ::pread(fd, bytes, size, static_cast<off_t>(offset));
+    if (read < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      ThrowErrno("cannot read", path);
+    }
+    if (read == 0) {
+      return false;
+    }
+    bytes += read;
+    size -= static_cast<std::size_t>(read);
+    offset += static_cast<std::uint64_t>(read);
+  }
+  return true;
+}
+
+}  // namespace physics::io
@@ -0,0 +1,402 @@
+#include "physics/io/trajectory.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef PHYSICS_HAS_ZLIB
+#include <zlib.h>
+#endif
+
+#include <physics/io/endian.hpp>
+#include <physics/io/file.hpp>
+
+namespace physics::io {
+
+namespace {
+
+constexpr char kMagic[8] = {'P', 'H', 'Y', 'S', 'T', 'R', 'A', 'J'};
+constexpr std::uint32_t kFlagVelocities = 1u << 0;
+
+struct FileHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t flags;
+  std::uint64_t bodies;
+  std::uint64_t record_every;
+  std::uint32_t frames_per_chunk;
+  std::uint8_t reserved[28];
+};
+static_assert(sizeof(FileHeader) == 64, "trajectory header must stay 64 bytes");
+
+struct ChunkHeader {
+  std::uint32_t frames;
+  std::uint32_t compression;
+  std::uint64_t raw_size;
+  std::uint64_t stored_size;
+};
+static_assert(sizeof(ChunkHeader) == 24, "chunk header must stay 24 bytes");
+
+template <typename T>
+void Put(char*& out, T value) {
+  value = ToLittleEndian(value);
+  std::memcpy(out, &value, sizeof(T));
+  out += sizeof(T);
+}
+
+template <typename T>
+T Get(const char* in) {
+  T value;
+  std::memcpy(&value, in, sizeof(T));
+  return ToLittleEndian(value);
+}
+
+template <typename S>
+void PutInterleaved(char*& out, const std::vector<S>& x, const std::vector<S>& y, const std::vector<S>& z) {
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    Put(out, static_cast<double>(x[i]));
+    Put(out, static_cast<double>(y[i]));
+    Put(out, static_cast<double>(z[i]));
+  }
+}
+
+// Перестановка байт: сначала все младшие байты чисел, потом следующие и т.д.
+// Старшие байты (знак и порядок) соседних координат почти совпадают, и deflate сжимает их в разы лучше
+void Shuffle(const char* in, std::size_t size, char* out) {
+  const std::size_t words = size / sizeof(double);
+  for (std::size_t w = 0; w < words; ++w) {
+    for (std::size_t b = 0; b < sizeof(double); ++b) {
+      out[b * words + w] = in[w * sizeof(double) + b];
+    }
+  }
+}
+
+void Unshuffle(const char* in, std::size_t size, char* out) {
+  const std::size_t words = size / sizeof(double);
+  for (std::size_t w = 0; w < words; ++w) {
+    for (std::size_t b = 0; b < sizeof(double); ++b) {
+      out[w * sizeof(double) + b] = in[b * words + w];
+    }
+  }
+}
+
+}  // namespace
+
+bool CompressionAvailable(Compression compression) {
+#ifdef PHYSICS_HAS_ZLIB
+  return compression == Compression::kNone || compression == Compression::kZlib;
+#else
+  return compression == Compression::kNone;
+#endif
+}
+
+TrajectoryWriter::TrajectoryWriter(const std::string& path, const TrajectoryWriterOptions& options) : path_(path), options_(options) {
+  if (!CompressionAvailable(options_.compression)) {
+    throw std::runtime_error("trajectory compression is not available in this build");
+  }
+  options_.record_every = std::max<std::size_t>(options_.record_every, 1);
+  options_.frames_per_chunk = std::max<std::size_t>(options_.frames_per_chunk, 1);
+  options_.buffers = std::max<std::size_t>(options_.buffers, 1);
+
+  fd_ = ::open(path_.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd_ < 0) {
+    ThrowErrno("cannot create trajectory", path_);
+  }
+
+  thread_ = std::thread([this] { WriterLoop(); });
+}
+
+TrajectoryWriter::~TrajectoryWriter() {
+  try {
+    Close();
+  } catch (...) {
+    // Ошибки в деструкторе некуда передать; чтобы их увидеть, нужно звать Close явно
+  }
+}
+
+void TrajectoryWriter::Start(std::size_t bodies) {
+  bodies_ = bodies;
+  frame_size_ = 2 * sizeof(std::uint64_t) + (options_.velocities ? 6 : 3) * bodies * sizeof(double);
+
+  // Все буферы выделяются сразу, дальше запись идет без аллокаций
+  chunks_.resize(options_.buffers);
+  for (std::size_t c = 0; c < chunks_.size(); ++c) {
+    chunks_[c].data.resize(options_.frames_per_chunk * frame_size_);
+    free_.push_back(c);
+  }
+
+  FileHeader header{};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = ToLittleEndian(kTrajectoryVersion);
+  header.flags = ToLittleEndian(options_.velocities ? kFlagVelocities : 0u);
+  header.bodies = ToLittleEndian<std::uint64_t>(bodies_);
+  header.record_every = ToLittleEndian<std::uint64_t>(options_.record_every);
+  header.frames_per_chunk = ToLittleEndian(static_cast<std::uint32_t>(options_.frames_per_chunk));
+  // Фоновый поток начнет писать только после первого полного куска
+  WriteAll(fd_, &header, sizeof(header), path_);
+  started_ = true;
+}
+
+void TrajectoryWriter::ThrowIfFailed() {
+  std::lock_guard lock(mutex_);
+  if (error_) {
+    std::rethrow_exception(error_);
+  }
+}
+
+template <typename S>
+void TrajectoryWriter::Record(std::uint64_t step, double time, const simulator::BasicParticleStore<S>& particles) {
+  if (closed_) {
+    throw std::logic_error("trajectory writer is closed: " + path_);
+  }
+  if (!started_) {
+    Start(particles.Size());
+  } else if (particles.Size() != bodies_) {
+    throw std::runtime_error("trajectory body count changed from " + std::to_string(bodies_) + " to " + std::to_string(particles.Size()));
+  }
+
+  if (current_ == kNoChunk) {
+    // Противодавление: если диск не успевает, симулятор ждет свободный буфер
+    std::unique_lock lock(mutex_);
+    free_ready_.wait(lock, [this] { return !free_.empty() || error_; });
+    if (error_) {
+      std::rethrow_exception(error_);
+    }
+    current_ = free_.front();
+    free_.pop_front();
+  }
+
+  Chunk& chunk = chunks_[current_];
+  char* out = chunk.data.data() + chunk.frames * frame_size_;
+  Put(out, step);
+  Put(out, time);
+  PutInterleaved(out, particles.x, particles.y, particles.z);
+  if (options_.velocities) {
+    PutInterleaved(out, particles.vx, particles.vy, particles.vz);
+  }
+  ++frames_recorded_;
+
+  if (++chunk.frames == options_.frames_per_chunk) {
+    Submit();
+  }
+}
+
+template void TrajectoryWriter::Record(std::uint64_t, double, const simulator::ParticleStore&);
+template void TrajectoryWriter::Record(std::uint64_t, double, const simulator::ParticleStore32&);
+
+void TrajectoryWriter::Submit() {
+  {
+    std::lock_guard lock(mutex_);
+    full_.push_back(current_);
+  }
+  current_ = kNoChunk;
+  full_ready_.notify_one();
+}
+
+void TrajectoryWriter::Close() {
+  if (closed_) {
+    return;
+  }
+  closed_ = true;
+
+  if (!started_) {
+    Start(0);
+  }
+  if (current_ != kNoChunk && chunks_[current_].frames > 0) {
+    Submit();
+  }
+
+  {
+    std::lock_guard lock(mutex_);
+    closing_ = true;
+  }
+  full_ready_.notify_one();
+  thread_.join();
+
+  FileDescriptor fd(fd_);
+  fd_ = -1;
+  ThrowIfFailed();
+  if (::close(fd.Release()) != 0) {
+    ThrowErrno("cannot close trajectory", path_);
+  }
+}
+
+void TrajectoryWriter::WriterLoop() {
+  for (;;) {
+    std::size_t index;
+    bool failed;
+    {
+      std::unique_lock lock(mutex_);
+      full_ready_.wait(lock, [this] { return !full_.empty() || closing_; });
+      if (full_.empty()) {
+        return;
+      }
+      index = full_.front();
+      full_.pop_front();
+      failed = static_cast<bool>(error_);
+    }
+
+    // После первой ошибки куски только возвращаются в кольцо, чтобы Record не ждал вечно
+    if (!failed) {
+      try {
+        WriteChunk(chunks_[index]);
+      } catch (...) {
+        std::lock_guard lock(mutex_);
+        error_ = std::current_exception();
+      }
+    }
+
+    {
+      std::lock_guard lock(mutex_);
+      chunks_[index].frames = 0;
+      free_.push_back(index);
+    }
+    free_ready_.notify_one();
+  }
+}
+
+void TrajectoryWriter::WriteChunk(const Chunk& chunk) {
+  const std::size_t raw_size = chunk.frames * frame_size_;
+  const char* payload = chunk.data.data();
+  std::size_t stored_size = raw_size;
+
+#ifdef PHYSICS_HAS_ZLIB
+  if (options_.compression == Compression::kZlib) {
+    // Под сжатие и перестановку один буфер: первая половина - переставленные байты, вторая - результат deflate
+    uLongf bound = compressBound(static_cast<uLong>(raw_size));
+    packed_.resize(raw_size + bound);
+    Shuffle(payload, raw_size, packed_.data());
+    char* compressed = packed_.data() + raw_size;
+    if (compress2(reinterpret_cast<Bytef*>(compressed), &bound, reinterpret_cast<const Bytef*>(packed_.data()), static_cast<uLong>(raw_size),
+                  options_.compression_level) != Z_OK) {
+      throw std::runtime_error("cannot compress trajectory chunk: " + path_);
+    }
+    payload = compressed;
+    stored_size = bound;
+  }
+#endif
+
+  ChunkHeader header{};
+  header.frames = ToLittleEndian(static_cast<std::uint32_t>(chunk.frames));
+  header.compression = ToLittleEndian(static_cast<std::uint32_t>(options_.compression));
+  header.raw_size = ToLittleEndian<std::uint64_t>(raw_size);
+  header.stored_size = ToLittleEndian<std::uint64_t>(stored_size);
+  WriteAll(fd_, &header, sizeof(header), path_);
+  WriteAll(fd_, payload, stored_size, path_);
+}
+
+TrajectoryReader::TrajectoryReader(const std::string& path) : path_(path) {
+  FileDescriptor fd(::open(path_.c_str(), O_RDONLY | O_CLOEXEC));
+  if (fd.Get() < 0) {
+    ThrowErrno("cannot open trajectory", path_);
+  }
+
+  FileHeader header{};
+  if (!ReadAt(fd.Get(), &header, sizeof(header), 0, path_) || std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+    throw std::runtime_error("not a physics trajectory: " + path_);
+  }
+  const std::uint32_t version = ToLittleEndian(header.version);
+  if (version != kTrajectoryVersion) {
+    throw std::runtime_error("unsupported trajectory version " + std::to_string(version) + ": " + path_);
+  }
+
+  bodies_ = ToLittleEndian(header.bodies);
+  velocities_ = (ToLittleEndian(header.flags) & kFlagVelocities) != 0;
+  record_every_ = ToLittleEndian(header.record_every);
+  frame_size_ = 2 * sizeof(std::uint64_t) + (velocities_ ? 6 : 3) * bodies_ * sizeof(double);
+
+  // Проход по заголовкам кусков без чтения данных
+  std::uint64_t offset = sizeof(FileHeader);
+  ChunkHeader chunk{};
+  while (ReadAt(fd.Get(), &chunk, sizeof(chunk), offset, path_)) {
+    ChunkInfo info{};
+    info.offset = offset + sizeof(ChunkHeader);
+    info.frames = ToLittleEndian(chunk.frames);
+    info.compression = ToLittleEndian(chunk.compression);
+    info.raw_size = ToLittleEndian(chunk.raw_size);
+    info.stored_size = ToLittleEndian(chunk.stored_size);
+    info.first_frame = frames_;
+
+    char last;
+    const bool complete = info.stored_size == 0 || ReadAt(fd.Get(), &last, 1, info.offset + info.stored_size - 1, path_);
+    if (!complete || info.raw_size != info.frames * frame_size_) {
+      break;
+    }
+
+    chunks_.push_back(info);
+    frames_ += info.frames;
+    offset = info.offset + info.stored_size;
+  }
+
+  fd_ = fd.Release();
+}
+
+TrajectoryReader::~TrajectoryReader() {
+  FileDescriptor fd(fd_);
+}
+
+const char* TrajectoryReader::LoadFrame(std::size_t frame) const {
+  if (frame >= frames_) {
+    throw std::out_of_range("trajectory frame " + std::to_string(frame) + " of " + std::to_string(frames_));
+  }
+
+  const auto it = std::upper_bound(chunks_.begin(), chunks_.end(), frame, [](std::size_t f, const ChunkInfo& c) { return f < c.first_frame; }) - 1;
+  const std::size_t index = static_cast<std::size_t>(it - chunks_.begin());
+
+  if (index != cached_chunk_) {
+    cached_chunk_ = static_cast<std::size_t>(-1);
+    cache_.resize(it->raw_size);
+
+    if (it->compression == static_cast<std::uint32_t>(Compression::kNone)) {
+      ReadAt(fd_, cache_.data(), it->raw_size, it->offset, path_);
+    } else if (it->compression == static_cast<std::uint32_t>(Compression::kZlib) && CompressionAvailable(Compression::kZlib)) {
+#ifdef PHYSICS_HAS_ZLIB
+      packed_.resize(it->stored_size + it->raw_size);
+      ReadAt(fd_, packed_.data(), it->stored_size, it->offset, path_);
+      char* shuffled = packed_.data() + it->stored_size;
+      uLongf size = static_cast<uLongf>(it->raw_size);
+      if (uncompress(reinterpret_cast<Bytef*>(shuffled), &size, reinterpret_cast<const Bytef*>(packed_.data()), static_cast<uLong>(it->stored_size)) !=
+              Z_OK ||
+          size != it->raw_size) {
+        throw std::runtime_error("corrupt trajectory chunk: " + path_);
+      }
+      Unshuffle(shuffled, it->raw_size, cache_.data());
+#endif
+    } else {
+      throw std::runtime_error("trajectory chunk uses unsupported compression: " + path_);
+    }
+    cached_chunk_ = index;
+  }
+
+  return cache_.data() + (frame - it->first_frame) * frame_size_;
+}
+
+std::uint64_t TrajectoryReader::Step(std::size_t frame) const {
+  return Get<std::uint64_t>(LoadFrame(frame));
+}
+
+double TrajectoryReader::Time(std::size_t frame) const {
+  return Get<double>(LoadFrame(frame) + sizeof(std::uint64_t));
+}
+
+void TrajectoryReader::ReadPositions(std::size_t frame, double* out) const {
+  const char* in = LoadFrame(frame) + 2 * sizeof(std::uint64_t);
+  for (std::size_t k = 0; k < 3 * bodies_; ++k) {
+    out[k] = Get<double>(in + k * sizeof(double));
+  }
+}
+
+void TrajectoryReader::ReadVelocities(std::size_t frame, double* out) const {
+  if (!velocities_) {
+    throw std::logic_error("trajectory has no velocities: " + path_);
+  }
+  const char* in = LoadFrame(frame) + 2 * sizeof(std::uint64_t) + 3 * bodies_ * sizeof(double);
+  for (std::size_t k = 0; k < 3 * bodies_; ++k) {
+    out[k] = Get<double>(in + k * sizeof(double));
+  }
+}
+
+}  // namespace physics::io
@@ -0,0 +1,30 @@
+#include "physics/parallel/simd.hpp"
+
+namespace physics::parallel {
+
+namespace {
+
+SimdIsa DetectOnce() {
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f") != 0) {
+    return SimdIsa::kAvx512;
+  }
+  if (__builtin_cpu_supports("avx2") != 0 && __builtin_cpu_supports("fma") != 0) {
+    return SimdIsa::kAvx2;
+  }
+  if (__builtin_cpu_supports("sse2") != 0) {
+    return SimdIsa::kSse2;
+  }
+#endif
+  return SimdIsa::kScalar;
+}
+
+}  // namespace
+
+SimdIsa DetectSimdIsa() {
+  static const SimdIsa kDetected = DetectOnce();
+  return kDetected;
+}
+
+}  // namespace physics::parallel
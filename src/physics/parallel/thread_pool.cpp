@@ -0,0 +1,183 @@
+#include "physics/parallel/thread_pool.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <utility>
+
+namespace physics::parallel {
+
+namespace {
+
+// Пул и номер потока, который сейчас выполняет кусок: вложенный ParallelFor на том же пуле выполняется на месте
+thread_local const ThreadPool* current_pool = nullptr;
+thread_local std::size_t current_thread = 0;
+
+}  // namespace
+
+std::size_t HardwareThreads() {
+  const unsigned hw = std::thread::hardware_concurrency();
+  return hw == 0 ? 1 : hw;
+}
+
+ThreadPool::ThreadPool(std::size_t threads) {
+  threads = std::max<std::size_t>(threads, 1);
+
+  queues_.reserve(threads);
+  for (std::size_t t = 0; t < threads; ++t) {
+    queues_.push_back(std::make_unique<Queue>());
+  }
+
+  workers_.reserve(threads - 1);
+  for (std::size_t t = 1; t < threads; ++t) {
+    workers_.emplace_back([this, t] { WorkerLoop(t); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+void ThreadPool::ParallelFor(std::size_t count, std::size_t grain, const RangeFn& fn) {
+  if (count == 0) {
+    return;
+  }
+
+  // Поток пула уже занят куском: ждать остальные потоки из него нельзя, поэтому весь диапазон - его
+  if (current_pool == this) {
+    fn(0, count, current_thread);
+    return;
+  }
+
+  grain = std::max<std::size_t>(grain, 1);
+  const std::size_t threads = Size();
+
+  // Кусков в несколько раз больше, чем потоков, чтобы было что красть
+  // Размер куска кратен grain: границы векторных пачек внутри куска не зависят от числа потоков
+  const std::size_t chunk = (count + 4 * threads * grain - 1) / (4 * threads * grain) * grain;
+  const std::size_t chunks = (count + chunk - 1) / chunk;
+
+  if (threads == 1 || chunks == 1) {
+    fn(0, count, 0);
+    return;
+  }
+
+  std::lock_guard<std::mutex> submit(submit_mutex_);
+
+  // Сначала задача и счетчик, потом куски: поток, который украдет кусок, должен видеть задачу
+  job_ = &fn;
+  pending_.store(chunks);
+
+  for (std::size_t c = 0; c < chunks; ++c) {
+    const std::size_t begin = c * chunk;
+    const std::size_t end = std::min(count, begin + chunk);
+
+    // Непрерывные блоки кусков достаются соседним потокам, чтобы данные оставались в их кешах
+    auto& queue = *queues_[c * threads / chunks];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.ranges.push_back({begin, end});
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++generation_;
+  }
+  wake_.notify_all();
+
+  RunRanges(0);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_.wait(lock, [this] { return pending_.load() == 0; });
+  job_ = nullptr;
+
+  if (failed_.load()) {
+    failed_.store(false);
+    std::rethrow_exception(std::exchange(error_, nullptr));
+  }
+}
+
+void ThreadPool::WorkerLoop(std::size_t thread) {
+  std::uint64_t seen = 0;
+
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+      if (stop_) {
+        return;
+      }
+      seen = generation_;
+    }
+
+    RunRanges(thread);
+  }
+}
+
+void ThreadPool::RunRanges(std::size_t thread) {
+  Range range{};
+
+  const ThreadPool* outer_pool = std::exchange(current_pool, this);
+  const std::size_t outer_thread = std::exchange(current_thread, thread);
+
+  while (Pop(thread, range) || Steal(thread, range)) {
+    // После первого исключения оставшиеся куски только снимаются с очереди, чтобы вызывающий дождался счетчика
+    if (!failed_.load()) {
+      try {
+        (*job_)(range.begin, range.end, thread);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!failed_.load()) {
+          error_ = std::current_exception();
+          failed_.store(true);
+        }
+      }
+    }
+
+    if (pending_.fetch_sub(1) == 1) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      done_.notify_all();
+    }
+  }
+
+  current_pool = outer_pool;
+  current_thread = outer_thread;
+}
+
+bool ThreadPool::Pop(std::size_t thread, Range& range) {
+  auto& queue = *queues_[thread];
+  std::lock_guard<std::mutex> lock(queue.mutex);
+
+  if (queue.ranges.empty()) {
+    return false;
+  }
+
+  range = queue.ranges.front();
+  queue.ranges.pop_front();
+  return true;
+}
+
+bool ThreadPool::Steal(std::size_t thread, Range& range) {
+  const std::size_t threads = Size();
+
+  for (std::size_t offset = 1; offset < threads; ++offset) {
+    auto& queue = *queues_[(thread + offset) % threads];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+
+    if (!queue.ranges.empty()) {
+      range = queue.ranges.back();
+      queue.ranges.pop_back();
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace physics::parallel
@@ -0,0 +1,575 @@
+#include "physics/simulator/ensemble.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include <physics/constants.hpp>
+#include <physics/simulator/elastic.hpp>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define PHYSICS_KERNEL_X86 1
+#include <immintrin.h>
+#endif
+
+// Файл собирается с -ffp-contract=off: векторные линии должны считать ровно те же операции, что и скалярный Simulator,
+// без слияния умножения со сложением в FMA
+
+namespace physics::simulator {
+
+namespace {
+
+// Компоненты ансамбля для ядра гравитации; элемент (тело i, копия r) - по индексу i * stride + r
+struct Lanes {
+  const double* x;
+  const double* y;
+  const double* z;
+  const double* mass;
+  double* ax;
+  double* ay;
+  double* az;
+  std::size_t stride;
+  std::size_t bodies;
+};
+
+// Попарная сумма с третьим законом Ньютона в порядке Simulator::ApplyGravityPairwise, по одной копии
+void GravityScalar(const Lanes& l, std::size_t begin, std::size_t end, double g, double eps2) {
+  for (std::size_t r = begin; r < end; ++r) {
+    for (std::size_t i = 0; i < l.bodies; ++i) {
+      const std::size_t a = i * l.stride + r;
+      const double xi = l.x[a];
+      const double yi = l.y[a];
+      const double zi = l.z[a];
+      const double gmi = g * l.mass[a];
+
+      double axi = 0.0;
+      double ayi = 0.0;
+      double azi = 0.0;
+
+      for (std::size_t j = i + 1; j < l.bodies; ++j) {
+        const std::size_t b = j * l.stride + r;
+        const double dx = l.x[b] - xi;
+        const double dy = l.y[b] - yi;
+        const double dz = l.z[b] - zi;
+        const double r2 = dx * dx + dy * dy + dz * dz;
+        if (r2 == 0.0) {
+          continue;
+        }
+
+        const double d2 = r2 + eps2;
+        const double inv_r3 = 1.0 / (d2 * std::sqrt(d2));
+        const double si = g * l.mass[b] * inv_r3;
+        const double sj = gmi * inv_r3;
+        axi += si * dx;
+        ayi += si * dy;
+        azi += si * dz;
+        l.ax[b] -= sj * dx;
+        l.ay[b] -= sj * dy;
+        l.az[b] -= sj * dz;
+      }
+
+      l.ax[a] += axi;
+      l.ay[a] += ayi;
+      l.az[a] += azi;
+    }
+  }
+}
+
+#ifdef PHYSICS_KERNEL_X86
+
+// Векторные ядра повторяют скалярное по линиям; пропуск пары с нулевым расстоянием - выбор по маске, а не сложение нуля,
+// чтобы не менять знак нулевых ускорений
+
+__attribute__((target("sse2"))) void GravitySse2(const Lanes& l, std::size_t begin, std::size_t end, double g, double eps2) {
+  const __m128d vg = _mm_set1_pd(g);
+  const __m128d veps2 = _mm_set1_pd(eps2);
+  const __m128d zero = _mm_setzero_pd();
+  const __m128d one = _mm_set1_pd(1.0);
+
+  for (std::size_t r = begin; r < end; r += 2) {
+    for (std::size_t i = 0; i < l.bodies; ++i) {
+      const std::size_t a = i * l.stride + r;
+      const __m128d pi[3] = {_mm_loadu_pd(l.x + a), _mm_loadu_pd(l.y + a), _mm_loadu_pd(l.z + a)};
+      const __m128d gmi = _mm_mul_pd(vg, _mm_loadu_pd(l.mass + a));
+      __m128d acc[3] = {zero, zero, zero};
+
+      for (std::size_t j = i + 1; j < l.bodies; ++j) {
+        const std::size_t b = j * l.stride + r;
+        const __m128d d[3] = {_mm_sub_pd(_mm_loadu_pd(l.x + b), pi[0]), _mm_sub_pd(_mm_loadu_pd(l.y + b), pi[1]),
+                              _mm_sub_pd(_mm_loadu_pd(l.z + b), pi[2])};
+        const __m128d r2 = _mm_add_pd(_mm_add_pd(_mm_mul_pd(d[0], d[0]), _mm_mul_pd(d[1], d[1])), _mm_mul_pd(d[2], d[2]));
+        const __m128d nonzero = _mm_cmpneq_pd(r2, zero);
+        const __m128d d2 = _mm_add_pd(r2, veps2);
+        const __m128d inv_r3 = _mm_div_pd(one, _mm_mul_pd(d2, _mm_sqrt_pd(d2)));
+        const __m128d si = _mm_mul_pd(_mm_mul_pd(vg, _mm_loadu_pd(l.mass + b)), inv_r3);
+        const __m128d sj = _mm_mul_pd(gmi, inv_r3);
+
+        double* out[3] = {l.ax + b, l.ay + b, l.az + b};
+        for (std::size_t k = 0; k < 3; ++k) {
+          // В SSE2 нет blendv, выбор по маске собирается из and/andnot/or
+          const __m128d next_i = _mm_add_pd(acc[k], _mm_mul_pd(si, d[k]));
+          acc[k] = _mm_or_pd(_mm_and_pd(nonzero, next_i), _mm_andnot_pd(nonzero, acc[k]));
+          const __m128d acc_j = _mm_loadu_pd(out[k]);
+          const __m128d next_j = _mm_sub_pd(acc_j, _mm_mul_pd(sj, d[k]));
+          _mm_storeu_pd(out[k], _mm_or_pd(_mm_and_pd(nonzero, next_j), _mm_andnot_pd(nonzero, acc_j)));
+        }
+      }
+
+      double* out[3] = {l.ax + a, l.ay + a, l.az + a};
+      for (std::size_t k = 0; k < 3; ++k) {
+        _mm_storeu_pd(out[k], _mm_add_pd(_mm_loadu_pd(out[k]), acc[k]));
+      }
+    }
+  }
+}
+
+__attribute__((target("avx2"))) void GravityAvx2(const Lanes& l, std::size_t begin, std::size_t end, double g, double eps2) {
+  const __m256d vg = _mm256_set1_pd(g);
+  const __m256d veps2 = _mm256_set1_pd(eps2);
+  const __m256d zero = _mm256_setzero_pd();
+  const __m256d one = _mm256_set1_pd(1.0);
+
+  for (std::size_t r = begin; r < end; r += 4) {
+    for (std::size_t i = 0; i < l.bodies; ++i) {
+      const std::size_t a = i * l.stride + r;
+      const __m256d pi[3] = {_mm256_loadu_pd(l.x + a), _mm256_loadu_pd(l.y + a), _mm256_loadu_pd(l.z + a)};
+      const __m256d gmi = _mm256_mul_pd(vg, _mm256_loadu_pd(l.mass + a));
+      __m256d acc[3] = {zero, zero, zero};
+
+      for (std::size_t j = i + 1; j < l.bodies; ++j) {
+        const std::size_t b = j * l.stride + r;
+        const __m256d d[3] = {_mm256_sub_pd(_mm256_loadu_pd(l.x + b), pi[0]), _mm256_sub_pd(_mm256_loadu_pd(l.y + b), pi[1]),
+                              _mm256_sub_pd(_mm256_loadu_pd(l.z + b), pi[2])};
+        const __m256d r2 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(d[0], d[0]), _mm256_mul_pd(d[1], d[1])), _mm256_mul_pd(d[2], d[2]));
+        const __m256d nonzero = _mm256_cmp_pd(r2, zero, _CMP_NEQ_OQ);
+        const __m256d d2 = _mm256_add_pd(r2, veps2);
+        const __m256d inv_r3 = _mm256_div_pd(one, _mm256_mul_pd(d2, _mm256_sqrt_pd(d2)));
+        const __m256d si = _mm256_mul_pd(_mm256_mul_pd(vg, _mm256_loadu_pd(l.mass + b)), inv_r3);
+        const __m256d sj = _mm256_mul_pd(gmi, inv_r3);
+
+        double* out[3] = {l.ax + b, l.ay + b, l.az + b};
+        for (std::size_t k = 0; k < 3; ++k) {
+          acc[k] = _mm256_blendv_pd(acc[k], _mm256_add_pd(acc[k], _mm256_mul_pd(si, d[k])), nonzero);
+          const __m256d acc_j = _mm256_loadu_pd(out[k]);
+          _mm256_storeu_pd(out[k], _mm256_blendv_pd(acc_j, _mm256_sub_pd(acc_j, _mm256_mul_pd(sj, d[k])), nonzero));
+        }
+      }
+
+      double* out[3] = {l.ax + a, l.ay + a, l.az + a};
+      for (std::size_t k = 0; k < 3; ++k) {
+        _mm256_storeu_pd(out[k], _mm256_add_pd(_mm256_loadu_pd(out[k]), acc[k]));
+      }
+    }
+  }
+}
+
+__attribute__((target("avx512f"))) void GravityAvx512(const Lanes& l, std::size_t begin, std::size_t end, double g, double eps2) {
+  const __m512d vg = _mm512_set1_pd(g);
+  const __m512d veps2 = _mm512_set1_pd(eps2);
+  const __m512d zero = _mm512_setzero_pd();
+  const __m512d one = _mm512_set1_pd(1.0);
+
+  for (std::size_t r = begin; r < end; r += 8) {
+    for (std::size_t i = 0; i < l.bodies; ++i) {
+      const std::size_t a = i * l.stride + r;
+      const __m512d pi[3] = {_mm512_loadu_pd(l.x + a), _mm512_loadu_pd(l.y + a), _mm512_loadu_pd(l.z + a)};
+      const __m512d gmi = _mm512_mul_pd(vg, _mm512_loadu_pd(l.mass + a));
+      __m512d acc[3] = {zero, zero, zero};
+
+      for (std::size_t j = i + 1; j < l.bodies; ++j) {
+        const std::size_t b = j * l.stride + r;
+        const __m512d d[3] = {_mm512_sub_pd(_mm512_loadu_pd(l.x + b), pi[0]), _mm512_sub_pd(_mm512_loadu_pd(l.y + b), pi[1]),
+                              _mm512_sub_pd(_mm512_loadu_pd(l.z + b), pi[2])};
+        const __m512d r2 = _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(d[0], d[0]), _mm512_mul_pd(d[1], d[1])), _mm512_mul_pd(d[2], d[2]));
+        const __mmask8 nonzero = _mm512_cmp_pd_mask(r2, zero, _CMP_NEQ_OQ);
+        const __m512d d2 = _mm512_add_pd(r2, veps2);
+        // maskz-форма с полной маской - та же инструкция, но без _mm512_undefined_pd, на который ругается GCC 12
+        const __m512d inv_r3 = _mm512_div_pd(one, _mm512_mul_pd(d2, _mm512_maskz_sqrt_pd(0xFF, d2)));
+        const __m512d si = _mm512_mul_pd(_mm512_mul_pd(vg, _mm512_loadu_pd(l.mass + b)), inv_r3);
+        const __m512d sj = _mm512_mul_pd(gmi, inv_r3);
+
+        double* out[3] = {l.ax + b, l.ay + b, l.az + b};
+        for (std::size_t k = 0; k < 3; ++k) {
+          acc[k] = _mm512_mask_add_pd(acc[k], nonzero, acc[k], _mm512_mul_pd(si, d[k]));
+          const __m512d acc_j = _mm512_loadu_pd(out[k]);
+          _mm512_storeu_pd(out[k], _mm512_mask_sub_pd(acc_j, nonzero, acc_j, _mm512_mul_pd(sj, d[k])));
+        }
+      }
+
+      double* out[3] = {l.ax + a, l.ay + a, l.az + a};
+      for (std::size_t k = 0; k < 3; ++k) {
+        _mm512_storeu_pd(out[k], _mm512_add_pd(_mm512_loadu_pd(out[k]), acc[k]));
+      }
+    }
+  }
+}
+
+#endif
+
+}  // namespace
+
+Ensemble::Ensemble(std::size_t replicas, const std::vector<object::Object>& objects, units::Length collision_distance)
+    : replicas_(replicas),
+      bodies_(objects.size()),
+      stride_((replicas + kLaneAlign - 1) / kLaneAlign * kLaneAlign),
+      collision_counts_(replicas, 0),
+      collision_distance_(collision_distance) {
+  for (auto* v : {&x_, &y_, &z_, &vx_, &vy_, &vz_, &ax_, &ay_, &az_, &mass_}) {
+    v->assign(bodies_ * stride_, 0.0);
+  }
+
+  for (std::size_t r = 0; r < replicas_; ++r) {
+    for (std::size_t i = 0; i < bodies_; ++i) {
+      Set(r, i, objects[i]);
+    }
+  }
+}
+
+void Ensemble::Set(std::size_t replica, std::size_t body, const object::Object& obj) {
+  const std::size_t k = Index(replica, body);
+  mass_[k] = obj.weight.value;
+  x_[k] = obj.position[0].value;
+  y_[k] = obj.position[1].value;
+  z_[k] = obj.position[2].value;
+  vx_[k] = obj.speed[0].value;
+  vy_[k] = obj.speed[1].value;
+  vz_[k] = obj.speed[2].value;
+  ax_[k] = obj.acceleration[0].value;
+  ay_[k] = obj.acceleration[1].value;
+  az_[k] = obj.acceleration[2].value;
+  accelerations_valid_ = false;
+}
+
+object::Object Ensemble::Get(std::size_t replica, std::size_t body) const {
+  const std::size_t k = Index(replica, body);
+  object::Object obj(units::Weight{mass_[k]});
+  obj.position = {units::Length{x_[k]}, units::Length{y_[k]}, units::Length{z_[k]}};
+  obj.speed = {units::Speed{vx_[k]}, units::Speed{vy_[k]}, units::Speed{vz_[k]}};
+  obj.acceleration = {units::Acceleration{ax_[k]}, units::Acceleration{ay_[k]}, units::Acceleration{az_[k]}};
+  return obj;
+}
+
+void Ensemble::SetPositions(const double* data) {
+  for (std::size_t r = 0; r < replicas_; ++r) {
+    for (std::size_t i = 0; i < bodies_; ++i) {
+      const double* p = data + 3 * (r * bodies_ + i);
+      x_[Index(r, i)] = p[0];
+      y_[Index(r, i)] = p[1];
+      z_[Index(r, i)] = p[2];
+    }
+  }
+  accelerations_valid_ = false;
+}
+
+void Ensemble::SetVelocities(const double* data) {
+  for (std::size_t r = 0; r < replicas_; ++r) {
+    for (std::size_t i = 0; i < bodies_; ++i) {
+      const double* v = data + 3 * (r * bodies_ + i);
+      vx_[Index(r, i)] = v[0];
+      vy_[Index(r, i)] = v[1];
+      vz_[Index(r, i)] = v[2];
+    }
+  }
+}
+
+void Ensemble::SetMasses(const double* data) {
+  for (std::size_t r = 0; r < replicas_; ++r) {
+    for (std::size_t i = 0; i < bodies_; ++i) {
+      mass_[Index(r, i)] = data[r * bodies_ + i];
+    }
+  }
+  accelerations_valid_ = false;
+}
+
+void Ensemble::GetPositions(double* out) const {
+  for (std::size_t r = 0; r < replicas_; ++r) {
+    for (std::size_t i = 0; i < bodies_; ++i) {
+      double* p = out + 3 * (r * bodies_ + i);
+      p[0] = x_[Index(r, i)];
+      p[1] = y_[Index(r, i)];
+      p[2] = z_[Index(r, i)];
+    }
+  }
+}
+
+void Ensemble::GetVelocities(double* out) const {
+  for (std::size_t r = 0; r < replicas_; ++r) {
+    for (std::size_t i = 0; i < bodies_; ++i) {
+      double* v = out + 3 * (r * bodies_ + i);
+      v[0] = vx_[Index(r, i)];
+      v[1] = vy_[Index(r, i)];
+      v[2] = vz_[Index(r, i)];
+    }
+  }
+}
+
+void Ensemble::GetMasses(double* out) const {
+  for (std::size_t r = 0; r < replicas_; ++r) {
+    for (std::size_t i = 0; i < bodies_; ++i) {
+      out[r * bodies_ + i] = mass_[Index(r, i)];
+    }
+  }
+}
+
+void Ensemble::SetKernelIsa(KernelIsa isa) {
+  kernel_isa_ = std::min(isa, DetectKernelIsa());
+}
+
+void Ensemble::SetThreads(std::size_t threads) {
+  if (threads == 0) {
+    threads = parallel::HardwareThreads();
+  }
+
+  if (threads == Threads()) {
+    return;
+  }
+
+  pool_ = threads > 1 ? std::make_shared<parallel::ThreadPool>(threads) : nullptr;
+}
+
+void Ensemble::ComputeAccelerations(std::size_t begin, std::size_t end) {
+  for (std::size_t i = 0; i < bodies_; ++i) {
+    const std::size_t row = i * stride_;
+    std::fill(ax_.begin() + row + begin, ax_.begin() + row + end, 0.0);
+    std::fill(ay_.begin() + row + begin, ay_.begin() + row + end, 0.0);
+    std::fill(az_.begin() + row + begin, az_.begin() + row + end, 0.0);
+  }
+
+  if (!use_gravity_) {
+    return;
+  }
+
+  const Lanes lanes{x_.data(), y_.data(), z_.data(), mass_.data(), ax_.data(), ay_.data(), az_.data(), stride_, bodies_};
+  const double g = constants::kG.value;
+  const double eps2 = softening_.value * softening_.value;
+
+  // Границы пачек кратны kLaneAlign, поэтому любая ширина регистра делит их без остатка
+  switch (kernel_isa_) {
+#ifdef PHYSICS_KERNEL_X86
+    case KernelIsa::kAvx512:
+      GravityAvx512(lanes, begin, end, g, eps2);
+      break;
+    case KernelIsa::kAvx2:
+      GravityAvx2(lanes, begin, end, g, eps2);
+      break;
+    case KernelIsa::kSse2:
+      GravitySse2(lanes, begin, end, g, eps2);
+      break;
+#endif
+    default:
+      GravityScalar(lanes, begin, end, g, eps2);
+      break;
+  }
+}
+
+void Ensemble::Kick(double h, std::size_t begin, std::size_t end) {
+  for (std::size_t i = 0; i < bodies_; ++i) {
+    for (std::size_t k = i * stride_ + begin; k < i * stride_ + end; ++k) {
+      vx_[k] += ax_[k] * h;
+      vy_[k] += ay_[k] * h;
+      vz_[k] += az_[k] * h;
+    }
+  }
+}
+
+void Ensemble::Drift(double h, std::size_t begin, std::size_t end) {
+  for (std::size_t i = 0; i < bodies_; ++i) {
+    for (std::size_t k = i * stride_ + begin; k < i * stride_ + end; ++k) {
+      x_[k] += vx_[k] * h;
+      y_[k] += vy_[k] * h;
+      z_[k] += vz_[k] * h;
+    }
+  }
+}
+
+void Ensemble::StepRungeKutta4(double h, std::size_t begin, std::size_t end) {
+  const std::size_t n = bodies_ * stride_;
+  double* state[6] = {x_.data(), y_.data(), z_.data(), vx_.data(), vy_.data(), vz_.data()};
+  const double* acc[3] = {ax_.data(), ay_.data(), az_.data()};
+
+  for (std::size_t c = 0; c < 6; ++c) {
+    for (std::size_t i = 0; i < bodies_; ++i) {
+      for (std::size_t k = i * stride_ + begin; k < i * stride_ + end; ++k) {
+        rk_state_[c * n + k] = state[c][k];
+        rk_sum_[c * n + k] = 0.0;
+      }
+    }
+  }
+
+  constexpr double kWeight[4] = {1.0, 2.0, 2.0, 1.0};
+  constexpr double kNext[3] = {0.5, 0.5, 1.0};
+
+  for (std::size_t stage = 0; stage < 4; ++stage) {
+    ComputeAccelerations(begin, end);
+
+    for (std::size_t c = 0; c < 3; ++c) {
+      double* pos = state[c];
+      double* vel = state[3 + c];
+      const double* a = acc[c];
+      const double* pos0 = rk_state_.data() + c * n;
+      const double* vel0 = rk_state_.data() + (3 + c) * n;
+      double* sum_pos = rk_sum_.data() + c * n;
+      double* sum_vel = rk_sum_.data() + (3 + c) * n;
+
+      for (std::size_t i = 0; i < bodies_; ++i) {
+        for (std::size_t k = i * stride_ + begin; k < i * stride_ + end; ++k) {
+          sum_pos[k] += kWeight[stage] * vel[k];
+          sum_vel[k] += kWeight[stage] * a[k];
+
+          if (stage < 3) {
+            const double t = kNext[stage] * h;
+            pos[k] = pos0[k] + t * vel[k];
+            vel[k] = vel0[k] + t * a[k];
+          } else {
+            pos[k] = pos0[k] + h / 6.0 * sum_pos[k];
+            vel[k] = vel0[k] + h / 6.0 * sum_vel[k];
+          }
+        }
+      }
+    }
+  }
+}
+
+bool Ensemble::HandleCollisions(std::size_t begin, std::size_t end) {
+  const double distance = collision_distance_.value;
+  const double dist2 = distance * distance;
+  end = std::min(end, replicas_);
+  bool changed = false;
+
+  // Для каждой копии пары идут в порядке перебора, как в Simulator::HandleCollisions
+  for (std::size_t i = 0; i < bodies_; ++i) {
+    for (std::size_t j = i + 1; j < bodies_; ++j) {
+      for (std::size_t r = begin; r < end; ++r) {
+        const std::size_t a = Index(r, i);
+        const std::size_t b = Index(r, j);
+        const double dx = x_[b] - x_[a];
+        const double dy = y_[b] - y_[a];
+        const double dz = z_[b] - z_[a];
+        if (dx * dx + dy * dy + dz * dz > dist2) {
+          continue;
+        }
+
+        double pa[3] = {x_[a], y_[a], z_[a]};
+        double va[3] = {vx_[a], vy_[a], vz_[a]};
+        double pb[3] = {x_[b], y_[b], z_[b]};
+        double vb[3] = {vx_[b], vy_[b], vz_[b]};
+        if (!ResolveElastic(pa, va, mass_[a], pb, vb, mass_[b], distance)) {
+          continue;
+        }
+
+        x_[a] = pa[0];
+        y_[a] = pa[1];
+        z_[a] = pa[2];
+        vx_[a] = va[0];
+        vy_[a] = va[1];
+        vz_[a] = va[2];
+        x_[b] = pb[0];
+        y_[b] = pb[1];
+        z_[b] = pb[2];
+        vx_[b] = vb[0];
+        vy_[b] = vb[1];
+        vz_[b] = vb[2];
+        ++collision_counts_[r];
+        changed = true;
+      }
+    }
+  }
+  return changed;
+}
+
+void Ensemble::StepBlock(double h, std::size_t block) {
+  const std::size_t begin = block * kLaneAlign;
+  const std::size_t end = begin + kLaneAlign;
+
+  switch (integrator_) {
+    case Integrator::kSemiImplicitEuler:
+      ComputeAccelerations(begin, end);
+      for (std::size_t i = 0; i < bodies_; ++i) {
+        for (std::size_t k = i * stride_ + begin; k < i * stride_ + end; ++k) {
+          vx_[k] += ax_[k] * h;
+          x_[k] += vx_[k] * h;
+          vy_[k] += ay_[k] * h;
+          y_[k] += vy_[k] * h;
+          vz_[k] += az_[k] * h;
+          z_[k] += vz_[k] * h;
+        }
+      }
+      break;
+
+    case Integrator::kVelocityVerlet:
+      if (!accelerations_valid_ || block_valid_[block] == 0) {
+        ComputeAccelerations(begin, end);
+      }
+      Kick(0.5 * h, begin, end);
+      Drift(h, begin, end);
+      ComputeAccelerations(begin, end);
+      Kick(0.5 * h, begin, end);
+      break;
+
+    case Integrator::kLeapfrog:
+      Drift(0.5 * h, begin, end);
+      ComputeAccelerations(begin, end);
+      Kick(h, begin, end);
+      Drift(0.5 * h, begin, end);
+      break;
+
+    case Integrator::kYoshida4: {
+      static const double kW1 = 1.0 / (2.0 - std::cbrt(2.0));
+      static const double kW0 = -std::cbrt(2.0) * kW1;
+      const double drift[4] = {0.5 * kW1, 0.5 * (kW0 + kW1), 0.5 * (kW0 + kW1), 0.5 * kW1};
+      const double kick[3] = {kW1, kW0, kW1};
+
+      for (std::size_t k = 0; k < 3; ++k) {
+        Drift(drift[k] * h, begin, end);
+        ComputeAccelerations(begin, end);
+        Kick(kick[k] * h, begin, end);
+      }
+      Drift(drift[3] * h, begin, end);
+      break;
+    }
+
+    case Integrator::kRungeKutta4:
+      StepRungeKutta4(h, begin, end);
+      break;
+  }
+
+  // Удар сдвигает тела, и ускорения конца шага для них уже неверны
+  const bool changed = HandleCollisions(begin, end);
+  block_valid_[block] = integrator_ == Integrator::kVelocityVerlet && !changed ? 1 : 0;
+}
+
+void Ensemble::Step(units::Time dt) {
+  const double h = dt.value;
+
+  if (integrator_ == Integrator::kRungeKutta4) {
+    rk_state_.resize(6 * bodies_ * stride_);
+    rk_sum_.resize(6 * bodies_ * stride_);
+  }
+
+  const std::size_t blocks = stride_ / kLaneAlign;
+  block_valid_.resize(blocks, 0);
+
+  auto step_blocks = [&](std::size_t begin, std::size_t end, std::size_t) {
+    for (std::size_t block = begin; block < end; ++block) {
+      StepBlock(h, block);
+    }
+  };
+  if (pool_) {
+    pool_->ParallelFor(blocks, 1, step_blocks);
+  } else if (blocks > 0) {
+    step_blocks(0, blocks, 0);
+  }
+  accelerations_valid_ = true;
+
+  ++step_count_;
+  elapsed_time_ = elapsed_time_ + dt;
+}
+
+void Ensemble::Run(std::size_t steps, units::Time dt) {
+  for (std::size_t step = 0; step < steps; ++step) {
+    Step(dt);
+  }
+}
+
+}  // namespace physics::simulator
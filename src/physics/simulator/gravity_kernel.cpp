@@ -0,0 +1,537 @@
+#include "physics/simulator/gravity_kernel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+#include <physics/constants.hpp>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define PHYSICS_KERNEL_X86 1
+#include <immintrin.h>
+#endif
+
+namespace physics::simulator {
+
+namespace {
+
+// Скалярное ядро, оно же обрабатывает хвост целей, не влезший в векторный регистр
+// С kPotential ядра заодно копят sum m_j / r: w * d2 = m_j / sqrt(d2), это одно умножение со сложением на пару
+template <bool kPotential>
+void KernelScalar(const GravitySources& s, const GravityTargets& t, std::size_t begin, double g, double eps2) {
+  for (std::size_t i = begin; i < t.count; ++i) {
+    const double xi = t.x[i];
+    const double yi = t.y[i];
+    const double zi = t.z[i];
+
+    double axi = 0.0;
+    double ayi = 0.0;
+    double azi = 0.0;
+    double pot = 0.0;
+
+    for (std::size_t j = 0; j < s.count; ++j) {
+      const double dx = s.x[j] - xi;
+      const double dy = s.y[j] - yi;
+      const double dz = s.z[j] - zi;
+      const double r2 = dx * dx + dy * dy + dz * dz;
+      if (r2 == 0.0) {
+        continue;
+      }
+
+      const double d2 = r2 + eps2;
+      const double w = s.mass[j] / (d2 * std::sqrt(d2));
+      axi += w * dx;
+      ayi += w * dy;
+      azi += w * dz;
+      if constexpr (kPotential) {
+        pot += w * d2;
+      }
+    }
+
+    t.ax[i] += g * axi;
+    t.ay[i] += g * ayi;
+    t.az[i] += g * azi;
+    if constexpr (kPotential) {
+      t.potential[i] -= g * pot;
+    }
+  }
+}
+
+// Скалярное ядро для float; Acc - тип накопителя суммы по источникам
+template <typename Acc, bool kPotential>
+void KernelScalarFloat(const BasicGravitySources<float>& s, const BasicGravityTargets<float>& t, std::size_t begin, double g, float eps2) {
+  for (std::size_t i = begin; i < t.count; ++i) {
+    const float xi = t.x[i];
+    const float yi = t.y[i];
+    const float zi = t.z[i];
+
+    Acc axi = 0;
+    Acc ayi = 0;
+    Acc azi = 0;
+    Acc pot = 0;
+
+    for (std::size_t j = 0; j < s.count; ++j) {
+      const float dx = s.x[j] - xi;
+      const float dy = s.y[j] - yi;
+      const float dz = s.z[j] - zi;
+      const float r2 = dx * dx + dy * dy + dz * dz;
+      if (r2 == 0.0F) {
+        continue;
+      }
+
+      const float d2 = r2 + eps2;
+      const float w = s.mass[j] / (d2 * std::sqrt(d2));
+      axi += w * dx;
+      ayi += w * dy;
+      azi += w * dz;
+      if constexpr (kPotential) {
+        pot += w * d2;
+      }
+    }
+
+    t.ax[i] += static_cast<float>(g * axi);
+    t.ay[i] += static_cast<float>(g * ayi);
+    t.az[i] += static_cast<float>(g * azi);
+    if constexpr (kPotential) {
+      t.potential[i] -= static_cast<float>(g * pot);
+    }
+  }
+}
+
+#ifdef PHYSICS_KERNEL_X86
+
+template <bool kPotential>
+__attribute__((target("sse2"))) std::size_t KernelSse2(const GravitySources& s, const GravityTargets& t, double g, double eps2) {
+  const __m128d zero = _mm_setzero_pd();
+  const __m128d veps2 = _mm_set1_pd(eps2);
+  const __m128d vg = _mm_set1_pd(g);
+
+  std::size_t i = 0;
+  for (; i + 2 <= t.count; i += 2) {
+    const __m128d xi = _mm_loadu_pd(t.x + i);
+    const __m128d yi = _mm_loadu_pd(t.y + i);
+    const __m128d zi = _mm_loadu_pd(t.z + i);
+
+    __m128d axi = zero;
+    __m128d ayi = zero;
+    __m128d azi = zero;
+    __m128d pot = zero;
+
+    for (std::size_t j = 0; j < s.count; ++j) {
+      const __m128d dx = _mm_sub_pd(_mm_set1_pd(s.x[j]), xi);
+      const __m128d dy = _mm_sub_pd(_mm_set1_pd(s.y[j]), yi);
+      const __m128d dz = _mm_sub_pd(_mm_set1_pd(s.z[j]), zi);
+      const __m128d r2 = _mm_add_pd(_mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy)), _mm_mul_pd(dz, dz));
+      const __m128d d2 = _mm_add_pd(r2, veps2);
+
+      __m128d w = _mm_div_pd(_mm_set1_pd(s.mass[j]), _mm_mul_pd(d2, _mm_sqrt_pd(d2)));
+      w = _mm_and_pd(w, _mm_cmpneq_pd(r2, zero));
+
+      axi = _mm_add_pd(axi, _mm_mul_pd(w, dx));
+      ayi = _mm_add_pd(ayi, _mm_mul_pd(w, dy));
+      azi = _mm_add_pd(azi, _mm_mul_pd(w, dz));
+      if constexpr (kPotential) {
+        pot = _mm_add_pd(pot, _mm_mul_pd(w, d2));
+      }
+    }
+
+    _mm_storeu_pd(t.ax + i, _mm_add_pd(_mm_loadu_pd(t.ax + i), _mm_mul_pd(vg, axi)));
+    _mm_storeu_pd(t.ay + i, _mm_add_pd(_mm_loadu_pd(t.ay + i), _mm_mul_pd(vg, ayi)));
+    _mm_storeu_pd(t.az + i, _mm_add_pd(_mm_loadu_pd(t.az + i), _mm_mul_pd(vg, azi)));
+    if constexpr (kPotential) {
+      _mm_storeu_pd(t.potential + i, _mm_sub_pd(_mm_loadu_pd(t.potential + i), _mm_mul_pd(vg, pot)));
+    }
+  }
+  return i;
+}
+
+template <bool kPotential>
+__attribute__((target("avx2,fma"))) std::size_t KernelAvx2(const GravitySources& s, const GravityTargets& t, double g, double eps2) {
+  const __m256d zero = _mm256_setzero_pd();
+  const __m256d veps2 = _mm256_set1_pd(eps2);
+  const __m256d vg = _mm256_set1_pd(g);
+
+  std::size_t i = 0;
+  for (; i + 4 <= t.count; i += 4) {
+    const __m256d xi = _mm256_loadu_pd(t.x + i);
+    const __m256d yi = _mm256_loadu_pd(t.y + i);
+    const __m256d zi = _mm256_loadu_pd(t.z + i);
+
+    __m256d axi = zero;
+    __m256d ayi = zero;
+    __m256d azi = zero;
+    __m256d pot = zero;
+
+    for (std::size_t j = 0; j < s.count; ++j) {
+      const __m256d dx = _mm256_sub_pd(_mm256_set1_pd(s.x[j]), xi);
+      const __m256d dy = _mm256_sub_pd(_mm256_set1_pd(s.y[j]), yi);
+      const __m256d dz = _mm256_sub_pd(_mm256_set1_pd(s.z[j]), zi);
+      const __m256d r2 = _mm256_fmadd_pd(dx, dx, _mm256_fmadd_pd(dy, dy, _mm256_mul_pd(dz, dz)));
+      const __m256d d2 = _mm256_add_pd(r2, veps2);
+
+      __m256d w = _mm256_div_pd(_mm256_set1_pd(s.mass[j]), _mm256_mul_pd(d2, _mm256_sqrt_pd(d2)));
+      w = _mm256_and_pd(w, _mm256_cmp_pd(r2, zero, _CMP_NEQ_OQ));
+
+      axi = _mm256_fmadd_pd(w, dx, axi);
+      ayi = _mm256_fmadd_pd(w, dy, ayi);
+      azi = _mm256_fmadd_pd(w, dz, azi);
+      if constexpr (kPotential) {
+        pot = _mm256_fmadd_pd(w, d2, pot);
+      }
+    }
+
+    _mm256_storeu_pd(t.ax + i, _mm256_fmadd_pd(vg, axi, _mm256_loadu_pd(t.ax + i)));
+    _mm256_storeu_pd(t.ay + i, _mm256_fmadd_pd(vg, ayi, _mm256_loadu_pd(t.ay + i)));
+    _mm256_storeu_pd(t.az + i, _mm256_fmadd_pd(vg, azi, _mm256_loadu_pd(t.az + i)));
+    if constexpr (kPotential) {
+      _mm256_storeu_pd(t.potential + i, _mm256_fnmadd_pd(vg, pot, _mm256_loadu_pd(t.potential + i)));
+    }
+  }
+  return i;
+}
+
+template <bool kPotential>
+__attribute__((target("avx512f"))) std::size_t KernelAvx512(const GravitySources& s, const GravityTargets& t, double g, double eps2) {
+  const __m512d zero = _mm512_setzero_pd();
+  const __m512d veps2 = _mm512_set1_pd(eps2);
+  const __m512d vg = _mm512_set1_pd(g);
+  const __m512d half = _mm512_set1_pd(0.5);
+  const __m512d three_halves = _mm512_set1_pd(1.5);
+
+  std::size_t i = 0;
+  for (; i + 8 <= t.count; i += 8) {
+    const __m512d xi = _mm512_loadu_pd(t.x + i);
+    const __m512d yi = _mm512_loadu_pd(t.y + i);
+    const __m512d zi = _mm512_loadu_pd(t.z + i);
+
+    __m512d axi = zero;
+    __m512d ayi = zero;
+    __m512d azi = zero;
+    __m512d pot = zero;
+
+    for (std::size_t j = 0; j < s.count; ++j) {
+      const __m512d dx = _mm512_sub_pd(_mm512_set1_pd(s.x[j]), xi);
+      const __m512d dy = _mm512_sub_pd(_mm512_set1_pd(s.y[j]), yi);
+      const __m512d dz = _mm512_sub_pd(_mm512_set1_pd(s.z[j]), zi);
+      const __m512d r2 = _mm512_fmadd_pd(dx, dx, _mm512_fmadd_pd(dy, dy, _mm512_mul_pd(dz, dz)));
+      const __m512d d2 = _mm512_add_pd(r2, veps2);
+
+      // 1/sqrt(d2): 14-битное приближение и две итерации Ньютона дают почти полную точность double
+      // maskz-форма с полной маской - та же инструкция, но без _mm512_undefined_pd, на который ругается -Wmaybe-uninitialized GCC 12
+      __m512d y = _mm512_maskz_rsqrt14_pd(0xFF, d2);
+      const __m512d h = _mm512_mul_pd(half, d2);
+      y = _mm512_mul_pd(y, _mm512_fnmadd_pd(h, _mm512_mul_pd(y, y), three_halves));
+      y = _mm512_mul_pd(y, _mm512_fnmadd_pd(h, _mm512_mul_pd(y, y), three_halves));
+
+      const __mmask8 nonzero = _mm512_cmp_pd_mask(r2, zero, _CMP_NEQ_OQ);
+      const __m512d w = _mm512_maskz_mul_pd(nonzero, _mm512_mul_pd(_mm512_set1_pd(s.mass[j]), y), _mm512_mul_pd(y, y));
+
+      axi = _mm512_fmadd_pd(w, dx, axi);
+      ayi = _mm512_fmadd_pd(w, dy, ayi);
+      azi = _mm512_fmadd_pd(w, dz, azi);
+      if constexpr (kPotential) {
+        pot = _mm512_fmadd_pd(w, d2, pot);
+      }
+    }
+
+    _mm512_storeu_pd(t.ax + i, _mm512_fmadd_pd(vg, axi, _mm512_loadu_pd(t.ax + i)));
+    _mm512_storeu_pd(t.ay + i, _mm512_fmadd_pd(vg, ayi, _mm512_loadu_pd(t.ay + i)));
+    _mm512_storeu_pd(t.az + i, _mm512_fmadd_pd(vg, azi, _mm512_loadu_pd(t.az + i)));
+    if constexpr (kPotential) {
+      _mm512_storeu_pd(t.potential + i, _mm512_fnmadd_pd(vg, pot, _mm512_loadu_pd(t.potential + i)));
+    }
+  }
+  return i;
+}
+
+// Ядра для float: 1/sqrt - аппаратное приближение и одна итерация Ньютона, этого хватает на всю мантиссу float
+// С kDoubleAcc вклады источников переводятся в double перед сложением, половины регистра копятся раздельно
+// Потенциал для диагностики копится во float: его точности хватает для слежения за дрейфом энергии
+
+template <bool kDoubleAcc, bool kPotential>
+__attribute__((target("sse2"))) std::size_t KernelSse2Float(const BasicGravitySources<float>& s, const BasicGravityTargets<float>& t, double g, float eps2) {
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 veps2 = _mm_set1_ps(eps2);
+  const __m128 half = _mm_set1_ps(0.5F);
+  const __m128 three_halves = _mm_set1_ps(1.5F);
+
+  std::size_t i = 0;
+  for (; i + 4 <= t.count; i += 4) {
+    const __m128 xi = _mm_loadu_ps(t.x + i);
+    const __m128 yi = _mm_loadu_ps(t.y + i);
+    const __m128 zi = _mm_loadu_ps(t.z + i);
+
+    __m128 acc[3] = {zero, zero, zero};
+    __m128 pot = zero;
+    __m128d lo[3] = {_mm_setzero_pd(), _mm_setzero_pd(), _mm_setzero_pd()};
+    __m128d hi[3] = {_mm_setzero_pd(), _mm_setzero_pd(), _mm_setzero_pd()};
+
+    for (std::size_t j = 0; j < s.count; ++j) {
+      const __m128 d[3] = {_mm_sub_ps(_mm_set1_ps(s.x[j]), xi), _mm_sub_ps(_mm_set1_ps(s.y[j]), yi), _mm_sub_ps(_mm_set1_ps(s.z[j]), zi)};
+      const __m128 r2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(d[0], d[0]), _mm_mul_ps(d[1], d[1])), _mm_mul_ps(d[2], d[2]));
+      const __m128 d2 = _mm_add_ps(r2, veps2);
+
+      __m128 y = _mm_rsqrt_ps(d2);
+      y = _mm_mul_ps(y, _mm_sub_ps(three_halves, _mm_mul_ps(_mm_mul_ps(half, d2), _mm_mul_ps(y, y))));
+      __m128 w = _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(s.mass[j]), y), _mm_mul_ps(y, y));
+      w = _mm_and_ps(w, _mm_cmpneq_ps(r2, zero));
+      if constexpr (kPotential) {
+        pot = _mm_add_ps(pot, _mm_mul_ps(w, d2));
+      }
+
+      for (std::size_t k = 0; k < 3; ++k) {
+        const __m128 f = _mm_mul_ps(w, d[k]);
+        if constexpr (kDoubleAcc) {
+          lo[k] = _mm_add_pd(lo[k], _mm_cvtps_pd(f));
+          hi[k] = _mm_add_pd(hi[k], _mm_cvtps_pd(_mm_movehl_ps(f, f)));
+        } else {
+          acc[k] = _mm_add_ps(acc[k], f);
+        }
+      }
+    }
+
+    float* out[3] = {t.ax + i, t.ay + i, t.az + i};
+    for (std::size_t k = 0; k < 3; ++k) {
+      __m128 sum;
+      if constexpr (kDoubleAcc) {
+        const __m128d vg = _mm_set1_pd(g);
+        sum = _mm_movelh_ps(_mm_cvtpd_ps(_mm_mul_pd(vg, lo[k])), _mm_cvtpd_ps(_mm_mul_pd(vg, hi[k])));
+      } else {
+        sum = _mm_mul_ps(_mm_set1_ps(static_cast<float>(g)), acc[k]);
+      }
+      _mm_storeu_ps(out[k], _mm_add_ps(_mm_loadu_ps(out[k]), sum));
+    }
+    if constexpr (kPotential) {
+      const __m128 vg = _mm_set1_ps(static_cast<float>(g));
+      _mm_storeu_ps(t.potential + i, _mm_sub_ps(_mm_loadu_ps(t.potential + i), _mm_mul_ps(vg, pot)));
+    }
+  }
+  return i;
+}
+
+template <bool kDoubleAcc, bool kPotential>
+__attribute__((target("avx2,fma"))) std::size_t KernelAvx2Float(const BasicGravitySources<float>& s, const BasicGravityTargets<float>& t, double g,
+                                                               float eps2) {
+  const __m256 zero = _mm256_setzero_ps();
+  const __m256 veps2 = _mm256_set1_ps(eps2);
+  const __m256 half = _mm256_set1_ps(0.5F);
+  const __m256 three_halves = _mm256_set1_ps(1.5F);
+
+  std::size_t i = 0;
+  for (; i + 8 <= t.count; i += 8) {
+    const __m256 xi = _mm256_loadu_ps(t.x + i);
+    const __m256 yi = _mm256_loadu_ps(t.y + i);
+    const __m256 zi = _mm256_loadu_ps(t.z + i);
+
+    __m256 acc[3] = {zero, zero, zero};
+    __m256 pot = zero;
+    __m256d lo[3] = {_mm256_setzero_pd(), _mm256_setzero_pd(), _mm256_setzero_pd()};
+    __m256d hi[3] = {_mm256_setzero_pd(), _mm256_setzero_pd(), _mm256_setzero_pd()};
+
+    for (std::size_t j = 0; j < s.count; ++j) {
+      const __m256 d[3] = {_mm256_sub_ps(_mm256_set1_ps(s.x[j]), xi), _mm256_sub_ps(_mm256_set1_ps(s.y[j]), yi),
+                           _mm256_sub_ps(_mm256_set1_ps(s.z[j]), zi)};
+      const __m256 r2 = _mm256_fmadd_ps(d[0], d[0], _mm256_fmadd_ps(d[1], d[1], _mm256_mul_ps(d[2], d[2])));
+      const __m256 d2 = _mm256_add_ps(r2, veps2);
+
+      __m256 y = _mm256_rsqrt_ps(d2);
+      y = _mm256_mul_ps(y, _mm256_fnmadd_ps(_mm256_mul_ps(half, d2), _mm256_mul_ps(y, y), three_halves));
+      __m256 w = _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(s.mass[j]), y), _mm256_mul_ps(y, y));
+      w = _mm256_and_ps(w, _mm256_cmp_ps(r2, zero, _CMP_NEQ_OQ));
+      if constexpr (kPotential) {
+        pot = _mm256_fmadd_ps(w, d2, pot);
+      }
+
+      for (std::size_t k = 0; k < 3; ++k) {
+        if constexpr (kDoubleAcc) {
+          const __m256 f = _mm256_mul_ps(w, d[k]);
+          lo[k] = _mm256_add_pd(lo[k], _mm256_cvtps_pd(_mm256_castps256_ps128(f)));
+          hi[k] = _mm256_add_pd(hi[k], _mm256_cvtps_pd(_mm256_extractf128_ps(f, 1)));
+        } else {
+          acc[k] = _mm256_fmadd_ps(w, d[k], acc[k]);
+        }
+      }
+    }
+
+    float* out[3] = {t.ax + i, t.ay + i, t.az + i};
+    for (std::size_t k = 0; k < 3; ++k) {
+      __m256 sum;
+      if constexpr (kDoubleAcc) {
+        const __m256d vg = _mm256_set1_pd(g);
+        sum = _mm256_set_m128(_mm256_cvtpd_ps(_mm256_mul_pd(vg, hi[k])), _mm256_cvtpd_ps(_mm256_mul_pd(vg, lo[k])));
+      } else {
+        sum = _mm256_mul_ps(_mm256_set1_ps(static_cast<float>(g)), acc[k]);
+      }
+      _mm256_storeu_ps(out[k], _mm256_add_ps(_mm256_loadu_ps(out[k]), sum));
+    }
+    if constexpr (kPotential) {
+      const __m256 vg = _mm256_set1_ps(static_cast<float>(g));
+      _mm256_storeu_ps(t.potential + i, _mm256_fnmadd_ps(vg, pot, _mm256_loadu_ps(t.potential + i)));
+    }
+  }
+  return i;
+}
+
+template <bool kDoubleAcc, bool kPotential>
+__attribute__((target("avx512f"))) std::size_t KernelAvx512Float(const BasicGravitySources<float>& s, const BasicGravityTargets<float>& t, double g,
+                                                                 float eps2) {
+  const __m512 zero = _mm512_setzero_ps();
+  const __m512 veps2 = _mm512_set1_ps(eps2);
+  const __m512 half = _mm512_set1_ps(0.5F);
+  const __m512 three_halves = _mm512_set1_ps(1.5F);
+
+  std::size_t i = 0;
+  for (; i + 16 <= t.count; i += 16) {
+    const __m512 xi = _mm512_loadu_ps(t.x + i);
+    const __m512 yi = _mm512_loadu_ps(t.y + i);
+    const __m512 zi = _mm512_loadu_ps(t.z + i);
+
+    __m512 acc[3] = {zero, zero, zero};
+    __m512 pot = zero;
+    __m512d lo[3] = {_mm512_setzero_pd(), _mm512_setzero_pd(), _mm512_setzero_pd()};
+    __m512d hi[3] = {_mm512_setzero_pd(), _mm512_setzero_pd(), _mm512_setzero_pd()};
+
+    for (std::size_t j = 0; j < s.count; ++j) {
+      const __m512 d[3] = {_mm512_sub_ps(_mm512_set1_ps(s.x[j]), xi), _mm512_sub_ps(_mm512_set1_ps(s.y[j]), yi),
+                           _mm512_sub_ps(_mm512_set1_ps(s.z[j]), zi)};
+      const __m512 r2 = _mm512_fmadd_ps(d[0], d[0], _mm512_fmadd_ps(d[1], d[1], _mm512_mul_ps(d[2], d[2])));
+      const __m512 d2 = _mm512_add_ps(r2, veps2);
+
+      // Как и в KernelAvx512, здесь и ниже maskz-формы с полной маской вместо форм с _mm512_undefined_*
+      __m512 y = _mm512_maskz_rsqrt14_ps(0xFFFF, d2);
+      y = _mm512_mul_ps(y, _mm512_fnmadd_ps(_mm512_mul_ps(half, d2), _mm512_mul_ps(y, y), three_halves));
+
+      const __mmask16 nonzero = _mm512_cmp_ps_mask(r2, zero, _CMP_NEQ_OQ);
+      const __m512 w = _mm512_maskz_mul_ps(nonzero, _mm512_mul_ps(_mm512_set1_ps(s.mass[j]), y), _mm512_mul_ps(y, y));
+      if constexpr (kPotential) {
+        pot = _mm512_fmadd_ps(w, d2, pot);
+      }
+
+      for (std::size_t k = 0; k < 3; ++k) {
+        if constexpr (kDoubleAcc) {
+          const __m512 f = _mm512_mul_ps(w, d[k]);
+          // Половины регистра переводим в double только средствами AVX-512F, без DQ
+          lo[k] = _mm512_add_pd(lo[k], _mm512_maskz_cvtps_pd(0xFF, _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xFF, _mm512_castps_pd(f), 0))));
+          hi[k] = _mm512_add_pd(hi[k], _mm512_maskz_cvtps_pd(0xFF, _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xFF, _mm512_castps_pd(f), 1))));
+        } else {
+          acc[k] = _mm512_fmadd_ps(w, d[k], acc[k]);
+        }
+      }
+    }
+
+    float* out[3] = {t.ax + i, t.ay + i, t.az + i};
+    for (std::size_t k = 0; k < 3; ++k) {
+      __m512 sum;
+      if constexpr (kDoubleAcc) {
+        const __m512d vg = _mm512_set1_pd(g);
+        const __m256 sum_lo = _mm512_maskz_cvtpd_ps(0xFF, _mm512_mul_pd(vg, lo[k]));
+        const __m256 sum_hi = _mm512_maskz_cvtpd_ps(0xFF, _mm512_mul_pd(vg, hi[k]));
+        sum = _mm512_castpd_ps(_mm512_maskz_insertf64x4(0xFF, _mm512_castps_pd(_mm512_castps256_ps512(sum_lo)), _mm256_castps_pd(sum_hi), 1));
+      } else {
+        sum = _mm512_mul_ps(_mm512_set1_ps(static_cast<float>(g)), acc[k]);
+      }
+      _mm512_storeu_ps(out[k], _mm512_add_ps(_mm512_loadu_ps(out[k]), sum));
+    }
+    if constexpr (kPotential) {
+      const __m512 vg = _mm512_set1_ps(static_cast<float>(g));
+      _mm512_storeu_ps(t.potential + i, _mm512_fnmadd_ps(vg, pot, _mm512_loadu_ps(t.potential + i)));
+    }
+  }
+  return i;
+}
+
+#endif
+
+}  // namespace
+
+KernelIsa DetectKernelIsa() {
+  return parallel::DetectSimdIsa();
+}
+
+namespace {
+
+template <bool kPotential>
+void Dispatch(KernelIsa isa, const GravitySources& sources, const GravityTargets& targets, double g, double eps2) {
+  std::size_t done = 0;
+  switch (isa) {
+#ifdef PHYSICS_KERNEL_X86
+    case KernelIsa::kAvx512:
+      done = KernelAvx512<kPotential>(sources, targets, g, eps2);
+      break;
+    case KernelIsa::kAvx2:
+      done = KernelAvx2<kPotential>(sources, targets, g, eps2);
+      break;
+    case KernelIsa::kSse2:
+      done = KernelSse2<kPotential>(sources, targets, g, eps2);
+      break;
+#endif
+    default:
+      break;
+  }
+
+  KernelScalar<kPotential>(sources, targets, done, g, eps2);
+}
+
+template <bool kDoubleAcc, bool kPotential>
+void DispatchFloat(KernelIsa isa, const BasicGravitySources<float>& sources, const BasicGravityTargets<float>& targets, double g, float eps2) {
+  std::size_t done = 0;
+  switch (isa) {
+#ifdef PHYSICS_KERNEL_X86
+    case KernelIsa::kAvx512:
+      done = KernelAvx512Float<kDoubleAcc, kPotential>(sources, targets, g, eps2);
+      break;
+    case KernelIsa::kAvx2:
+      done = KernelAvx2Float<kDoubleAcc, kPotential>(sources, targets, g, eps2);
+      break;
+    case KernelIsa::kSse2:
+      done = KernelSse2Float<kDoubleAcc, kPotential>(sources, targets, g, eps2);
+      break;
+#endif
+    default:
+      break;
+  }
+
+  KernelScalarFloat<std::conditional_t<kDoubleAcc, double, float>, kPotential>(sources, targets, done, g, eps2);
+}
+
+}  // namespace
+
+void AccumulateGravity(KernelIsa isa, const GravitySources& sources, const GravityTargets& targets, double softening, bool) {
+  const double g = constants::kG.value;
+  const double eps2 = softening * softening;
+
+  // Нельзя запускать ядро, которое процессор не поддерживает
+  isa = std::min(isa, DetectKernelIsa());
+
+  if (targets.potential != nullptr) {
+    Dispatch<true>(isa, sources, targets, g, eps2);
+  } else {
+    Dispatch<false>(isa, sources, targets, g, eps2);
+  }
+}
+
+template <bool kDoubleAcc>
+void AccumulateGravityFloat(KernelIsa isa, const BasicGravitySources<float>& sources, const BasicGravityTargets<float>& targets, double softening) {
+  const double g = constants::kG.value;
+  const auto eps2 = static_cast<float>(softening * softening);
+
+  isa = std::min(isa, DetectKernelIsa());
+
+  if (targets.potential != nullptr) {
+    DispatchFloat<kDoubleAcc, true>(isa, sources, targets, g, eps2);
+  } else {
+    DispatchFloat<kDoubleAcc, false>(isa, sources, targets, g, eps2);
+  }
+}
+
+void AccumulateGravity(KernelIsa isa, const BasicGravitySources<float>& sources, const BasicGravityTargets<float>& targets, double softening,
+                       bool double_accumulators) {
+  if (double_accumulators) {
+    AccumulateGravityFloat<true>(isa, sources, targets, softening);
+  } else {
+    AccumulateGravityFloat<false>(isa, sources, targets, softening);
+  }
+}
+
+}  // namespace physics::simulator
@@ -0,0 +1,75 @@
+#include "physics/simulator/neighbor_list.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace physics::simulator {
+
+template <typename S>
+bool NeighborList::Update(const BasicParticleStore<S>& particles, double radius, double skin, parallel::ThreadPool* pool) {
+  if (particles.Size() == bodies_ && radius == radius_ && skin == skin_ && !Moved(particles)) {
+    return false;
+  }
+
+  radius_ = radius;
+  skin_ = skin;
+  Rebuild(particles, pool);
+  return true;
+}
+
+template <typename S>
+bool NeighborList::Moved(const BasicParticleStore<S>& particles) const {
+  // Две сдвинувшиеся навстречу частицы сближаются не больше чем на skin, пока каждая прошла не больше skin / 2
+  const double limit2 = 0.25 * skin_ * skin_;
+  const std::size_t n = bodies_;
+  const double* x0 = reference_.data();
+  const double* y0 = x0 + n;
+  const double* z0 = y0 + n;
+
+  for (std::size_t i = 0; i < n; ++i) {
+    const double dx = particles.x[i] - x0[i];
+    const double dy = particles.y[i] - y0[i];
+    const double dz = particles.z[i] - z0[i];
+    if (dx * dx + dy * dy + dz * dz > limit2) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename S>
+void NeighborList::Rebuild(const BasicParticleStore<S>& particles, parallel::ThreadPool* pool) {
+  const std::size_t n = particles.Size();
+  bodies_ = n;
+  ++rebuilds_;
+
+  hash_.FindPairs(particles, radius_ + skin_, pairs_, pool);
+
+  reference_.resize(3 * n);
+  std::copy(particles.x.begin(), particles.x.end(), reference_.begin());
+  std::copy(particles.y.begin(), particles.y.end(), reference_.begin() + n);
+  std::copy(particles.z.begin(), particles.z.end(), reference_.begin() + 2 * n);
+
+  // Симметричные списки в формате CSR: каждое тело суммирует своих соседей само, без гонок между потоками
+  // Пары идут по возрастанию (i, j), поэтому и соседи каждого тела выходят упорядоченными
+  start_.assign(n + 1, 0);
+  for (const auto& [i, j] : pairs_) {
+    ++start_[i + 1];
+    ++start_[j + 1];
+  }
+  for (std::size_t i = 0; i < n; ++i) {
+    start_[i + 1] += start_[i];
+  }
+
+  neighbors_.resize(2 * pairs_.size());
+  std::vector<std::size_t> cursor(start_.begin(), start_.end() - 1);
+  for (const auto& [i, j] : pairs_) {
+    neighbors_[cursor[i]++] = j;
+    neighbors_[cursor[j]++] = i;
+  }
+}
+
+template bool NeighborList::Update(const ParticleStore&, double, double, parallel::ThreadPool*);
+template bool NeighborList::Update(const ParticleStore32&, double, double, parallel::ThreadPool*);
+
+}  // namespace physics::simulator
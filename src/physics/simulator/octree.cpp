@@ -0,0 +1,239 @@
+#include "physics/simulator/octree.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+#include <physics/constants.hpp>
+
+namespace physics::simulator {
+
+template <typename S>
+void Octree::Build(const BasicParticleStore<S>& particles) {
+  const std::size_t n = particles.Size();
+
+  nodes_.clear();
+  order_.resize(n);
+  scratch_.resize(n);
+
+  if (n == 0) {
+    return;
+  }
+
+  const S* pos[3] = {particles.x.data(), particles.y.data(), particles.z.data()};
+
+  double lo[3];
+  double hi[3];
+  for (std::size_t k = 0; k < 3; ++k) {
+    lo[k] = hi[k] = pos[k][0];
+  }
+
+  for (std::size_t i = 0; i < n; ++i) {
+    order_[i] = static_cast<std::uint32_t>(i);
+    for (std::size_t k = 0; k < 3; ++k) {
+      lo[k] = std::min<double>(lo[k], pos[k][i]);
+      hi[k] = std::max<double>(hi[k], pos[k][i]);
+    }
+  }
+
+  // Корневой узел - куб, охватывающий все тела
+  Node root{};
+  root.half = 0.0;
+  for (std::size_t k = 0; k < 3; ++k) {
+    root.center[k] = 0.5 * (lo[k] + hi[k]);
+    root.half = std::max(root.half, 0.5 * (hi[k] - lo[k]));
+  }
+  root.half = root.half > 0.0 ? root.half * (1.0 + 1e-9) : 1.0;
+  root.begin = 0;
+  root.end = static_cast<std::uint32_t>(n);
+
+  nodes_.reserve(2 * n / kLeafSize + 1);
+  nodes_.push_back(root);
+  BuildNode(0, particles, 0);
+}
+
+template <typename S>
+void Octree::BuildNode(std::size_t node, const BasicParticleStore<S>& particles, int depth) {
+  const std::uint32_t begin = nodes_[node].begin;
+  const std::uint32_t end = nodes_[node].end;
+
+  nodes_[node].first_child = -1;
+  nodes_[node].child_count = 0;
+
+  if (end - begin <= kLeafSize || depth >= kMaxDepth) {
+    double mass = 0.0;
+    double com[3] = {0.0, 0.0, 0.0};
+    for (std::uint32_t i = begin; i < end; ++i) {
+      const std::uint32_t b = order_[i];
+      const double m = particles.mass[b];
+      mass += m;
+      com[0] += m * particles.x[b];
+      com[1] += m * particles.y[b];
+      com[2] += m * particles.z[b];
+    }
+
+    nodes_[node].mass = mass;
+    for (std::size_t k = 0; k < 3; ++k) {
+      nodes_[node].com[k] = mass > 0.0 ? com[k] / mass : nodes_[node].center[k];
+    }
+    return;
+  }
+
+  // Раскладываем тела по октантам (сортировка подсчетом)
+  const double cx = nodes_[node].center[0];
+  const double cy = nodes_[node].center[1];
+  const double cz = nodes_[node].center[2];
+
+  auto octant = [&](std::uint32_t idx) {
+    return (particles.x[idx] >= cx ? 1 : 0) | (particles.y[idx] >= cy ? 2 : 0) | (particles.z[idx] >= cz ? 4 : 0);
+  };
+
+  std::array<std::uint32_t, 9> offsets{};
+  for (std::uint32_t i = begin; i < end; ++i) {
+    ++offsets[octant(order_[i]) + 1];
+  }
+  for (std::size_t o = 1; o < offsets.size(); ++o) {
+    offsets[o] += offsets[o - 1];
+  }
+
+  std::array<std::uint32_t, 8> cursor{};
+  for (std::size_t o = 0; o < 8; ++o) {
+    cursor[o] = begin + offsets[o];
+  }
+  for (std::uint32_t i = begin; i < end; ++i) {
+    scratch_[cursor[octant(order_[i])]++] = order_[i];
+  }
+  std::copy(scratch_.begin() + begin, scratch_.begin() + end, order_.begin() + begin);
+
+  // Непустые дети лежат в nodes_ подряд
+  const double child_half = 0.5 * nodes_[node].half;
+  const auto first_child = static_cast<std::int32_t>(nodes_.size());
+  std::int32_t child_count = 0;
+
+  for (int o = 0; o < 8; ++o) {
+    if (offsets[o] == offsets[o + 1]) {
+      continue;
+    }
+
+    Node child{};
+    child.half = child_half;
+    child.center[0] = cx + ((o & 1) != 0 ? child_half : -child_half);
+    child.center[1] = cy + ((o & 2) != 0 ? child_half : -child_half);
+    child.center[2] = cz + ((o & 4) != 0 ? child_half : -child_half);
+    child.begin = begin + offsets[o];
+    child.end = begin + offsets[o + 1];
+    nodes_.push_back(child);
+    ++child_count;
+  }
+
+  nodes_[node].first_child = first_child;
+  nodes_[node].child_count = child_count;
+
+  double mass = 0.0;
+  double com[3] = {0.0, 0.0, 0.0};
+  for (std::int32_t c = 0; c < child_count; ++c) {
+    const auto child = static_cast<std::size_t>(first_child + c);
+    BuildNode(child, particles, depth + 1);
+
+    mass += nodes_[child].mass;
+    for (std::size_t k = 0; k < 3; ++k) {
+      com[k] += nodes_[child].mass * nodes_[child].com[k];
+    }
+  }
+
+  nodes_[node].mass = mass;
+  for (std::size_t k = 0; k < 3; ++k) {
+    nodes_[node].com[k] = mass > 0.0 ? com[k] / mass : nodes_[node].center[k];
+  }
+}
+
+template <typename S>
+vector::Vector<units::Acceleration, 3> Octree::AccelerationOn(std::size_t index, const BasicParticleStore<S>& particles, double theta,
+                                                      double softening, double* potential) const {
+  vector::Vector<units::Acceleration, 3> result{};
+  if (nodes_.empty()) {
+    return result;
+  }
+
+  const double g = constants::kG.value;
+  const double px = particles.x[index];
+  const double py = particles.y[index];
+  const double pz = particles.z[index];
+  const double theta2 = theta * theta;
+  const double eps2 = softening * softening;
+
+  double acc[3] = {0.0, 0.0, 0.0};
+
+  auto add = [&](double mass, double x, double y, double z) {
+    const double dx = x - px;
+    const double dy = y - py;
+    const double dz = z - pz;
+    const double r2 = dx * dx + dy * dy + dz * dz;
+    if (r2 == 0.0) {
+      return;
+    }
+    const double d2 = r2 + eps2;
+    const double s = g * mass / (d2 * std::sqrt(d2));
+    acc[0] += s * dx;
+    acc[1] += s * dy;
+    acc[2] += s * dz;
+    if (potential != nullptr) {
+      *potential -= s * d2;
+    }
+  };
+
+  // Глубина ограничена kMaxDepth: на каждом уровне пути в стеке ждут не больше 7 братьев, плюс 8 детей последнего узла
+  // Массив не обнуляем, чтобы вызов для каждого тела не платил за заполнение
+  std::array<std::int32_t, 7 * kMaxDepth + 8> stack;
+  std::size_t top = 0;
+  stack[top++] = 0;
+
+  while (top > 0) {
+    const Node& node = nodes_[static_cast<std::size_t>(stack[--top])];
+
+    if (node.first_child < 0) {
+      for (std::uint32_t i = node.begin; i < node.end; ++i) {
+        const std::uint32_t j = order_[i];
+        if (j == index) {
+          continue;
+        }
+        add(particles.mass[j], particles.x[j], particles.y[j], particles.z[j]);
+      }
+      continue;
+    }
+
+    const bool inside = std::abs(px - node.center[0]) <= node.half && std::abs(py - node.center[1]) <= node.half &&
+                        std::abs(pz - node.center[2]) <= node.half;
+
+    if (!inside) {
+      const double dx = node.com[0] - px;
+      const double dy = node.com[1] - py;
+      const double dz = node.com[2] - pz;
+      const double d2 = dx * dx + dy * dy + dz * dz;
+      const double size = 2.0 * node.half;
+
+      // Критерий раскрытия: size / d < theta
+      if (size * size < theta2 * d2) {
+        add(node.mass, node.com[0], node.com[1], node.com[2]);
+        continue;
+      }
+    }
+
+    for (std::int32_t c = 0; c < node.child_count; ++c) {
+      stack[top++] = node.first_child + c;
+    }
+  }
+
+  for (std::size_t k = 0; k < 3; ++k) {
+    result[k] = units::Acceleration{acc[k]};
+  }
+  return result;
+}
+
+template void Octree::Build(const ParticleStore&);
+template void Octree::Build(const ParticleStore32&);
+template vector::Vector<units::Acceleration, 3> Octree::AccelerationOn(std::size_t, const ParticleStore&, double, double, double*) const;
+template vector::Vector<units::Acceleration, 3> Octree::AccelerationOn(std::size_t, const ParticleStore32&, double, double, double*) const;
+
+}  // namespace physics::simulator
@@ -0,0 +1,489 @@
+#include "physics/simulator/particle_mesh.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <numbers>
+
+#include <physics/constants.hpp>
+
+namespace physics::simulator {
+
+namespace {
+
+constexpr std::size_t kLineGrain = 64;
+constexpr std::size_t kBodyGrain = 1024;
+
+void Run(parallel::ThreadPool* pool, std::size_t count, std::size_t grain, const parallel::ThreadPool::RangeFn& fn) {
+  if (pool != nullptr) {
+    pool->ParallelFor(count, grain, fn);
+  } else if (count > 0) {
+    fn(0, count, 0);
+  }
+}
+
+// Узлы и веса схемы по одной оси для координаты u в единицах шага сетки; возвращает число узлов
+int AxisWeights(double u, MeshAssignment assignment, std::int64_t& first, double w[3]) {
+  if (assignment == MeshAssignment::kCic) {
+    const double base = std::floor(u);
+    const double d = u - base;
+    first = static_cast<std::int64_t>(base);
+    w[0] = 1.0 - d;
+    w[1] = d;
+    return 2;
+  }
+
+  const double center = std::floor(u + 0.5);
+  const double d = u - center;
+  first = static_cast<std::int64_t>(center) - 1;
+  w[0] = 0.5 * (0.5 - d) * (0.5 - d);
+  w[1] = 0.75 - d * d;
+  w[2] = 0.5 * (0.5 + d) * (0.5 + d);
+  return 3;
+}
+
+// Доля силы, которая остается прямой сумме при гауссовом разбиении с масштабом rs
+double ShortRangeFactor(double r, double rs) {
+  const double x = r / (2.0 * rs);
+  return std::erfc(x) + 2.0 * x / std::sqrt(std::numbers::pi) * std::exp(-x * x);
+}
+
+// Комплексное БПФ по основанию 2 на месте, twiddles[k] = exp(-2 pi i k / n)
+void Fft(std::complex<double>* a, std::size_t n, const std::vector<std::complex<double>>& twiddles, bool inverse) {
+  for (std::size_t i = 1, j = 0; i < n; ++i) {
+    std::size_t bit = n >> 1;
+    for (; (j & bit) != 0; bit >>= 1) {
+      j ^= bit;
+    }
+    j ^= bit;
+    if (i < j) {
+      std::swap(a[i], a[j]);
+    }
+  }
+
+  for (std::size_t len = 2; len <= n; len <<= 1) {
+    const std::size_t step = n / len;
+    const std::size_t half = len / 2;
+    for (std::size_t i = 0; i < n; i += len) {
+      for (std::size_t k = 0; k < half; ++k) {
+        const std::complex<double> w = inverse ? std::conj(twiddles[k * step]) : twiddles[k * step];
+        const std::complex<double> u = a[i + k];
+        const std::complex<double> v = a[i + k + half] * w;
+        a[i + k] = u + v;
+        a[i + k + half] = u - v;
+      }
+    }
+  }
+}
+
+}  // namespace
+
+template <typename S>
+void ParticleMesh::AddAccelerations(const BasicParticleStore<S>& particles, const MeshOptions& options, double softening, S* ax, S* ay, S* az,
+                                    parallel::ThreadPool* pool) {
+  const std::size_t n = particles.Size();
+  if (n == 0) {
+    return;
+  }
+
+  std::size_t cells = 4;
+  while (cells < options.grid) {
+    cells <<= 1;
+  }
+
+  grid_.n = cells;
+  grid_.periodic = options.boundary == MeshBoundary::kPeriodic;
+
+  if (grid_.periodic) {
+    grid_.size = cells;
+    grid_.h = options.box_size / static_cast<double>(cells);
+    std::fill(std::begin(grid_.origin), std::end(grid_.origin), 0.0);
+  } else {
+    // Куб вокруг тел с запасом в узел с каждой стороны под облако TSC
+    double lo[3] = {particles.x[0], particles.y[0], particles.z[0]};
+    double hi[3] = {lo[0], lo[1], lo[2]};
+    const std::vector<S>* pos[3] = {&particles.x, &particles.y, &particles.z};
+    for (std::size_t k = 0; k < 3; ++k) {
+      for (const double v : *pos[k]) {
+        lo[k] = std::min(lo[k], v);
+        hi[k] = std::max(hi[k], v);
+      }
+    }
+
+    const double extent = std::max({hi[0] - lo[0], hi[1] - lo[1], hi[2] - lo[2]});
+    grid_.size = 2 * cells;
+    grid_.h = extent > 0.0 ? extent * (1.0 + 1e-9) / static_cast<double>(cells - 3) : 1.0;
+    for (std::size_t k = 0; k < 3; ++k) {
+      grid_.origin[k] = 0.5 * (lo[k] + hi[k]) - 0.5 * grid_.h * static_cast<double>(cells - 1);
+    }
+  }
+
+  const std::size_t s = grid_.size;
+  const double h = grid_.h;
+
+  density_.assign(s * s * s, Complex{});
+  Deposit(particles, options.assignment, grid_.periodic ? 1.0 / (h * h * h) : 1.0);
+  Fft3d(density_, false, pool);
+
+  double scale = 1.0 / static_cast<double>(s * s * s);
+  if (grid_.periodic) {
+    SolvePeriodic(options, pool);
+  } else {
+    SolveIsolated(options, pool);
+    scale /= h * h;
+  }
+
+  Gather(particles, options.assignment, work_, scale, ax, ay, pool);
+  Gather(particles, options.assignment, density_, scale, az, static_cast<S*>(nullptr), pool);
+
+  if (options.short_range) {
+    AddShortRange(particles, options, softening, ax, ay, az, pool);
+  }
+}
+
+void ParticleMesh::Fft3d(std::vector<Complex>& data, bool inverse, parallel::ThreadPool* pool) {
+  const std::size_t s = grid_.size;
+
+  if (twiddles_.size() != s / 2) {
+    twiddles_.resize(s / 2);
+    for (std::size_t k = 0; k < s / 2; ++k) {
+      twiddles_[k] = std::polar(1.0, -2.0 * std::numbers::pi * static_cast<double>(k) / static_cast<double>(s));
+    }
+  }
+
+  // Одномерные БПФ вдоль z, y и x; линии вдоль y и x копируются в непрерывный буфер
+  for (std::size_t axis = 0; axis < 3; ++axis) {
+    const std::size_t stride = axis == 0 ? 1 : (axis == 1 ? s : s * s);
+
+    Run(pool, s * s, kLineGrain, [&](std::size_t begin, std::size_t end, std::size_t) {
+      std::vector<Complex> line(s);
+      for (std::size_t l = begin; l < end; ++l) {
+        const std::size_t outer = l / s;
+        const std::size_t inner = l % s;
+        std::size_t base = 0;
+        if (axis == 0) {
+          base = l * s;
+        } else if (axis == 1) {
+          base = outer * s * s + inner;
+        } else {
+          base = outer * s + inner;
+        }
+
+        if (stride == 1) {
+          Fft(data.data() + base, s, twiddles_, inverse);
+          continue;
+        }
+
+        for (std::size_t i = 0; i < s; ++i) {
+          line[i] = data[base + i * stride];
+        }
+        Fft(line.data(), s, twiddles_, inverse);
+        for (std::size_t i = 0; i < s; ++i) {
+          data[base + i * stride] = line[i];
+        }
+      }
+    });
+  }
+}
+
+template <typename S>
+void ParticleMesh::Deposit(const BasicParticleStore<S>& particles, MeshAssignment assignment, double scale) {
+  const std::size_t s = grid_.size;
+  const auto n = static_cast<std::int64_t>(grid_.n);
+
+  auto wrap = [&](std::int64_t i) -> std::size_t {
+    if (grid_.periodic) {
+      return static_cast<std::size_t>(((i % n) + n) % n);
+    }
+    return static_cast<std::size_t>(std::clamp<std::int64_t>(i, 0, n - 1));
+  };
+
+  for (std::size_t b = 0; b < particles.Size(); ++b) {
+    std::int64_t first[3];
+    double w[3][3];
+    const double pos[3] = {particles.x[b], particles.y[b], particles.z[b]};
+    int count = 0;
+    for (std::size_t k = 0; k < 3; ++k) {
+      count = AxisWeights((pos[k] - grid_.origin[k]) / grid_.h, assignment, first[k], w[k]);
+    }
+
+    const double m = particles.mass[b] * scale;
+    for (int i = 0; i < count; ++i) {
+      const std::size_t ix = wrap(first[0] + i);
+      for (int j = 0; j < count; ++j) {
+        const std::size_t iy = wrap(first[1] + j);
+        const double wij = m * w[0][i] * w[1][j];
+        for (int k = 0; k < count; ++k) {
+          density_[(ix * s + iy) * s + wrap(first[2] + k)] += wij * w[2][k];
+        }
+      }
+    }
+  }
+}
+
+template <typename S>
+void ParticleMesh::Gather(const BasicParticleStore<S>& particles, MeshAssignment assignment, const std::vector<Complex>& field, double scale, S* first,
+                          S* second, parallel::ThreadPool* pool) const {
+  const std::size_t s = grid_.size;
+  const auto n = static_cast<std::int64_t>(grid_.n);
+
+  auto wrap = [&](std::int64_t i) -> std::size_t {
+    if (grid_.periodic) {
+      return static_cast<std::size_t>(((i % n) + n) % n);
+    }
+    return static_cast<std::size_t>(std::clamp<std::int64_t>(i, 0, n - 1));
+  };
+
+  Run(pool, particles.Size(), kBodyGrain, [&](std::size_t begin, std::size_t end, std::size_t) {
+    for (std::size_t b = begin; b < end; ++b) {
+      std::int64_t base[3];
+      double w[3][3];
+      const double pos[3] = {particles.x[b], particles.y[b], particles.z[b]};
+      int count = 0;
+      for (std::size_t k = 0; k < 3; ++k) {
+        count = AxisWeights((pos[k] - grid_.origin[k]) / grid_.h, assignment, base[k], w[k]);
+      }
+
+      Complex sum{};
+      for (int i = 0; i < count; ++i) {
+        const std::size_t ix = wrap(base[0] + i);
+        for (int j = 0; j < count; ++j) {
+          const std::size_t iy = wrap(base[1] + j);
+          const double wij = w[0][i] * w[1][j];
+          for (int k = 0; k < count; ++k) {
+            sum += wij * w[2][k] * field[(ix * s + iy) * s + wrap(base[2] + k)];
+          }
+        }
+      }
+
+      first[b] += scale * sum.real();
+      if (second != nullptr) {
+        second[b] += scale * sum.imag();
+      }
+    }
+  });
+}
+
+void ParticleMesh::SolvePeriodic(const MeshOptions& options, parallel::ThreadPool* pool) {
+  const std::size_t s = grid_.size;
+  const auto n = static_cast<std::int64_t>(s);
+  const double h = grid_.h;
+  const double k0 = 2.0 * std::numbers::pi / (static_cast<double>(s) * h);
+  const double rs = options.split * h;
+  const double g = constants::kG.value;
+
+  work_.resize(s * s * s);
+
+  Run(pool, s, 1, [&](std::size_t begin, std::size_t end, std::size_t) {
+    for (std::size_t a = begin; a < end; ++a) {
+      for (std::size_t b = 0; b < s; ++b) {
+        for (std::size_t c = 0; c < s; ++c) {
+          const std::size_t idx = (a * s + b) * s + c;
+          const std::int64_t m[3] = {static_cast<std::int64_t>(a), static_cast<std::int64_t>(b), static_cast<std::int64_t>(c)};
+
+          double k[3];
+          double grad[3];
+          for (std::size_t d = 0; d < 3; ++d) {
+            const std::int64_t signed_m = m[d] < n / 2 ? m[d] : m[d] - n;
+            k[d] = k0 * static_cast<double>(signed_m);
+            // Четырехточечная разностная производная: в отличие от спектральной i*k она гасит гармоники у частоты Найквиста,
+            // и сила двух тел не звенит; деление на окно схемы по той же причине не делается
+            grad[d] = (8.0 * std::sin(k[d] * h) - std::sin(2.0 * k[d] * h)) / (6.0 * h);
+          }
+
+          const double k2 = k[0] * k[0] + k[1] * k[1] + k[2] * k[2];
+          if (k2 == 0.0) {
+            work_[idx] = Complex{};
+            density_[idx] = Complex{};
+            continue;
+          }
+
+          double green = -4.0 * std::numbers::pi * g / k2;
+          if (options.short_range) {
+            green *= std::exp(-k2 * rs * rs);
+          }
+
+          // a = -grad(phi) = -i D(k) phi_k; x и y упакованы в одно комплексное поле, оба результата вещественны
+          const Complex phi = green * density_[idx];
+          work_[idx] = phi * Complex(grad[1], -grad[0]);
+          density_[idx] = phi * Complex(0.0, -grad[2]);
+        }
+      }
+    }
+  });
+
+  Fft3d(work_, true, pool);
+  Fft3d(density_, true, pool);
+}
+
+void ParticleMesh::SolveIsolated(const MeshOptions& options, parallel::ThreadPool* pool) {
+  if (kernel_size_ != grid_.size || kernel_short_range_ != options.short_range || kernel_split_ != options.split) {
+    BuildKernel(options, pool);
+  }
+
+  const std::size_t total = density_.size();
+  work_.resize(total);
+
+  Run(pool, total, kBodyGrain, [&](std::size_t begin, std::size_t end, std::size_t) {
+    for (std::size_t i = begin; i < end; ++i) {
+      work_[i] = density_[i] * kernel_xy_[i];
+      density_[i] *= kernel_z_[i];
+    }
+  });
+
+  Fft3d(work_, true, pool);
+  Fft3d(density_, true, pool);
+}
+
+void ParticleMesh::BuildKernel(const MeshOptions& options, parallel::ThreadPool* pool) {
+  const std::size_t s = grid_.size;
+  const auto half = static_cast<std::int64_t>(s / 2);
+  const double g = constants::kG.value;
+
+  kernel_xy_.assign(s * s * s, Complex{});
+  kernel_z_.assign(s * s * s, Complex{});
+
+  // Смещение узла цели относительно источника; смещение ровно half не встречается в свертке
+  auto offset = [&](std::size_t i) {
+    const auto v = static_cast<std::int64_t>(i);
+    return v < half ? v : v - 2 * half;
+  };
+
+  Run(pool, s, 1, [&](std::size_t begin, std::size_t end, std::size_t) {
+    for (std::size_t a = begin; a < end; ++a) {
+      for (std::size_t b = 0; b < s; ++b) {
+        for (std::size_t c = 0; c < s; ++c) {
+          const double d[3] = {static_cast<double>(offset(a)), static_cast<double>(offset(b)), static_cast<double>(offset(c))};
+          const double r2 = d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+          if (r2 == 0.0 || a == s / 2 || b == s / 2 || c == s / 2) {
+            continue;
+          }
+
+          // Ускорение цели от единичной массы в единицах шага сетки: K = -G d / |d|^3
+          const double r = std::sqrt(r2);
+          double f = -g / (r2 * r);
+          if (options.short_range) {
+            f *= 1.0 - ShortRangeFactor(r, options.split);
+          }
+
+          const std::size_t idx = (a * s + b) * s + c;
+          kernel_xy_[idx] = Complex(f * d[0], f * d[1]);
+          kernel_z_[idx] = Complex(f * d[2], 0.0);
+        }
+      }
+    }
+  });
+
+  Fft3d(kernel_xy_, false, pool);
+  Fft3d(kernel_z_, false, pool);
+
+  kernel_size_ = s;
+  kernel_short_range_ = options.short_range;
+  kernel_split_ = options.split;
+}
+
+template <typename S>
+void ParticleMesh::AddShortRange(const BasicParticleStore<S>& particles, const MeshOptions& options, double softening, S* ax, S* ay, S* az,
+                                 parallel::ThreadPool* pool) {
+  const std::size_t n = particles.Size();
+  const double rs = options.split * grid_.h;
+  const double cutoff = options.cutoff * rs;
+  const double cutoff2 = cutoff * cutoff;
+  const double eps2 = softening * softening;
+  const double g = constants::kG.value;
+  const bool periodic = grid_.periodic;
+
+  // Область ячеек: периодическая коробка или куб сетки без запасных узлов
+  const double box = periodic ? grid_.h * static_cast<double>(grid_.n) : grid_.h * static_cast<double>(grid_.n - 1);
+  auto cells = static_cast<std::int64_t>(std::clamp(std::floor(box / cutoff), 1.0, 128.0));
+  // В периодической коробке меньше трех ячеек на сторону соседи повторились бы, поэтому берем одну ячейку
+  if (periodic && cells < 3) {
+    cells = 1;
+  }
+  const double cell_size = box / static_cast<double>(cells);
+
+  auto cell_coord = [&](double v, std::size_t k) {
+    auto c = static_cast<std::int64_t>(std::floor((v - grid_.origin[k]) / cell_size));
+    return periodic ? ((c % cells) + cells) % cells : std::clamp<std::int64_t>(c, 0, cells - 1);
+  };
+  auto cell_index = [&](std::int64_t cx, std::int64_t cy, std::int64_t cz) { return static_cast<std::size_t>((cx * cells + cy) * cells + cz); };
+
+  const auto total = static_cast<std::size_t>(cells * cells * cells);
+  cell_start_.assign(total + 1, 0);
+  cell_of_.resize(n);
+  cell_entries_.resize(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    cell_of_[i] = static_cast<std::uint32_t>(cell_index(cell_coord(particles.x[i], 0), cell_coord(particles.y[i], 1), cell_coord(particles.z[i], 2)));
+    ++cell_start_[cell_of_[i] + 1];
+  }
+  for (std::size_t c = 0; c < total; ++c) {
+    cell_start_[c + 1] += cell_start_[c];
+  }
+  std::vector<std::uint32_t> cursor(cell_start_.begin(), cell_start_.end() - 1);
+  for (std::size_t i = 0; i < n; ++i) {
+    cell_entries_[cursor[cell_of_[i]]++] = static_cast<std::uint32_t>(i);
+  }
+
+  const std::int64_t reach = cells == 1 ? 0 : 1;
+
+  // Каждое тело суммирует своих соседей само, поэтому потоки пишут в разные элементы
+  Run(pool, n, kBodyGrain / 8, [&](std::size_t begin, std::size_t end, std::size_t) {
+    for (std::size_t i = begin; i < end; ++i) {
+      const double xi = particles.x[i];
+      const double yi = particles.y[i];
+      const double zi = particles.z[i];
+      const std::int64_t c[3] = {cell_coord(xi, 0), cell_coord(yi, 1), cell_coord(zi, 2)};
+
+      double acc[3] = {0.0, 0.0, 0.0};
+      for (std::int64_t dx = -reach; dx <= reach; ++dx) {
+        for (std::int64_t dy = -reach; dy <= reach; ++dy) {
+          for (std::int64_t dz = -reach; dz <= reach; ++dz) {
+            std::int64_t nc[3] = {c[0] + dx, c[1] + dy, c[2] + dz};
+            bool inside = true;
+            for (auto& v : nc) {
+              if (periodic) {
+                v = ((v % cells) + cells) % cells;
+              } else {
+                inside = inside && v >= 0 && v < cells;
+              }
+            }
+            if (!inside) {
+              continue;
+            }
+
+            const std::size_t cell = cell_index(nc[0], nc[1], nc[2]);
+            for (std::uint32_t e = cell_start_[cell]; e < cell_start_[cell + 1]; ++e) {
+              const std::uint32_t j = cell_entries_[e];
+              double d[3] = {particles.x[j] - xi, particles.y[j] - yi, particles.z[j] - zi};
+              if (periodic) {
+                for (auto& v : d) {
+                  v -= box * std::round(v / box);
+                }
+              }
+
+              const double r2 = d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+              if (r2 == 0.0 || r2 >= cutoff2) {
+                continue;
+              }
+
+              const double d2 = r2 + eps2;
+              const double w = g * particles.mass[j] / (d2 * std::sqrt(d2)) * ShortRangeFactor(std::sqrt(r2), rs);
+              acc[0] += w * d[0];
+              acc[1] += w * d[1];
+              acc[2] += w * d[2];
+            }
+          }
+        }
+      }
+
+      ax[i] += acc[0];
+      ay[i] += acc[1];
+      az[i] += acc[2];
+    }
+  });
+}
+
+template void ParticleMesh::AddAccelerations(const ParticleStore&, const MeshOptions&, double, double*, double*, double*, parallel::ThreadPool*);
+template void ParticleMesh::AddAccelerations(const ParticleStore32&, const MeshOptions&, double, float*, float*, float*, parallel::ThreadPool*);
+
+}  // namespace physics::simulator
@@ -0,0 +1,74 @@
+#include "physics/simulator/particles.hpp"
+
+#include <cstddef>
+
+namespace physics::simulator {
+
+template <typename S>
+void BasicParticleStore<S>::Clear() {
+  Resize(0);
+}
+
+template <typename S>
+void BasicParticleStore<S>::Reserve(std::size_t n) {
+  for (auto* v : {&x, &y, &z, &vx, &vy, &vz, &ax, &ay, &az, &mass}) {
+    v->reserve(n);
+  }
+}
+
+template <typename S>
+void BasicParticleStore<S>::Resize(std::size_t n) {
+  for (auto* v : {&x, &y, &z, &vx, &vy, &vz, &ax, &ay, &az, &mass}) {
+    v->resize(n, S{0});
+  }
+}
+
+template <typename S>
+void BasicParticleStore<S>::PushBack(const object::Object& obj) {
+  Resize(Size() + 1);
+  Set(Size() - 1, obj);
+}
+
+template <typename S>
+object::Object BasicParticleStore<S>::Get(std::size_t i) const {
+  object::Object obj(units::Weight{mass[i]});
+  obj.position = {units::Length{x[i]}, units::Length{y[i]}, units::Length{z[i]}};
+  obj.speed = {units::Speed{vx[i]}, units::Speed{vy[i]}, units::Speed{vz[i]}};
+  obj.acceleration = {units::Acceleration{ax[i]}, units::Acceleration{ay[i]}, units::Acceleration{az[i]}};
+  return obj;
+}
+
+template <typename S>
+void BasicParticleStore<S>::Set(std::size_t i, const object::Object& obj) {
+  mass[i] = static_cast<S>(obj.weight.value);
+  x[i] = static_cast<S>(obj.position[0].value);
+  y[i] = static_cast<S>(obj.position[1].value);
+  z[i] = static_cast<S>(obj.position[2].value);
+  vx[i] = static_cast<S>(obj.speed[0].value);
+  vy[i] = static_cast<S>(obj.speed[1].value);
+  vz[i] = static_cast<S>(obj.speed[2].value);
+  ax[i] = static_cast<S>(obj.acceleration[0].value);
+  ay[i] = static_cast<S>(obj.acceleration[1].value);
+  az[i] = static_cast<S>(obj.acceleration[2].value);
+}
+
+template <typename S>
+void BasicParticleStore<S>::Assign(const std::vector<object::Object>& objects) {
+  Resize(objects.size());
+  for (std::size_t i = 0; i < objects.size(); ++i) {
+    Set(i, objects[i]);
+  }
+}
+
+template <typename S>
+void BasicParticleStore<S>::Store(std::vector<object::Object>& objects) const {
+  objects.resize(Size());
+  for (std::size_t i = 0; i < Size(); ++i) {
+    objects[i] = Get(i);
+  }
+}
+
+template class BasicParticleStore<double>;
+template class BasicParticleStore<float>;
+
+}  // namespace physics::simulator
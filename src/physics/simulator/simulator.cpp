@@ -1,118 +1,1759 @@
 #include "physics/simulator/simulator.hpp"
 
+#include <algorithm>
+#include <bit>
+#include <cmath>
 #include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <type_traits>
 
+#include <physics/constants.hpp>
+#include <physics/simulator/elastic.hpp>
 #include <physics/vector/vector.hpp>
 #include <physics/units/quantity.hpp>
 
 namespace physics::simulator {
 
-void Simulator::ResetAccelerations() {
-  for (auto& obj : objects_) {
-    for (std::size_t i = 0; i < 3; ++i) {
-      obj.acceleration[i] = units::Acceleration{0.0};
+namespace {
+
+// Минимальные куски для ParallelFor: по телам и по целям гравитации (кратно ширине AVX-512)
+constexpr std::size_t kBodyGrain = 4096;
+constexpr std::size_t kTargetGrain = 64;
+// Минимальный кусок контактов одного цвета
+constexpr std::size_t kContactGrain = 1024;
+
+// Время до касания сфер, если d - их относительное положение, а w - относительная скорость
+// Корень |d + w t| = distance при сближении; бесконечность, если касания нет
+double TimeOfImpact(const double d[3], const double w[3], double distance) {
+  const double b = d[0] * w[0] + d[1] * w[1] + d[2] * w[2];
+  if (b >= 0.0) {
+    return std::numeric_limits<double>::infinity();
+  }
+
+  const double c = d[0] * d[0] + d[1] * d[1] + d[2] * d[2] - distance * distance;
+  if (c <= 0.0) {
+    return 0.0;
+  }
+
+  const double a = w[0] * w[0] + w[1] * w[1] + w[2] * w[2];
+  const double disc = b * b - a * c;
+  if (disc < 0.0) {
+    return std::numeric_limits<double>::infinity();
+  }
+
+  // Меньший корень (-b - sqrt(disc)) / a в форме без вычитания близких чисел
+  return c / (-b + std::sqrt(disc));
+}
+
+// Совпадают ли тела массива объектов с хранилищем после приведения к его типу
+template <typename S>
+bool SameBodies(const BasicParticleStore<S>& p, const std::vector<object::Object>& objects) {
+  if (p.Size() != objects.size()) {
+    return false;
+  }
+  for (std::size_t i = 0; i < objects.size(); ++i) {
+    const auto& o = objects[i];
+    const S values[10] = {p.mass[i], p.x[i], p.y[i], p.z[i], p.vx[i], p.vy[i], p.vz[i], p.ax[i], p.ay[i], p.az[i]};
+    const double expected[10] = {o.weight.value,  o.position[0].value, o.position[1].value,     o.position[2].value,     o.speed[0].value,
+                                 o.speed[1].value, o.speed[2].value,    o.acceleration[0].value, o.acceleration[1].value, o.acceleration[2].value};
+    for (std::size_t k = 0; k < 10; ++k) {
+      if (values[k] != static_cast<S>(expected[k])) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+template <typename S>
+std::vector<object::Object>& BasicSimulator<S>::Objects() {
+  InvalidateAccelerations();
+  sleep_check_ = true;
+  SyncObjects();
+  storage_ = Storage::kObjects;
+  objects_shared_ = true;
+  return objects_;
+}
+
+template <typename S>
+const std::vector<object::Object>& BasicSimulator<S>::Objects() const {
+  SyncObjects();
+  return objects_;
+}
+
+template <typename S>
+BasicParticleStore<S>& BasicSimulator<S>::Particles() {
+  InvalidateAccelerations();
+  sleep_check_ = true;
+  SyncParticles();
+  storage_ = Storage::kParticles;
+  return particles_;
+}
+
+template <typename S>
+const BasicParticleStore<S>& BasicSimulator<S>::Particles() const {
+  SyncParticles();
+  return particles_;
+}
+
+template <typename S>
+void BasicSimulator<S>::AddObject(const object::Object& obj) {
+  InvalidateAccelerations();
+  SyncParticles();
+  particles_.PushBack(obj);
+  storage_ = Storage::kParticles;
+}
+
+template <typename S>
+void BasicSimulator<S>::SyncObjects() const {
+  if (storage_ == Storage::kParticles) {
+    particles_.Store(objects_);
+    storage_ = Storage::kSynced;
+  }
+}
+
+template <typename S>
+void BasicSimulator<S>::SyncParticles() const {
+  if (storage_ == Storage::kObjects) {
+    particles_.Assign(objects_);
+    storage_ = Storage::kSynced;
+  }
+}
+
+template <typename S>
+void BasicSimulator<S>::SyncBodies() {
+  // Массив могли уже прочитать обратно, например через Particles() const, а правка через ссылку пришла после этого
+  if (objects_shared_ && storage_ == Storage::kSynced && !SameBodies(particles_, objects_)) {
+    storage_ = Storage::kObjects;
+  }
+  SyncParticles();
+  // Дальше ссылка устаревает до следующего вызова Objects(), и шаги больше не сравнивают с ней хранилище
+  objects_shared_ = false;
+  SyncSleep();
+}
+
+template <typename S>
+void BasicSimulator<S>::SetThreads(std::size_t threads) {
+  if (threads == 0) {
+    threads = parallel::HardwareThreads();
+  }
+
+  if (threads == Threads()) {
+    return;
+  }
+
+  pool_ = threads > 1 ? std::make_shared<parallel::ThreadPool>(threads) : nullptr;
+  thread_acc_.clear();
+}
+
+template <typename S>
+void BasicSimulator<S>::ParallelFor(std::size_t count, std::size_t grain, const parallel::ThreadPool::RangeFn& fn) {
+  if (pool_) {
+    pool_->ParallelFor(count, grain, fn);
+  } else if (count > 0) {
+    fn(0, count, 0);
+  }
+}
+
+template <typename S>
+void BasicSimulator<S>::ResetAccelerations() {
+  auto& p = particles_;
+  ParallelFor(p.Size(), kBodyGrain, [&p](std::size_t begin, std::size_t end, std::size_t) {
+    std::fill(p.ax.begin() + begin, p.ax.begin() + end, 0.0);
+    std::fill(p.ay.begin() + begin, p.ay.begin() + end, 0.0);
+    std::fill(p.az.begin() + begin, p.az.begin() + end, 0.0);
+  });
+}
+
+template <typename S>
+void BasicSimulator<S>::ComputeAccelerations() {
+  StatsScope scope(stats_, StepPhase::kGravity);
+  ResetAccelerations();
+
+  // Потенциал нужен точке ряда, которая ждет его с конца прошлого шага, или запрошен заранее
+  const bool potential = potential_pending_ || potential_requested_;
+  if (potential) {
+    potential_.assign(particles_.Size(), 0);
+    potential_energy_ = 0.0;
+  }
+
+  // Спящим телам силы не нужны; полный проход остается только для потенциала
+  if (sleeping_ > 0 && !potential) {
+    ComputeAwakeAccelerations();
+    return;
+  }
+
+  if (use_gravity_) {
+    ApplyGravity(potential);
+  }
+  // Пружины действуют и без гравитации
+  if (!springs_.Empty()) {
+    auto& p = particles_;
+    springs_.AddAccelerations(p, p.ax.data(), p.ay.data(), p.az.data(), pool_.get());
+  }
+  if (sleeping_ > 0) {
+    auto& p = particles_;
+    for (std::size_t i = 0; i < asleep_.size(); ++i) {
+      if (asleep_[i] != 0) {
+        p.ax[i] = p.ay[i] = p.az[i] = 0;
+      }
+    }
+  }
+
+  if (potential) {
+    potential_energy_ += SumPotential();
+    if (!springs_.Empty()) {
+      potential_energy_ += springs_.Energy(particles_, pool_.get());
+    }
+    if (potential_pending_) {
+      diagnostics_.back().potential = potential_energy_;
+      potential_pending_ = false;
+    }
+    potential_requested_ = false;
+  }
+}
+
+template <typename S>
+void BasicSimulator<S>::ApplyGravity(bool potential) {
+  switch (gravity_solver_) {
+    case GravitySolver::kDirect:
+      ApplyGravityDirect(potential);
+      break;
+    case GravitySolver::kBarnesHut:
+      ApplyGravityBarnesHut(potential);
+      break;
+    case GravitySolver::kParticleMesh:
+      ApplyGravityParticleMesh(potential);
+      break;
+    case GravitySolver::kCutoff:
+      ApplyGravityCutoff(potential);
+      break;
+  }
+}
+
+template <typename S>
+void BasicSimulator<S>::ApplyGravityDirect(bool potential) {
+  auto& p = particles_;
+  const std::size_t n = p.Size();
+  if (n < 2) {
+    return;
+  }
+
+  // Попарное ядро пишет и в чужие тела, и порядок сложения в нем зависит от потоков
+  // В детерминированном режиме скалярное ядро тоже идет по целям: вдвое больше пар, зато без буферов
+  if (kernel_isa_ == KernelIsa::kScalar && !deterministic_) {
+    ApplyGravityPairwise(potential);
+    return;
+  }
+
+  // Каждая цель суммирует вклад всех источников сама в порядке их номеров, поэтому потоки пишут в непересекающиеся куски
+  BasicGravitySources<S> sources{p.x.data(), p.y.data(), p.z.data(), p.mass.data(), n};
+  ParallelFor(n, kTargetGrain, [&](std::size_t begin, std::size_t end, std::size_t) {
+    BasicGravityTargets<S> targets{p.x.data() + begin, p.y.data() + begin, p.z.data() + begin, p.ax.data() + begin, p.ay.data() + begin,
+                                   p.az.data() + begin, end - begin, potential ? potential_.data() + begin : nullptr};
+    AccumulateGravity(kernel_isa_, sources, targets, softening_.value, double_accumulators_);
+  });
+}
+
+template <typename S>
+void BasicSimulator<S>::ApplyGravityPairwise(bool potential) {
+  auto& p = particles_;
+  const std::size_t n = p.Size();
+  const auto g = static_cast<S>(constants::kG.value);
+  const auto eps2 = static_cast<S>(softening_.value * softening_.value);
+
+  // Строки [begin, end) треугольника пар i < j; буферы потоков в double, поэтому тип выхода - параметр
+  // С with_potential строки возвращают энергию своих пар -G m_i m_j / r, иначе 0
+  auto rows = [&](std::size_t begin, std::size_t end, auto* ax, auto* ay, auto* az, auto with_potential) {
+    double energy = 0.0;
+    for (std::size_t i = begin; i < end; ++i) {
+      const S xi = p.x[i];
+      const S yi = p.y[i];
+      const S zi = p.z[i];
+      const S gmi = g * p.mass[i];
+
+      S axi = 0;
+      S ayi = 0;
+      S azi = 0;
+      S pot = 0;
+
+      for (std::size_t j = i + 1; j < n; ++j) {
+        const S dx = p.x[j] - xi;
+        const S dy = p.y[j] - yi;
+        const S dz = p.z[j] - zi;
+        const S r2 = dx * dx + dy * dy + dz * dz;
+        if (r2 == 0) {
+          continue;
+        }
+
+        const S d2 = r2 + eps2;
+        const S inv_r3 = 1 / (d2 * std::sqrt(d2));
+
+        // Третий закон Ньютона: одна пара дает вклад обоим телам
+        const S si = g * p.mass[j] * inv_r3;
+        const S sj = gmi * inv_r3;
+        axi += si * dx;
+        ayi += si * dy;
+        azi += si * dz;
+        ax[j] -= sj * dx;
+        ay[j] -= sj * dy;
+        az[j] -= sj * dz;
+        if constexpr (decltype(with_potential)::value) {
+          pot += sj * d2 * p.mass[j];
+        }
+      }
+
+      ax[i] += axi;
+      ay[i] += ayi;
+      az[i] += azi;
+      energy -= static_cast<double>(pot);
+    }
+    return energy;
+  };
+
+  if (!pool_) {
+    potential_energy_ += potential ? rows(0, n, p.ax.data(), p.ay.data(), p.az.data(), std::true_type{})
+                                   : rows(0, n, p.ax.data(), p.ay.data(), p.az.data(), std::false_type{});
+    return;
+  }
+
+  // Запись в чужое тело j из разных потоков - гонка, поэтому у каждого потока свой буфер
+  const std::size_t threads = pool_->Size();
+  if (thread_acc_.size() != threads || thread_acc_[0].size() != 3 * n) {
+    thread_acc_.assign(threads, std::vector<double>(3 * n, 0.0));
+  }
+
+  // Куски строк с примерно одинаковым числом пар: строка i содержит n - i - 1 пар
+  const std::size_t chunks = std::min(n, 8 * threads);
+  const double pairs_per_chunk = 0.5 * static_cast<double>(n) * static_cast<double>(n - 1) / static_cast<double>(chunks);
+  row_bounds_.assign(1, 0);
+  double acc = 0.0;
+  for (std::size_t i = 0; i < n && row_bounds_.size() < chunks; ++i) {
+    acc += static_cast<double>(n - i - 1);
+    if (acc >= pairs_per_chunk * static_cast<double>(row_bounds_.size())) {
+      row_bounds_.push_back(i + 1);
+    }
+  }
+  row_bounds_.push_back(n);
+
+  partial_potential_.assign(row_bounds_.size() - 1, 0.0);
+  ParallelFor(row_bounds_.size() - 1, 1, [&](std::size_t begin, std::size_t end, std::size_t thread) {
+    double* buf = thread_acc_[thread].data();
+    for (std::size_t c = begin; c < end; ++c) {
+      partial_potential_[c] = potential ? rows(row_bounds_[c], row_bounds_[c + 1], buf, buf + n, buf + 2 * n, std::true_type{})
+                                        : rows(row_bounds_[c], row_bounds_[c + 1], buf, buf + n, buf + 2 * n, std::false_type{});
+    }
+  });
+  for (const double energy : partial_potential_) {
+    potential_energy_ += energy;
+  }
+
+  // Редукция буферов; заодно обнуляем их к следующему шагу
+  ParallelFor(n, kBodyGrain, [&](std::size_t begin, std::size_t end, std::size_t) {
+    for (auto& buffer : thread_acc_) {
+      double* buf = buffer.data();
+      for (std::size_t i = begin; i < end; ++i) {
+        p.ax[i] += static_cast<S>(buf[i]);
+        p.ay[i] += static_cast<S>(buf[n + i]);
+        p.az[i] += static_cast<S>(buf[2 * n + i]);
+        buf[i] = 0.0;
+        buf[n + i] = 0.0;
+        buf[2 * n + i] = 0.0;
+      }
+    }
+  });
+}
+
+template <typename S>
+void BasicSimulator<S>::ApplyGravityBarnesHut(bool potential) {
+  auto& p = particles_;
+  const std::size_t n = p.Size();
+  if (n < 2) {
+    return;
+  }
+
+  octree_.Build(p);
+
+  ParallelFor(n, kTargetGrain, [&](std::size_t begin, std::size_t end, std::size_t) {
+    for (std::size_t i = begin; i < end; ++i) {
+      double phi = 0.0;
+      auto acc = octree_.AccelerationOn(i, p, theta_, softening_.value, potential ? &phi : nullptr);
+      p.ax[i] += static_cast<S>(acc[0].value);
+      p.ay[i] += static_cast<S>(acc[1].value);
+      p.az[i] += static_cast<S>(acc[2].value);
+      if (potential) {
+        potential_[i] = static_cast<S>(phi);
+      }
+    }
+  });
+}
+
+template <typename S>
+void BasicSimulator<S>::ApplyGravityParticleMesh(bool potential) {
+  auto& p = particles_;
+  if (p.Size() < 2) {
+    return;
+  }
+
+  // Сетка потенциал тел наружу не отдает
+  if (potential) {
+    potential_energy_ = std::numeric_limits<double>::quiet_NaN();
+  }
+
+  mesh_.AddAccelerations(p, mesh_options_, softening_.value, p.ax.data(), p.ay.data(), p.az.data(), pool_.get());
+}
+
+template <typename S>
+void BasicSimulator<S>::UpdateNeighborList() {
+  double radius = 0.0;
+  if (gravity_solver_ == GravitySolver::kCutoff) {
+    radius = cutoff_.value;
+  }
+  if (broad_phase_ == BroadPhase::kNeighborList) {
+    radius = std::max(radius, collision_distance_.value);
+  }
+  neighbor_list_.Update(particles_, radius, skin_.value, pool_.get());
+}
+
+template <typename S>
+void BasicSimulator<S>::CutoffSum(std::size_t i, double acc[3], double* potential) const {
+  const auto& p = particles_;
+  const auto& neighbors = neighbor_list_.Neighbors();
+  const double cutoff2 = cutoff_.value * cutoff_.value;
+  const double eps2 = softening_.value * softening_.value;
+  const double xi = p.x[i];
+  const double yi = p.y[i];
+  const double zi = p.z[i];
+
+  for (std::size_t k = neighbor_list_.Start(i); k < neighbor_list_.Start(i + 1); ++k) {
+    const std::uint32_t j = neighbors[k];
+    const double dx = p.x[j] - xi;
+    const double dy = p.y[j] - yi;
+    const double dz = p.z[j] - zi;
+    const double r2 = dx * dx + dy * dy + dz * dz;
+    if (r2 == 0.0 || r2 > cutoff2) {
+      continue;
+    }
+
+    const double d2 = r2 + eps2;
+    const double w = p.mass[j] / (d2 * std::sqrt(d2));
+    acc[0] += w * dx;
+    acc[1] += w * dy;
+    acc[2] += w * dz;
+    if (potential != nullptr) {
+      *potential += w * d2;
     }
   }
 }
 
-void Simulator::ApplyGravity() {
-  const std::size_t n = objects_.size();
+template <typename S>
+void BasicSimulator<S>::ApplyGravityCutoff(bool potential) {
+  auto& p = particles_;
+  const std::size_t n = p.Size();
   if (n < 2) {
     return;
   }
 
+  UpdateNeighborList();
+
+  // Каждое тело суммирует свой список соседей само, поэтому потоки пишут в непересекающиеся куски
+  const double g = constants::kG.value;
+  ParallelFor(n, kTargetGrain, [&](std::size_t begin, std::size_t end, std::size_t) {
+    for (std::size_t i = begin; i < end; ++i) {
+      double acc[3] = {0.0, 0.0, 0.0};
+      double phi = 0.0;
+      CutoffSum(i, acc, potential ? &phi : nullptr);
+      p.ax[i] += static_cast<S>(g * acc[0]);
+      p.ay[i] += static_cast<S>(g * acc[1]);
+      p.az[i] += static_cast<S>(g * acc[2]);
+      if (potential) {
+        potential_[i] = static_cast<S>(-g * phi);
+      }
+    }
+  });
+}
+
+template <typename S>
+double BasicSimulator<S>::SumPotential() {
+  // 1/2 sum m_i phi_i; куски фиксированного размера складываются по порядку, поэтому сумма не зависит от числа потоков
+  const auto& p = particles_;
+  const std::size_t n = potential_.size();
+  partial_potential_.assign((n + kBodyGrain - 1) / kBodyGrain, 0.0);
+  ParallelFor(partial_potential_.size(), 1, [&](std::size_t begin, std::size_t end, std::size_t) {
+    for (std::size_t c = begin; c < end; ++c) {
+      double sum = 0.0;
+      for (std::size_t i = c * kBodyGrain; i < std::min(n, (c + 1) * kBodyGrain); ++i) {
+        sum += 0.5 * static_cast<double>(p.mass[i]) * static_cast<double>(potential_[i]);
+      }
+      partial_potential_[c] = sum;
+    }
+  });
+
+  double energy = 0.0;
+  for (const double sum : partial_potential_) {
+    energy += sum;
+  }
+  return energy;
+}
+
+template <typename S>
+double BasicSimulator<S>::PotentialPass() {
+  SyncParticles();
+  auto& p = particles_;
+  const std::size_t n = p.Size();
+
+  // Ускорения шага не должны меняться, поэтому проход делается поверх сохраненной копии
+  saved_acc_.resize(3 * n);
+  std::copy(p.ax.begin(), p.ax.end(), saved_acc_.begin());
+  std::copy(p.ay.begin(), p.ay.end(), saved_acc_.begin() + n);
+  std::copy(p.az.begin(), p.az.end(), saved_acc_.begin() + 2 * n);
+
+  potential_requested_ = true;
+  ComputeAccelerations();
+
+  std::copy(saved_acc_.begin(), saved_acc_.begin() + n, p.ax.begin());
+  std::copy(saved_acc_.begin() + n, saved_acc_.begin() + 2 * n, p.ay.begin());
+  std::copy(saved_acc_.begin() + 2 * n, saved_acc_.end(), p.az.begin());
+  return potential_energy_;
+}
+
+template <typename S>
+void BasicSimulator<S>::CompletePotential() {
+  if (potential_pending_) {
+    PotentialPass();
+  }
+}
+
+template <typename S>
+bool BasicSimulator<S>::ForcesAtStepStart() const {
+  if (collision_mode_ == CollisionMode::kEventDriven) {
+    return true;
+  }
+  if (block_max_level_ > 0 || integrator_ == Integrator::kVelocityVerlet) {
+    return !accelerations_valid_;
+  }
+  return integrator_ == Integrator::kSemiImplicitEuler || integrator_ == Integrator::kRungeKutta4;
+}
+
+template <typename S>
+Diagnostics BasicSimulator<S>::Moments() {
+  const auto& p = particles_;
+  const std::size_t n = p.Size();
+
+  partial_moments_.assign((n + kBodyGrain - 1) / kBodyGrain, Diagnostics{});
+  ParallelFor(partial_moments_.size(), 1, [&](std::size_t begin, std::size_t end, std::size_t) {
+    for (std::size_t c = begin; c < end; ++c) {
+      Diagnostics& d = partial_moments_[c];
+      for (std::size_t i = c * kBodyGrain; i < std::min(n, (c + 1) * kBodyGrain); ++i) {
+        const double m = p.mass[i];
+        const double r[3] = {p.x[i], p.y[i], p.z[i]};
+        const double v[3] = {p.vx[i], p.vy[i], p.vz[i]};
+
+        d.mass += m;
+        d.kinetic += 0.5 * m * (v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+        for (std::size_t k = 0; k < 3; ++k) {
+          d.momentum[k] += m * v[k];
+          d.center_of_mass[k] += m * r[k];
+        }
+        d.angular_momentum[0] += m * (r[1] * v[2] - r[2] * v[1]);
+        d.angular_momentum[1] += m * (r[2] * v[0] - r[0] * v[2]);
+        d.angular_momentum[2] += m * (r[0] * v[1] - r[1] * v[0]);
+      }
+    }
+  });
+
+  Diagnostics total;
+  total.step = step_count_;
+  total.time = elapsed_time_.value;
+  for (const auto& d : partial_moments_) {
+    total.mass += d.mass;
+    total.kinetic += d.kinetic;
+    for (std::size_t k = 0; k < 3; ++k) {
+      total.momentum[k] += d.momentum[k];
+      total.angular_momentum[k] += d.angular_momentum[k];
+      total.center_of_mass[k] += d.center_of_mass[k];
+    }
+  }
+  if (total.mass > 0.0) {
+    for (double& c : total.center_of_mass) {
+      c /= total.mass;
+    }
+  }
+  return total;
+}
+
+template <typename S>
+const std::vector<Diagnostics>& BasicSimulator<S>::DiagnosticsSeries() {
+  CompletePotential();
+  return diagnostics_;
+}
+
+template <typename S>
+Diagnostics BasicSimulator<S>::ComputeDiagnostics() {
+  SyncParticles();
+  Diagnostics d = Moments();
+  d.potential = PotentialPass();
+  return d;
+}
+
+template <typename S>
+void BasicSimulator<S>::Integrate(units::Time dt) {
+  auto& p = particles_;
+  const std::size_t n = p.Size();
+  const auto h = static_cast<S>(dt.value);
+
+  StatsScope scope(stats_, StepPhase::kIntegration);
+  // Полунеявный Эйлер, как в Object::Update
+  ParallelFor(n, kBodyGrain, [&p, h](std::size_t begin, std::size_t end, std::size_t) {
+    for (std::size_t i = begin; i < end; ++i) {
+      p.vx[i] += p.ax[i] * h;
+      p.x[i] += p.vx[i] * h;
+    }
+    for (std::size_t i = begin; i < end; ++i) {
+      p.vy[i] += p.ay[i] * h;
+      p.y[i] += p.vy[i] * h;
+    }
+    for (std::size_t i = begin; i < end; ++i) {
+      p.vz[i] += p.az[i] * h;
+      p.z[i] += p.vz[i] * h;
+    }
+  });
+}
+
+template <typename S>
+void BasicSimulator<S>::Kick(double dt) {
+  StatsScope scope(stats_, StepPhase::kIntegration);
+  auto& p = particles_;
+  const auto h = static_cast<S>(dt);
+  ParallelFor(p.Size(), kBodyGrain, [&p, h](std::size_t begin, std::size_t end, std::size_t) {
+    for (std::size_t i = begin; i < end; ++i) {
+      p.vx[i] += p.ax[i] * h;
+      p.vy[i] += p.ay[i] * h;
+      p.vz[i] += p.az[i] * h;
+    }
+  });
+}
+
+template <typename S>
+void BasicSimulator<S>::Drift(double dt) {
+  StatsScope scope(stats_, StepPhase::kIntegration);
+  auto& p = particles_;
+  const auto h = static_cast<S>(dt);
+  ParallelFor(p.Size(), kBodyGrain, [&p, h](std::size_t begin, std::size_t end, std::size_t) {
+    for (std::size_t i = begin; i < end; ++i) {
+      p.x[i] += p.vx[i] * h;
+      p.y[i] += p.vy[i] * h;
+      p.z[i] += p.vz[i] * h;
+    }
+  });
+}
+
+template <typename S>
+void BasicSimulator<S>::StepRungeKutta4(double h) {
+  auto& p = particles_;
+  const std::size_t n = p.Size();
+
+  // Блоки по n значений: x, y, z, vx, vy, vz
+  rk_state_.resize(6 * n);
+  rk_sum_.assign(6 * n, 0.0);
+
+  S* state[6] = {p.x.data(), p.y.data(), p.z.data(), p.vx.data(), p.vy.data(), p.vz.data()};
+  const S* acc[3] = {p.ax.data(), p.ay.data(), p.az.data()};
+  S* start = rk_state_.data();
+  S* sum = rk_sum_.data();
+
+  for (std::size_t k = 0; k < 6; ++k) {
+    std::copy(state[k], state[k] + n, start + k * n);
+  }
+
+  constexpr S kWeight[4] = {1, 2, 2, 1};
+  constexpr S kNext[3] = {0.5, 0.5, 1};
+  const auto step = static_cast<S>(h);
+
+  for (std::size_t stage = 0; stage < 4; ++stage) {
+    ComputeAccelerations();
+
+    // Наклон стадии: (v, a) в текущей пробной точке
+    StatsScope scope(stats_, StepPhase::kIntegration);
+    ParallelFor(n, kBodyGrain, [&](std::size_t begin, std::size_t end, std::size_t) {
+      for (std::size_t c = 0; c < 3; ++c) {
+        S* pos = state[c];
+        S* vel = state[3 + c];
+        const S* a = acc[c];
+        S* pos0 = start + c * n;
+        S* vel0 = start + (3 + c) * n;
+        S* sum_pos = sum + c * n;
+        S* sum_vel = sum + (3 + c) * n;
+
+        for (std::size_t i = begin; i < end; ++i) {
+          sum_pos[i] += kWeight[stage] * vel[i];
+          sum_vel[i] += kWeight[stage] * a[i];
+
+          if (stage < 3) {
+            const S t = kNext[stage] * step;
+            pos[i] = pos0[i] + t * vel[i];
+            vel[i] = vel0[i] + t * a[i];
+          } else {
+            pos[i] = pos0[i] + step / 6 * sum_pos[i];
+            vel[i] = vel0[i] + step / 6 * sum_vel[i];
+          }
+        }
+      }
+    });
+  }
+}
+
+template <typename S>
+void BasicSimulator<S>::ComputeActiveAccelerations() {
+  StatsScope scope(stats_, StepPhase::kGravity);
+  ActiveForces();
+}
+
+template <typename S>
+void BasicSimulator<S>::ComputeAwakeAccelerations() {
+  active_.assign(awake_.begin(), awake_.end());
+  ActiveForces();
+
+  auto& p = particles_;
+  const std::size_t m = active_.size();
+  for (std::size_t a = 0; a < m; ++a) {
+    p.ax[active_[a]] = active_acc_[a];
+    p.ay[active_[a]] = active_acc_[m + a];
+    p.az[active_[a]] = active_acc_[2 * m + a];
+  }
+}
+
+template <typename S>
+void BasicSimulator<S>::ActiveForces() {
+  const std::size_t m = active_.size();
+  active_acc_.assign(3 * m, 0.0);
+  if (use_gravity_ && particles_.Size() >= 2) {
+    ApplyActiveGravity();
+  }
+
+  // Строк пружин у активных тел немного, поэтому они считаются в одном потоке
+  if (!springs_.Empty()) {
+    for (std::size_t a = 0; a < m; ++a) {
+      double acc[3] = {0.0, 0.0, 0.0};
+      springs_.AccelerationOn(active_[a], particles_, acc);
+      active_acc_[a] += static_cast<S>(acc[0]);
+      active_acc_[m + a] += static_cast<S>(acc[1]);
+      active_acc_[2 * m + a] += static_cast<S>(acc[2]);
+    }
+  }
+}
+
+template <typename S>
+void BasicSimulator<S>::ApplyActiveGravity() {
+  auto& p = particles_;
+  const std::size_t n = p.Size();
+  const std::size_t m = active_.size();
+
+  S* ax = active_acc_.data();
+  S* ay = ax + m;
+  S* az = ay + m;
+
+  if (gravity_solver_ == GravitySolver::kBarnesHut) {
+    octree_.Build(p);
+
+    ParallelFor(m, kTargetGrain, [&](std::size_t begin, std::size_t end, std::size_t) {
+      for (std::size_t a = begin; a < end; ++a) {
+        auto acc = octree_.AccelerationOn(active_[a], p, theta_, softening_.value);
+        ax[a] = static_cast<S>(acc[0].value);
+        ay[a] = static_cast<S>(acc[1].value);
+        az[a] = static_cast<S>(acc[2].value);
+      }
+    });
+    return;
+  }
+
+  if (gravity_solver_ == GravitySolver::kCutoff) {
+    UpdateNeighborList();
+
+    const double g = constants::kG.value;
+    ParallelFor(m, kTargetGrain, [&](std::size_t begin, std::size_t end, std::size_t) {
+      for (std::size_t a = begin; a < end; ++a) {
+        double acc[3] = {0.0, 0.0, 0.0};
+        CutoffSum(active_[a], acc, nullptr);
+        ax[a] = static_cast<S>(g * acc[0]);
+        ay[a] = static_cast<S>(g * acc[1]);
+        az[a] = static_cast<S>(g * acc[2]);
+      }
+    });
+    return;
+  }
+
+  // Сетка все равно решается целиком, активным телам достаются их значения
+  if (gravity_solver_ == GravitySolver::kParticleMesh) {
+    mesh_acc_.assign(3 * n, 0.0);
+    mesh_.AddAccelerations(p, mesh_options_, softening_.value, mesh_acc_.data(), mesh_acc_.data() + n, mesh_acc_.data() + 2 * n, pool_.get());
+
+    for (std::size_t a = 0; a < m; ++a) {
+      ax[a] = mesh_acc_[active_[a]];
+      ay[a] = mesh_acc_[n + active_[a]];
+      az[a] = mesh_acc_[2 * n + active_[a]];
+    }
+    return;
+  }
+
+  // Активные тела собираются в плотный массив целей, источники - все тела
+  active_pos_.resize(3 * m);
+  S* x = active_pos_.data();
+  S* y = x + m;
+  S* z = y + m;
+
+  BasicGravitySources<S> sources{p.x.data(), p.y.data(), p.z.data(), p.mass.data(), n};
+  ParallelFor(m, kTargetGrain, [&](std::size_t begin, std::size_t end, std::size_t) {
+    for (std::size_t a = begin; a < end; ++a) {
+      x[a] = p.x[active_[a]];
+      y[a] = p.y[active_[a]];
+      z[a] = p.z[active_[a]];
+    }
+
+    BasicGravityTargets<S> targets{x + begin, y + begin, z + begin, ax + begin, ay + begin, az + begin, end - begin};
+    AccumulateGravity(kernel_isa_, sources, targets, softening_.value, double_accumulators_);
+  });
+}
+
+template <typename S>
+std::size_t BasicSimulator<S>::BlockLevel(double dt, double acc, double jerk) const {
+  std::size_t level = 0;
+  if (jerk > 0.0) {
+    const double limit = block_eta_ * acc / jerk;
+    while (level < block_max_level_ && std::ldexp(dt, -static_cast<int>(level)) > limit) {
+      ++level;
+    }
+  }
+  return level;
+}
+
+template <typename S>
+void BasicSimulator<S>::EstimateBlockLevels(double dt) {
+  auto& p = particles_;
+  const std::size_t n = p.Size();
+  active_.clear();
+  for (std::size_t i = 0; i < n; ++i) {
+    if (levels_[i] == kUnknownLevel) {
+      active_.push_back(i);
+    }
+  }
+  if (active_.empty()) {
+    return;
+  }
+
+  // У новых тел и тел после удара нет истории ускорений: рывок берем из сил после пробного дрейфа на самый мелкий подшаг
+  const double tau = std::ldexp(dt, -static_cast<int>(block_max_level_));
+  probe_pos_.resize(3 * n);
+  std::copy(p.x.begin(), p.x.end(), probe_pos_.begin());
+  std::copy(p.y.begin(), p.y.end(), probe_pos_.begin() + n);
+  std::copy(p.z.begin(), p.z.end(), probe_pos_.begin() + 2 * n);
+  Drift(tau);
+  ComputeActiveAccelerations();
+  std::copy(probe_pos_.begin(), probe_pos_.begin() + n, p.x.begin());
+  std::copy(probe_pos_.begin() + n, probe_pos_.begin() + 2 * n, p.y.begin());
+  std::copy(probe_pos_.begin() + 2 * n, probe_pos_.end(), p.z.begin());
+
+  const std::size_t m = active_.size();
+  for (std::size_t a = 0; a < m; ++a) {
+    const std::size_t i = active_[a];
+    const double dax = active_acc_[a] - p.ax[i];
+    const double day = active_acc_[m + a] - p.ay[i];
+    const double daz = active_acc_[2 * m + a] - p.az[i];
+    const double jerk = std::sqrt(dax * dax + day * day + daz * daz) / tau;
+    const double acc = std::sqrt(static_cast<double>(p.ax[i] * p.ax[i] + p.ay[i] * p.ay[i] + p.az[i] * p.az[i]));
+    levels_[i] = BlockLevel(dt, acc, jerk);
+  }
+}
+
+template <typename S>
+void BasicSimulator<S>::StepBlock(double dt) {
+  auto& p = particles_;
+  const std::size_t n = p.Size();
+  const std::size_t max_level = block_max_level_;
+  const std::uint64_t ticks = std::uint64_t{1} << max_level;
+  const double tick = std::ldexp(dt, -static_cast<int>(max_level));
+
+  if (levels_.size() != n) {
+    levels_.assign(n, kUnknownLevel);
+  }
+  if (!accelerations_valid_) {
+    ComputeAccelerations();
+  }
+  EstimateBlockLevels(dt);
+
+  // Тела по уровням: на подшаге активны целые корзины от некоторого уровня и мельче
+  level_bodies_.resize(max_level + 1);
+  for (auto& bucket : level_bodies_) {
+    bucket.clear();
+  }
+  for (std::size_t i = 0; i < n; ++i) {
+    level_bodies_[levels_[i]].push_back(i);
+  }
+
+  auto step_of = [dt](std::size_t level) { return std::ldexp(dt, -static_cast<int>(level)); };
+
+  // В начале шага все тела синхронны, открывающий полуудар получают все
+  {
+    StatsScope scope(stats_, StepPhase::kIntegration);
+    ParallelFor(n, kBodyGrain, [&](std::size_t begin, std::size_t end, std::size_t) {
+      for (std::size_t i = begin; i < end; ++i) {
+        const double h = 0.5 * step_of(levels_[i]);
+        p.vx[i] += p.ax[i] * h;
+        p.vy[i] += p.ay[i] * h;
+        p.vz[i] += p.az[i] * h;
+      }
+    });
+  }
+
+  std::uint64_t k = 0;
+  while (k < ticks) {
+    // Раньше границы самого мелкого занятого уровня ни одно тело шаг не заканчивает, поэтому дрейфуем сразу до нее
+    std::size_t finest = max_level;
+    while (finest > 0 && level_bodies_[finest].empty()) {
+      --finest;
+    }
+    const std::uint64_t stride = ticks >> finest;
+    const std::uint64_t next = (k / stride + 1) * stride;
+    // Положения нужны всем источникам, поэтому дрейфуют все тела
+    Drift(static_cast<double>(next - k) * tick);
+    k = next;
+
+    // Тело уровня L заканчивает шаг каждые ticks / 2^L подшагов, то есть активны уровни от first и мельче; на последнем - все
+    const std::size_t first = k == ticks ? 0 : max_level - static_cast<std::size_t>(std::countr_zero(k));
+    active_.clear();
+    for (std::size_t level = first; level <= max_level; ++level) {
+      active_.insert(active_.end(), level_bodies_[level].begin(), level_bodies_[level].end());
+      level_bodies_[level].clear();
+    }
+
+    ComputeActiveAccelerations();
+
+    const std::size_t m = active_.size();
+    const S* ax = active_acc_.data();
+    const S* ay = ax + m;
+    const S* az = ay + m;
+
+    StatsScope scope(stats_, StepPhase::kIntegration);
+    stats_.AddBodies(m);
+    ParallelFor(m, kTargetGrain, [&](std::size_t begin, std::size_t end, std::size_t) {
+      for (std::size_t a = begin; a < end; ++a) {
+        const std::size_t i = active_[a];
+        const std::size_t level = levels_[i];
+        const double h = step_of(level);
+
+        // Закрывающий полуудар
+        p.vx[i] += ax[a] * 0.5 * h;
+        p.vy[i] += ay[a] * 0.5 * h;
+        p.vz[i] += az[a] * 0.5 * h;
+
+        // Рывок оцениваем по изменению ускорения за прошедший шаг тела
+        const double dax = ax[a] - p.ax[i];
+        const double day = ay[a] - p.ay[i];
+        const double daz = az[a] - p.az[i];
+        const double jerk = std::sqrt(dax * dax + day * day + daz * daz) / h;
+        const double acc = std::sqrt(ax[a] * ax[a] + ay[a] * ay[a] + az[a] * az[a]);
+        std::size_t next_level = BlockLevel(dt, acc, jerk);
+
+        // Укрупнять шаг можно на один уровень за раз и только на границе более крупного шага
+        if (next_level < level) {
+          next_level = k % (ticks >> (level - 1)) == 0 ? level - 1 : level;
+        }
+        levels_[i] = next_level;
+
+        p.ax[i] = ax[a];
+        p.ay[i] = ay[a];
+        p.az[i] = az[a];
+
+        if (k < ticks) {
+          const double h_next = 0.5 * step_of(next_level);
+          p.vx[i] += p.ax[i] * h_next;
+          p.vy[i] += p.ay[i] * h_next;
+          p.vz[i] += p.az[i] * h_next;
+        }
+      }
+    });
+
+    // Новый уровень активного тела не крупнее first, поэтому корзины неактивных тел остаются верными
+    for (const std::size_t i : active_) {
+      level_bodies_[levels_[i]].push_back(i);
+    }
+  }
+}
+
+template <typename S>
+void BasicSimulator<S>::HandleElasticCollision(object::Object& a, object::Object& b) {
+  double pa[3];
+  double va[3];
+  double pb[3];
+  double vb[3];
+  for (std::size_t k = 0; k < 3; ++k) {
+    pa[k] = a.position[k].value;
+    va[k] = a.speed[k].value;
+    pb[k] = b.position[k].value;
+    vb[k] = b.speed[k].value;
+  }
+
+  if (!ResolveElastic(pa, va, a.weight.value, pb, vb, b.weight.value, collision_distance_.value)) {
+    return;
+  }
+
+  for (std::size_t k = 0; k < 3; ++k) {
+    a.position[k].value = pa[k];
+    a.speed[k].value = va[k];
+    b.position[k].value = pb[k];
+    b.speed[k].value = vb[k];
+  }
+}
+
+template <typename S>
+bool BasicSimulator<S>::ResolveCollision(std::size_t i, std::size_t j) {
+  if (!ResolvePair(i, j)) {
+    return false;
+  }
+  stats_.AddCollisions(1);
+
+  if (sleeping_ > 0) {
+    Wake(i);
+    Wake(j);
+  }
+  return true;
+}
+
+// Меняет только тела i и j, поэтому удары с разными телами можно решать из разных потоков
+template <typename S>
+bool BasicSimulator<S>::ResolvePair(std::size_t i, std::size_t j) {
+  auto& p = particles_;
+  double pa[3] = {p.x[i], p.y[i], p.z[i]};
+  double va[3] = {p.vx[i], p.vy[i], p.vz[i]};
+  double pb[3] = {p.x[j], p.y[j], p.z[j]};
+  double vb[3] = {p.vx[j], p.vy[j], p.vz[j]};
+
+  if (!ResolveElastic(pa, va, p.mass[i], pb, vb, p.mass[j], collision_distance_.value)) {
+    return false;
+  }
+
+  p.x[i] = static_cast<S>(pa[0]);
+  p.y[i] = static_cast<S>(pa[1]);
+  p.z[i] = static_cast<S>(pa[2]);
+  p.vx[i] = static_cast<S>(va[0]);
+  p.vy[i] = static_cast<S>(va[1]);
+  p.vz[i] = static_cast<S>(va[2]);
+  p.x[j] = static_cast<S>(pb[0]);
+  p.y[j] = static_cast<S>(pb[1]);
+  p.z[j] = static_cast<S>(pb[2]);
+  p.vx[j] = static_cast<S>(vb[0]);
+  p.vy[j] = static_cast<S>(vb[1]);
+  p.vz[j] = static_cast<S>(vb[2]);
+
+  // Удар резко меняет скорость, поэтому уровни блочных шагов тел оцениваются заново в начале следующего шага
+  if (i < levels_.size() && j < levels_.size()) {
+    levels_[i] = kUnknownLevel;
+    levels_[j] = kUnknownLevel;
+  }
+  return true;
+}
+
+template <typename S>
+void BasicSimulator<S>::HandleCollisions() {
+  CompletePotential();
+  SyncBodies();
+  HandleDiscreteCollisions();
+}
+
+template <typename S>
+void BasicSimulator<S>::HandleDiscreteCollisions() {
+  StatsScope scope(stats_, StepPhase::kCollisions);
+
+  auto& p = particles_;
+  const std::size_t n = p.Size();
+  const double distance = collision_distance_.value;
+  bool changed = false;
+
+  auto distance2 = [&p](std::size_t i, std::size_t j) {
+    const double dx = p.x[j] - p.x[i];
+    const double dy = p.y[j] - p.y[i];
+    const double dz = p.z[j] - p.z[i];
+    return dx * dx + dy * dy + dz * dz;
+  };
+
+  // В последовательном порядке удар разрешается сразу, иначе пара становится ребром графа контактов
+  const bool colored = contact_order_ == ContactOrder::kColored;
+  contacts_.clear();
+  auto contact = [&](std::size_t i, std::size_t j) {
+    if (colored) {
+      contacts_.emplace_back(static_cast<std::uint32_t>(i), static_cast<std::uint32_t>(j));
+    } else {
+      changed = ResolveCollision(i, j) || changed;
+    }
+  };
+
+  if (broad_phase_ == BroadPhase::kBruteForce) {
+    stats_.AddPairs(n > 1 ? n * (n - 1) / 2 : 0);
+    for (std::size_t i = 0; i < n; ++i) {
+      for (std::size_t j = i + 1; j < n; ++j) {
+        if (sleeping_ > 0 && asleep_[i] != 0 && asleep_[j] != 0) {
+          continue;
+        }
+        if (std::sqrt(distance2(i, j)) <= distance) {
+          contact(i, j);
+        }
+      }
+    }
+  } else {
+    // Списки соседей хранят пары с запасом, лишние отсекает проверка расстояния ниже
+    const std::vector<SpatialHash::Pair>* pairs = &pairs_;
+    if (broad_phase_ == BroadPhase::kSweepAndPrune) {
+      sweep_and_prune_.FindPairs(p, distance, pairs_);
+    } else if (broad_phase_ == BroadPhase::kNeighborList) {
+      UpdateNeighborList();
+      pairs = &neighbor_list_.Pairs();
+    } else {
+      spatial_hash_.FindPairs(p, distance, pairs_, pool_.get());
+    }
+
+    // Пары обрабатываются в том же порядке, что и при переборе, но собраны до ударов: контакт, который создал
+    // сдвиг тела предыдущим ударом, сюда не попадет. Сдвиг может и разнести пару, поэтому расстояние проверяем заново
+    const double dist2 = distance * distance;
+    stats_.AddPairs(pairs->size());
+    for (const auto& [i, j] : *pairs) {
+      if (sleeping_ > 0 && asleep_[i] != 0 && asleep_[j] != 0) {
+        continue;
+      }
+      if (distance2(i, j) <= dist2) {
+        contact(i, j);
+      }
+    }
+  }
+
+  if (colored) {
+    changed = ResolveContacts();
+  }
+
+  if (changed) {
+    storage_ = Storage::kParticles;
+    accelerations_valid_ = false;
+  }
+}
+
+template <typename S>
+bool BasicSimulator<S>::ResolveContacts() {
+  auto& p = particles_;
+  const std::size_t m = contacts_.size();
+  if (m == 0) {
+    return false;
+  }
+
+  // Жадная раскраска в порядке обнаружения: контакт получает наименьший цвет, свободный у обоих тел
+  // Цветов не больше 64 по маске на тело; контакты тел, у которых они кончились, идут последним цветом по одному
+  constexpr std::size_t kColors = 64;
+  body_colors_.resize(p.Size(), 0);
+  contact_color_.resize(m);
+  color_start_.assign(kColors + 2, 0);
+  for (std::size_t c = 0; c < m; ++c) {
+    const auto [i, j] = contacts_[c];
+    const std::uint64_t used = body_colors_[i] | body_colors_[j];
+    const std::size_t color = std::countr_one(used);
+    if (color < kColors) {
+      body_colors_[i] |= std::uint64_t{1} << color;
+      body_colors_[j] |= std::uint64_t{1} << color;
+    }
+    contact_color_[c] = static_cast<std::uint8_t>(color);
+    ++color_start_[color + 1];
+  }
+  for (std::size_t color = 0; color <= kColors; ++color) {
+    color_start_[color + 1] += color_start_[color];
+  }
+
+  colored_.resize(m);
+  std::vector<std::size_t> cursor(color_start_.begin(), color_start_.end() - 1);
+  for (std::size_t c = 0; c < m; ++c) {
+    colored_[cursor[contact_color_[c]]++] = contacts_[c];
+    body_colors_[contacts_[c].first] = 0;
+    body_colors_[contacts_[c].second] = 0;
+  }
+
+  // Предыдущие цвета могли сдвинуть тела, поэтому расстояние проверяем заново, как и в последовательном порядке
+  const double dist2 = collision_distance_.value * collision_distance_.value;
+  resolved_.assign(m, 0);
+  auto resolve = [&](std::size_t begin, std::size_t end) {
+    for (std::size_t c = begin; c < end; ++c) {
+      const auto [i, j] = colored_[c];
+      const double dx = p.x[j] - p.x[i];
+      const double dy = p.y[j] - p.y[i];
+      const double dz = p.z[j] - p.z[i];
+      if (dx * dx + dy * dy + dz * dz <= dist2) {
+        resolved_[c] = ResolvePair(i, j) ? 1 : 0;
+      }
+    }
+  };
+  for (std::size_t color = 0; color < kColors; ++color) {
+    const std::size_t first = color_start_[color];
+    ParallelFor(color_start_[color + 1] - first, kContactGrain,
+                [&](std::size_t begin, std::size_t end, std::size_t) { resolve(first + begin, first + end); });
+  }
+  resolve(color_start_[kColors], m);
+
+  // Счетчики и пробуждение общие для всех тел, поэтому они идут после всех цветов в одном потоке
+  std::size_t count = 0;
+  for (std::size_t c = 0; c < m; ++c) {
+    if (resolved_[c] == 0) {
+      continue;
+    }
+    ++count;
+    if (sleeping_ > 0) {
+      Wake(colored_[c].first);
+      Wake(colored_[c].second);
+    }
+  }
+  stats_.AddCollisions(count);
+  return count > 0;
+}
+
+template <typename S>
+void BasicSimulator<S>::FindCandidatePairs(double distance) {
+  // Радиус поиска меняется от шага к шагу, поэтому sweep-and-prune и списки соседей здесь заменяются хеш-сеткой
+  if (broad_phase_ != BroadPhase::kBruteForce) {
+    spatial_hash_.FindPairs(particles_, distance, pairs_, pool_.get());
+    return;
+  }
+
+  const auto& p = particles_;
+  const std::size_t n = p.Size();
+  const double dist2 = distance * distance;
+
+  pairs_.clear();
   for (std::size_t i = 0; i < n; ++i) {
     for (std::size_t j = i + 1; j < n; ++j) {
-      auto fij = objects_[i].GravitationalForceVector(objects_[j]);
+      const double dx = p.x[j] - p.x[i];
+      const double dy = p.y[j] - p.y[i];
+      const double dz = p.z[j] - p.z[i];
+      if (dx * dx + dy * dy + dz * dz <= dist2) {
+        pairs_.emplace_back(static_cast<std::uint32_t>(i), static_cast<std::uint32_t>(j));
+      }
+    }
+  }
+}
+
+template <typename S>
+void BasicSimulator<S>::SaveStepStart() {
+  const auto& p = particles_;
+  const std::size_t n = p.Size();
+
+  step_start_.resize(3 * n);
+  std::copy(p.x.begin(), p.x.end(), step_start_.begin());
+  std::copy(p.y.begin(), p.y.end(), step_start_.begin() + static_cast<std::ptrdiff_t>(n));
+  std::copy(p.z.begin(), p.z.end(), step_start_.begin() + static_cast<std::ptrdiff_t>(2 * n));
+}
+
+template <typename S>
+void BasicSimulator<S>::HandleContinuousCollisions(double h) {
+  StatsScope scope(stats_, StepPhase::kCollisions);
+  auto& p = particles_;
+  const std::size_t n = p.Size();
+  const double distance = collision_distance_.value;
+  if (n < 2 || distance <= 0.0) {
+    return;
+  }
+
+  const S* x0 = step_start_.data();
+  const S* y0 = x0 + n;
+  const S* z0 = y0 + n;
+
+  // Два тела могут коснуться за шаг, только если в конце шага они ближе distance плюс оба смещения
+  double max_shift2 = 0.0;
+  for (std::size_t i = 0; i < n; ++i) {
+    const double dx = p.x[i] - x0[i];
+    const double dy = p.y[i] - y0[i];
+    const double dz = p.z[i] - z0[i];
+    max_shift2 = std::max(max_shift2, dx * dx + dy * dy + dz * dz);
+  }
+  FindCandidatePairs(distance + 2.0 * std::sqrt(max_shift2));
+  stats_.AddPairs(pairs_.size());
+
+  // Тела движутся по отрезку от начала к концу шага, время удара - доля шага
+  impacts_.clear();
+  for (const auto& [i, j] : pairs_) {
+    const double d[3] = {x0[j] - x0[i], y0[j] - y0[i], z0[j] - z0[i]};
+    const double w[3] = {p.x[j] - x0[j] - p.x[i] + x0[i], p.y[j] - y0[j] - p.y[i] + y0[i], p.z[j] - z0[j] - p.z[i] + z0[i]};
+    const double s = TimeOfImpact(d, w, distance);
+    if (s <= 1.0) {
+      impacts_.push_back({s, i, j, 0, 0});
+    }
+  }
+  std::sort(impacts_.begin(), impacts_.end(), [](const Impact& a, const Impact& b) { return b > a; });
+
+  // После первого удара траектория тела уже не отрезок, его остальные удары за шаг ловит дискретная проверка
+  collided_.assign(n, 0);
+  for (const auto& impact : impacts_) {
+    const std::size_t i = impact.i;
+    const std::size_t j = impact.j;
+    if (collided_[i] != 0 || collided_[j] != 0) {
+      continue;
+    }
+
+    const double end[6] = {p.x[i], p.y[i], p.z[i], p.x[j], p.y[j], p.z[j]};
+    const double s = impact.time;
+
+    p.x[i] = x0[i] + s * (end[0] - x0[i]);
+    p.y[i] = y0[i] + s * (end[1] - y0[i]);
+    p.z[i] = z0[i] + s * (end[2] - z0[i]);
+    p.x[j] = x0[j] + s * (end[3] - x0[j]);
+    p.y[j] = y0[j] + s * (end[4] - y0[j]);
+    p.z[j] = z0[j] + s * (end[5] - z0[j]);
+
+    if (!ResolveCollision(i, j)) {
+      p.x[i] = end[0];
+      p.y[i] = end[1];
+      p.z[i] = end[2];
+      p.x[j] = end[3];
+      p.y[j] = end[4];
+      p.z[j] = end[5];
+      continue;
+    }
+
+    // Остаток шага тела летят с новыми скоростями
+    const double rest = (1.0 - s) * h;
+    for (const std::size_t k : {i, j}) {
+      p.x[k] += p.vx[k] * rest;
+      p.y[k] += p.vy[k] * rest;
+      p.z[k] += p.vz[k] * rest;
+      collided_[k] = 1;
+    }
+    accelerations_valid_ = false;
+  }
+}
+
+template <typename S>
+void BasicSimulator<S>::DriftEventDriven(double h) {
+  auto& p = particles_;
+  const std::size_t n = p.Size();
+  const double distance = collision_distance_.value;
+  if (n < 2 || distance <= 0.0) {
+    Drift(h);
+    return;
+  }
+
+  // Свободный полет и удары здесь неразделимы, все время идет в фазу столкновений
+  StatsScope scope(stats_, StepPhase::kCollisions);
+  body_time_.assign(n, 0.0);
+  collision_count_.assign(n, 0);
+
+  auto advance = [&](std::size_t k, double t) {
+    const double dt = t - body_time_[k];
+    p.x[k] += p.vx[k] * dt;
+    p.y[k] += p.vy[k] * dt;
+    p.z[k] += p.vz[k] * dt;
+    body_time_[k] = t;
+  };
+
+  auto speed2 = [&](std::size_t k) -> double { return p.vx[k] * p.vx[k] + p.vy[k] * p.vy[k] + p.vz[k] * p.vz[k]; };
+
+  std::priority_queue<Impact, std::vector<Impact>, std::greater<>> queue;
+
+  auto predict = [&](std::size_t a, std::size_t b, double now) {
+    const std::size_t i = std::min(a, b);
+    const std::size_t j = std::max(a, b);
+    const double ti = now - body_time_[i];
+    const double tj = now - body_time_[j];
+    const double d[3] = {p.x[j] + p.vx[j] * tj - p.x[i] - p.vx[i] * ti, p.y[j] + p.vy[j] * tj - p.y[i] - p.vy[i] * ti,
+                         p.z[j] + p.vz[j] * tj - p.z[i] - p.vz[i] * ti};
+    const double w[3] = {p.vx[j] - p.vx[i], p.vy[j] - p.vy[i], p.vz[j] - p.vz[i]};
+    const double t = now + TimeOfImpact(d, w, distance);
+    stats_.AddPairs(1);
+    if (t <= h) {
+      queue.push({t, static_cast<std::uint32_t>(i), static_cast<std::uint32_t>(j), collision_count_[i], collision_count_[j]});
+    }
+  };
 
-      objects_[i].ApplyForce(fij);
+  // Соседи - пары, которые могут сблизиться до конца шага при скорости не выше speed_bound
+  double speed_bound = 0.0;
+  auto rebuild = [&](double now) {
+    double max_speed2 = 0.0;
+    for (std::size_t k = 0; k < n; ++k) {
+      advance(k, now);
+      max_speed2 = std::max(max_speed2, speed2(k));
+    }
+    speed_bound = std::sqrt(max_speed2);
+    FindCandidatePairs(distance + 2.0 * speed_bound * (h - now));
+
+    neighbor_start_.assign(n + 1, 0);
+    for (const auto& [i, j] : pairs_) {
+      ++neighbor_start_[i + 1];
+      ++neighbor_start_[j + 1];
+    }
+    for (std::size_t k = 0; k < n; ++k) {
+      neighbor_start_[k + 1] += neighbor_start_[k];
+    }
+    neighbors_.resize(neighbor_start_[n]);
+    std::vector<std::size_t> cursor(neighbor_start_.begin(), neighbor_start_.end() - 1);
+    for (const auto& [i, j] : pairs_) {
+      neighbors_[cursor[i]++] = j;
+      neighbors_[cursor[j]++] = i;
+    }
+
+    queue = {};
+    for (const auto& [i, j] : pairs_) {
+      predict(i, j, now);
+    }
+  };
+
+  rebuild(0.0);
+
+  while (!queue.empty()) {
+    const Impact impact = queue.top();
+    queue.pop();
+
+    const std::size_t i = impact.i;
+    const std::size_t j = impact.j;
+
+    // После удара тела о кого-то еще его старые прогнозы недействительны
+    if (impact.count_i != collision_count_[i] || impact.count_j != collision_count_[j]) {
+      continue;
+    }
+
+    advance(i, impact.time);
+    advance(j, impact.time);
+    if (!ResolveCollision(i, j)) {
+      continue;
+    }
+    ++collision_count_[i];
+    ++collision_count_[j];
 
-      vector::Vector<units::Force, 3> fji{};
-      for (std::size_t k = 0; k < 3; ++k) {
-        fji[k] = units::Force{-fij[k].value};
+    // Удар разогнал тело быстрее оценки, по которой искали соседей
+    const double bound2 = speed_bound * speed_bound;
+    if (speed2(i) > bound2 || speed2(j) > bound2) {
+      rebuild(impact.time);
+      continue;
+    }
+
+    for (const std::size_t k : {i, j}) {
+      for (std::size_t e = neighbor_start_[k]; e < neighbor_start_[k + 1]; ++e) {
+        predict(k, neighbors_[e], impact.time);
       }
-      objects_[j].ApplyForce(fji);
     }
   }
+
+  for (std::size_t k = 0; k < n; ++k) {
+    advance(k, h);
+  }
+}
+
+template <typename S>
+void BasicSimulator<S>::SetSleeping(units::Speed speed, units::Acceleration acceleration, std::size_t steps) {
+  sleep_speed_ = speed;
+  sleep_acceleration_ = acceleration;
+  sleep_steps_ = steps;
+  if (steps == 0) {
+    WakeAll();
+  }
 }
 
-void Simulator::HandleElasticCollision(object::Object& a, object::Object& b) {
-  using physics::units::Length;
-  using physics::units::Speed;
-  using physics::vector::Vector;
+template <typename S>
+void BasicSimulator<S>::WakeUp(std::size_t index) {
+  if (Asleep(index)) {
+    Wake(index);
+  }
+}
 
-  Vector<Length, 3> delta = b.position - a.position;
-  double dist = vector::Norm(delta).value;
+template <typename S>
+void BasicSimulator<S>::WakeAll() {
+  const std::size_t n = Size();
+  if (sleeping_ > 0) {
+    accelerations_valid_ = false;
+  }
+  sleeping_ = 0;
+  asleep_.assign(n, 0);
+  quiet_steps_.assign(n, 0);
+  awake_.resize(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    awake_[i] = i;
+  }
+}
 
-  constexpr double kEps = 1e-9;
-  if (dist < kEps) {
-    dist = kEps;
+template <typename S>
+void BasicSimulator<S>::SyncSleep() {
+  if (sleep_steps_ == 0) {
+    return;
   }
 
-  auto n = vector::Normalize(delta);
+  auto& p = particles_;
+  const std::size_t n = p.Size();
+  if (asleep_.size() > n || (block_max_level_ > 0 && sleeping_ > 0)) {
+    WakeAll();
+  }
+  // Новые тела добавляются в конец и начинают бодрствующими
+  for (std::size_t i = asleep_.size(); i < n; ++i) {
+    awake_.push_back(i);
+  }
+  asleep_.resize(n, 0);
+  quiet_steps_.resize(n, 0);
 
-  Vector<Speed, 3> dv = b.speed - a.speed;
-  double rel_vel = vector::Dot(dv, n).value;
+  if (sleep_check_ && sleeping_ > 0) {
+    for (std::size_t i = 0; i < n; ++i) {
+      if (asleep_[i] != 0 && (p.vx[i] != 0 || p.vy[i] != 0 || p.vz[i] != 0)) {
+        Wake(i);
+      }
+    }
+  }
+  sleep_check_ = false;
+}
 
-  if (rel_vel >= 0.0) {
+template <typename S>
+void BasicSimulator<S>::Wake(std::size_t index) {
+  if (asleep_[index] == 0) {
     return;
   }
+  asleep_[index] = 0;
+  quiet_steps_[index] = 0;
+  --sleeping_;
+  awake_.push_back(index);
+  accelerations_valid_ = false;
+}
+
+template <typename S>
+void BasicSimulator<S>::CheckSleepingForces(double acceleration2) {
+  StatsScope scope(stats_, StepPhase::kGravity);
+  active_.clear();
+  for (std::size_t i = 0; i < asleep_.size(); ++i) {
+    if (asleep_[i] != 0) {
+      active_.push_back(i);
+    }
+  }
+  ActiveForces();
+
+  // Разбуженное тело получает свое ускорение, чтобы счетчик спокойных шагов ниже сразу его увидел
+  auto& p = particles_;
+  const std::size_t m = active_.size();
+  for (std::size_t a = 0; a < m; ++a) {
+    const double ax = active_acc_[a];
+    const double ay = active_acc_[m + a];
+    const double az = active_acc_[2 * m + a];
+    if (ax * ax + ay * ay + az * az > acceleration2) {
+      const std::size_t i = active_[a];
+      Wake(i);
+      p.ax[i] = active_acc_[a];
+      p.ay[i] = active_acc_[m + a];
+      p.az[i] = active_acc_[2 * m + a];
+    }
+  }
+}
 
-  double m_a = a.weight.value;
-  double m_b = b.weight.value;
-  double inv_a = 1.0 / m_a;
-  double inv_b = 1.0 / m_b;
+template <typename S>
+void BasicSimulator<S>::UpdateSleep() {
+  if (sleep_steps_ == 0 || block_max_level_ > 0) {
+    return;
+  }
 
-  constexpr double kRestitution = 1.0;
-  double j = -(1.0 + kRestitution) * rel_vel / (inv_a + inv_b);
+  auto& p = particles_;
+  const std::size_t n = p.Size();
+  const double speed2 = sleep_speed_.value * sleep_speed_.value;
+  const double acceleration2 = sleep_acceleration_.value * sleep_acceleration_.value;
+  const auto limit = static_cast<std::uint32_t>(std::min<std::size_t>(sleep_steps_, std::numeric_limits<std::uint32_t>::max()));
 
-  for (int k = 0; k < 3; ++k) {
-    double nk = n[k].value;
-    a.speed[k].value -= j * inv_a * nk;
-    b.speed[k].value += j * inv_b * nk;
+  // Раз в steps шагов силы считаются и для спящих: пролетевшее рядом тело меняет поле и будит их без касания
+  if (sleeping_ > 0 && ++steps_since_force_check_ >= sleep_steps_) {
+    steps_since_force_check_ = 0;
+    CheckSleepingForces(acceleration2);
   }
 
-  double overlap = collision_distance_.value - dist;
-  if (overlap > 0.0) {
-    double total_mass = m_a + m_b;
-    double share_a = m_b / total_mass;
-    double share_b = m_a / total_mass;
+  ParallelFor(awake_.size(), kBodyGrain, [&](std::size_t begin, std::size_t end, std::size_t) {
+    for (std::size_t k = begin; k < end; ++k) {
+      const std::size_t i = awake_[k];
+      const double v2 = static_cast<double>(p.vx[i]) * p.vx[i] + static_cast<double>(p.vy[i]) * p.vy[i] + static_cast<double>(p.vz[i]) * p.vz[i];
+      const double a2 = static_cast<double>(p.ax[i]) * p.ax[i] + static_cast<double>(p.ay[i]) * p.ay[i] + static_cast<double>(p.az[i]) * p.az[i];
+      quiet_steps_[i] = v2 <= speed2 && a2 <= acceleration2 ? std::min(quiet_steps_[i] + 1, limit) : 0;
+    }
+  });
+
+  // Движущееся тело будит всех, кто связан с ним пружинами, а разбуженные - своих соседей, как острова в движках твердых тел
+  if (!springs_.Empty()) {
+    for (std::size_t k = 0; k < awake_.size(); ++k) {
+      if (quiet_steps_[awake_[k]] == 0) {
+        springs_.ForEachLinked(awake_[k], n, [this](std::uint32_t j) { Wake(j); });
+      }
+    }
+  }
 
-    for (int k = 0; k < 3; ++k) {
-      double nk = n[k].value;
-      a.position[k].value -= share_a * overlap * nk;
-      b.position[k].value += share_b * overlap * nk;
+  // Решения принимаются по счетчикам до засыпания, поэтому от порядка тел не зависят
+  falling_asleep_.clear();
+  for (const std::size_t i : awake_) {
+    bool ready = quiet_steps_[i] >= limit;
+    if (ready && !springs_.Empty()) {
+      springs_.ForEachLinked(i, n, [&](std::uint32_t j) { ready = ready && (asleep_[j] != 0 || quiet_steps_[j] >= limit); });
     }
+    if (ready) {
+      falling_asleep_.push_back(i);
+    }
+  }
+
+  for (const std::size_t i : falling_asleep_) {
+    asleep_[i] = 1;
+    p.vx[i] = p.vy[i] = p.vz[i] = 0;
+    p.ax[i] = p.ay[i] = p.az[i] = 0;
   }
+  sleeping_ += falling_asleep_.size();
+
+  std::erase_if(awake_, [this](std::size_t i) { return asleep_[i] != 0; });
+  std::sort(awake_.begin(), awake_.end());
 }
 
-void Simulator::HandleCollisions() {
-  for (size_t i = 0; i < objects_.size(); ++i) {
-    for (size_t j = i + 1; j < objects_.size(); ++j) {
-      auto& a = objects_[i];
-      auto& b = objects_[j];
+template <typename S>
+void BasicSimulator<S>::Step(units::Time dt) {
+  SyncBodies();
+  StatsScope scope(stats_, StepPhase::kStep);
+
+  const double h = dt.value;
+
+  // Отложенный потенциал берется из первого вычисления сил шага, если оно идет до перемещения тел
+  if (potential_pending_ && !ForcesAtStepStart()) {
+    CompletePotential();
+  }
+  const bool sample = diagnostics_every_ > 0 && (step_count_ + 1) % diagnostics_every_ == 0;
+  bool fused_potential = false;
+
+  if (collision_mode_ == CollisionMode::kContinuous) {
+    SaveStepStart();
+  }
+
+  if (collision_mode_ == CollisionMode::kEventDriven) {
+    // Силы дают один толчок, перемещение с ударами считается точно
+    stats_.AddBodies(AwakeCount());
+    ComputeAccelerations();
+    Kick(h);
+    DriftEventDriven(h);
+  } else if (block_max_level_ > 0) {
+    StepBlock(h);
+  } else {
+    stats_.AddBodies(AwakeCount());
+    switch (integrator_) {
+      case Integrator::kSemiImplicitEuler:
+        ComputeAccelerations();
+        Integrate(dt);
+        break;
+
+      case Integrator::kVelocityVerlet:
+        // Ускорения конца прошлого шага совпадают с ускорениями начала этого
+        if (!accelerations_valid_) {
+          ComputeAccelerations();
+        }
+        Kick(0.5 * h);
+        Drift(h);
+        potential_requested_ = sample;
+        fused_potential = sample;
+        ComputeAccelerations();
+        Kick(0.5 * h);
+        break;
 
-      double dist = a.DistanceTo(b).value;
+      case Integrator::kLeapfrog:
+        Drift(0.5 * h);
+        ComputeAccelerations();
+        Kick(h);
+        Drift(0.5 * h);
+        break;
 
-      if (dist <= collision_distance_.value) {
-        HandleElasticCollision(a, b);
+      case Integrator::kYoshida4: {
+        // Композиция трех шагов чехарды с весами w1, w0, w1
+        static const double kW1 = 1.0 / (2.0 - std::cbrt(2.0));
+        static const double kW0 = -std::cbrt(2.0) * kW1;
+        const double drift[4] = {0.5 * kW1, 0.5 * (kW0 + kW1), 0.5 * (kW0 + kW1), 0.5 * kW1};
+        const double kick[3] = {kW1, kW0, kW1};
+
+        for (std::size_t k = 0; k < 3; ++k) {
+          Drift(drift[k] * h);
+          ComputeAccelerations();
+          Kick(kick[k] * h);
+        }
+        Drift(drift[3] * h);
+        break;
       }
+
+      case Integrator::kRungeKutta4:
+        StepRungeKutta4(h);
+        break;
+    }
+  }
+
+  // После блочного шага все тела синхронны и их ускорения посчитаны в конечных положениях
+  accelerations_valid_ = collision_mode_ != CollisionMode::kEventDriven && (block_max_level_ > 0 || integrator_ == Integrator::kVelocityVerlet);
+
+  if (collision_mode_ == CollisionMode::kContinuous) {
+    HandleContinuousCollisions(h);
+  }
+
+  // Дискретная проверка остается страховкой и в непрерывных режимах
+  HandleDiscreteCollisions();
+  UpdateSleep();
+
+  ++step_count_;
+  elapsed_time_ = elapsed_time_ + dt;
+
+  storage_ = Storage::kParticles;
+
+  // Потенциал конца шага Верле годится, только если удары не сдвинули тела после вычисления сил
+  if (sample) {
+    Diagnostics d = Moments();
+    if (fused_potential && accelerations_valid_) {
+      d.potential = potential_energy_;
+    } else {
+      potential_pending_ = true;
     }
+    diagnostics_.push_back(d);
+  }
+
+  if (recorder_ && step_count_ % recorder_->RecordEvery() == 0) {
+    StatsScope recording(stats_, StepPhase::kRecording);
+    recorder_->Record(step_count_, elapsed_time_.value, particles_);
   }
 }
 
-void Simulator::Step(units::Time dt) {
-  ResetAccelerations();
+template <typename S>
+Trajectory BasicSimulator<S>::Run(std::size_t steps, units::Time dt, std::size_t record_every, bool record_velocities) {
+  SyncParticles();
 
-  if (use_gravity_) {
-    ApplyGravity();
+  record_every = std::max<std::size_t>(record_every, 1);
+
+  Trajectory trajectory;
+  trajectory.frames = steps / record_every;
+  trajectory.bodies = particles_.Size();
+
+  const std::size_t frame_size = 3 * trajectory.bodies;
+  trajectory.positions.resize(trajectory.frames * frame_size);
+  if (record_velocities) {
+    trajectory.velocities.resize(trajectory.frames * frame_size);
   }
 
-  for (auto& obj : objects_) {
-    obj.Update(dt);
+  auto interleave = [n = trajectory.bodies](const std::vector<S>& x, const std::vector<S>& y, const std::vector<S>& z, double* out) {
+    for (std::size_t i = 0; i < n; ++i) {
+      out[3 * i] = x[i];
+      out[3 * i + 1] = y[i];
+      out[3 * i + 2] = z[i];
+    }
+  };
+
+  for (std::size_t step = 1; step <= steps; ++step) {
+    Step(dt);
+
+    if (step % record_every != 0) {
+      continue;
+    }
+
+    const std::size_t frame = step / record_every - 1;
+    const auto& p = particles_;
+    interleave(p.x, p.y, p.z, trajectory.positions.data() + frame * frame_size);
+    if (record_velocities) {
+      interleave(p.vx, p.vy, p.vz, trajectory.velocities.data() + frame * frame_size);
+    }
   }
 
-  HandleCollisions();
+  return trajectory;
 }
 
-}  // namespace physics::simulator
\ No newline at end of file
+template class BasicSimulator<double>;
+template class BasicSimulator<float>;
+
+}  // namespace physics::simulator
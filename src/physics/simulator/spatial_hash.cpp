@@ -0,0 +1,154 @@
+#include "physics/simulator/spatial_hash.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace physics::simulator {
+
+namespace {
+
+template <typename S>
+double Distance2(const BasicParticleStore<S>& p, std::size_t i, std::size_t j) {
+  const double dx = p.x[j] - p.x[i];
+  const double dy = p.y[j] - p.y[i];
+  const double dz = p.z[j] - p.z[i];
+  return dx * dx + dy * dy + dz * dz;
+}
+
+// Предел номера ячейки: до 2^52 double хранит целые точно, и соседи +-1 не переполняют int64
+constexpr double kMaxCell = 4503599627370496.0;
+
+// Номер ячейки по оси для координаты, уже деленной на размер ячейки
+// Далекие координаты прижимаются к краю: прижатие монотонно, поэтому близкие тела остаются в соседних ячейках
+// NaN ни с кем не сближается, и его ячейка не важна
+std::int64_t Cell(double scaled) {
+  if (std::isnan(scaled)) {
+    return 0;
+  }
+  return static_cast<std::int64_t>(std::clamp(std::floor(scaled), -kMaxCell, kMaxCell));
+}
+
+}  // namespace
+
+std::size_t SpatialHash::Bucket(std::int64_t x, std::int64_t y, std::int64_t z) const {
+  const auto h = (static_cast<std::uint64_t>(x) * 73856093ULL) ^ (static_cast<std::uint64_t>(y) * 19349663ULL) ^
+                 (static_cast<std::uint64_t>(z) * 83492791ULL);
+  return static_cast<std::size_t>(h & mask_);
+}
+
+template <typename S>
+void SpatialHash::FindPairs(const BasicParticleStore<S>& particles, double distance, std::vector<Pair>& pairs, parallel::ThreadPool* pool) {
+  pairs.clear();
+
+  const std::size_t n = particles.Size();
+  if (n < 2) {
+    return;
+  }
+
+  const double dist2 = distance * distance;
+
+  // Вырожденный радиус: сетку построить нельзя, перебираем все пары
+  if (!(distance > 0.0) || !std::isfinite(distance)) {
+    for (std::size_t i = 0; i < n; ++i) {
+      for (std::size_t j = i + 1; j < n; ++j) {
+        if (Distance2(particles, i, j) <= dist2) {
+          pairs.emplace_back(static_cast<std::uint32_t>(i), static_cast<std::uint32_t>(j));
+        }
+      }
+    }
+    return;
+  }
+
+  std::size_t table = 1;
+  while (table < 2 * n) {
+    table <<= 1;
+  }
+
+  mask_ = table - 1;
+  bucket_start_.assign(table + 1, 0);
+  cells_.resize(3 * n);
+  entries_.resize(n);
+
+  const double inv = 1.0 / distance;
+  for (std::size_t i = 0; i < n; ++i) {
+    cells_[3 * i] = Cell(particles.x[i] * inv);
+    cells_[3 * i + 1] = Cell(particles.y[i] * inv);
+    cells_[3 * i + 2] = Cell(particles.z[i] * inv);
+    ++bucket_start_[Bucket(cells_[3 * i], cells_[3 * i + 1], cells_[3 * i + 2]) + 1];
+  }
+
+  for (std::size_t b = 1; b <= table; ++b) {
+    bucket_start_[b] += bucket_start_[b - 1];
+  }
+
+  // Сортировка подсчетом: внутри корзины тела лежат по возрастанию индекса
+  cursor_.assign(bucket_start_.begin(), bucket_start_.end() - 1);
+  for (std::size_t i = 0; i < n; ++i) {
+    entries_[cursor_[Bucket(cells_[3 * i], cells_[3 * i + 1], cells_[3 * i + 2])]++] = static_cast<std::uint32_t>(i);
+  }
+
+  if (pool == nullptr || pool->Size() == 1) {
+    Query(particles, dist2, 0, n, pairs);
+    return;
+  }
+
+  // Каждый блок тел пишет в свой массив, затем блоки склеиваются по порядку
+  constexpr std::size_t kBlock = 1024;
+  const std::size_t blocks = (n + kBlock - 1) / kBlock;
+  block_pairs_.resize(blocks);
+
+  pool->ParallelFor(blocks, 1, [&](std::size_t begin, std::size_t end, std::size_t) {
+    for (std::size_t b = begin; b < end; ++b) {
+      block_pairs_[b].clear();
+      Query(particles, dist2, b * kBlock, std::min(n, (b + 1) * kBlock), block_pairs_[b]);
+    }
+  });
+
+  for (const auto& block : block_pairs_) {
+    pairs.insert(pairs.end(), block.begin(), block.end());
+  }
+}
+
+template <typename S>
+void SpatialHash::Query(const BasicParticleStore<S>& particles, double dist2, std::size_t begin, std::size_t end, std::vector<Pair>& pairs) const {
+  std::array<std::size_t, 27> visited{};
+  for (std::size_t i = begin; i < end; ++i) {
+    const std::size_t first = pairs.size();
+    std::size_t visited_count = 0;
+
+    for (std::int64_t dx = -1; dx <= 1; ++dx) {
+      for (std::int64_t dy = -1; dy <= 1; ++dy) {
+        for (std::int64_t dz = -1; dz <= 1; ++dz) {
+          const std::size_t bucket = Bucket(cells_[3 * i] + dx, cells_[3 * i + 1] + dy, cells_[3 * i + 2] + dz);
+
+          // Разные ячейки могут попасть в одну корзину
+          if (std::find(visited.begin(), visited.begin() + visited_count, bucket) != visited.begin() + visited_count) {
+            continue;
+          }
+          visited[visited_count++] = bucket;
+
+          for (std::uint32_t e = bucket_start_[bucket]; e < bucket_start_[bucket + 1]; ++e) {
+            const std::uint32_t j = entries_[e];
+            if (j <= i) {
+              continue;
+            }
+
+            if (Distance2(particles, i, j) <= dist2) {
+              pairs.emplace_back(static_cast<std::uint32_t>(i), j);
+            }
+          }
+        }
+      }
+    }
+
+    std::sort(pairs.begin() + static_cast<std::ptrdiff_t>(first), pairs.end());
+  }
+}
+
+template void SpatialHash::FindPairs(const ParticleStore&, double, std::vector<Pair>&, parallel::ThreadPool*);
+template void SpatialHash::FindPairs(const ParticleStore32&, double, std::vector<Pair>&, parallel::ThreadPool*);
+
+}  // namespace physics::simulator
@@ -0,0 +1,206 @@
+#include "physics/simulator/spring_network.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+#include <physics/formulas/mech.hpp>
+
+namespace physics::simulator {
+
+namespace {
+
+// Минимальный кусок тел или пружин на поток
+constexpr std::size_t kSpringGrain = 4096;
+
+template <typename Fn>
+void Split(parallel::ThreadPool* pool, std::size_t count, const Fn& fn) {
+  if (pool != nullptr && pool->Size() > 1) {
+    pool->ParallelFor(count, kSpringGrain, fn);
+  } else if (count > 0) {
+    fn(0, count, 0);
+  }
+}
+
+}  // namespace
+
+void SpringNetwork::Add(std::uint32_t a, std::uint32_t b, units::Length rest_length, units::SpringConstant stiffness, double damping) {
+  a_.push_back(a);
+  b_.push_back(b);
+  rest_.push_back(rest_length);
+  stiffness_.push_back(stiffness);
+  damping_.push_back(damping);
+  built_ = false;
+}
+
+void SpringNetwork::Add(std::span<const std::uint32_t> a, std::span<const std::uint32_t> b, std::span<const double> rest_length,
+                        std::span<const double> stiffness, std::span<const double> damping) {
+  const std::size_t n = a.size();
+  if (b.size() != n || rest_length.size() != n || stiffness.size() != n || damping.size() != n) {
+    throw std::invalid_argument("spring array sizes differ: " + std::to_string(n) + " first bodies");
+  }
+
+  a_.insert(a_.end(), a.begin(), a.end());
+  b_.insert(b_.end(), b.begin(), b.end());
+  damping_.insert(damping_.end(), damping.begin(), damping.end());
+  for (std::size_t s = 0; s < n; ++s) {
+    rest_.push_back(units::Length{rest_length[s]});
+    stiffness_.push_back(units::SpringConstant{stiffness[s]});
+  }
+  built_ = false;
+}
+
+void SpringNetwork::Clear() {
+  a_.clear();
+  b_.clear();
+  rest_.clear();
+  stiffness_.clear();
+  damping_.clear();
+  built_ = false;
+}
+
+void SpringNetwork::Build(std::size_t bodies) const {
+  const std::size_t m = a_.size();
+  for (std::size_t s = 0; s < m; ++s) {
+    if (a_[s] >= bodies || b_[s] >= bodies) {
+      throw std::out_of_range("spring " + std::to_string(s) + " connects a body outside of " + std::to_string(bodies));
+    }
+  }
+
+  start_.assign(bodies + 1, 0);
+  for (std::size_t s = 0; s < m; ++s) {
+    ++start_[a_[s] + 1];
+    ++start_[b_[s] + 1];
+  }
+  for (std::size_t i = 0; i < bodies; ++i) {
+    start_[i + 1] += start_[i];
+  }
+
+  // Пружины тела идут в порядке добавления, поэтому сумма сил не зависит от числа потоков
+  links_.resize(2 * m);
+  std::vector<std::size_t> cursor(start_.begin(), start_.end() - 1);
+  for (std::size_t s = 0; s < m; ++s) {
+    links_[cursor[a_[s]]++] = Link{b_[s], rest_[s].value, stiffness_[s].value, damping_[s]};
+    links_[cursor[b_[s]]++] = Link{a_[s], rest_[s].value, stiffness_[s].value, damping_[s]};
+  }
+
+  bodies_ = bodies;
+  built_ = true;
+}
+
+template <typename S>
+void SpringNetwork::Row(std::size_t index, const BasicParticleStore<S>& p, double acc[3]) const {
+  const double xi = p.x[index];
+  const double yi = p.y[index];
+  const double zi = p.z[index];
+  const double vxi = p.vx[index];
+  const double vyi = p.vy[index];
+  const double vzi = p.vz[index];
+
+  double force[3] = {0.0, 0.0, 0.0};
+  for (std::size_t e = start_[index]; e < start_[index + 1]; ++e) {
+    const Link& link = links_[e];
+    const std::uint32_t j = link.other;
+    const double dx = p.x[j] - xi;
+    const double dy = p.y[j] - yi;
+    const double dz = p.z[j] - zi;
+    const double length2 = dx * dx + dy * dy + dz * dz;
+    if (length2 == 0.0) {
+      continue;
+    }
+
+    // Направление к другому концу; с того конца оно противоположно, и все произведения совпадают с точностью до знака
+    const double length = std::sqrt(length2);
+    const double ux = dx / length;
+    const double uy = dy / length;
+    const double uz = dz / length;
+    const double closing = (p.vx[j] - vxi) * ux + (p.vy[j] - vyi) * uy + (p.vz[j] - vzi) * uz;
+    const double f = link.stiffness * (length - link.rest) + link.damping * closing;
+
+    force[0] += f * ux;
+    force[1] += f * uy;
+    force[2] += f * uz;
+  }
+
+  const double mass = p.mass[index];
+  for (std::size_t k = 0; k < 3; ++k) {
+    acc[k] += force[k] / mass;
+  }
+}
+
+template <typename S>
+void SpringNetwork::AddAccelerations(const BasicParticleStore<S>& particles, S* ax, S* ay, S* az, parallel::ThreadPool* pool) const {
+  const std::size_t n = particles.Size();
+  if (!built_ || bodies_ != n) {
+    Build(n);
+  }
+
+  Split(pool, n, [&](std::size_t begin, std::size_t end, std::size_t) {
+    for (std::size_t i = begin; i < end; ++i) {
+      if (start_[i] == start_[i + 1]) {
+        continue;
+      }
+      double acc[3] = {0.0, 0.0, 0.0};
+      Row(i, particles, acc);
+      ax[i] += static_cast<S>(acc[0]);
+      ay[i] += static_cast<S>(acc[1]);
+      az[i] += static_cast<S>(acc[2]);
+    }
+  });
+}
+
+template <typename S>
+void SpringNetwork::AccelerationOn(std::size_t index, const BasicParticleStore<S>& particles, double acc[3]) const {
+  if (!built_ || bodies_ != particles.Size()) {
+    Build(particles.Size());
+  }
+  Row(index, particles, acc);
+}
+
+template <typename S>
+void SpringNetwork::Stretches(const BasicParticleStore<S>& p, parallel::ThreadPool* pool) const {
+  if (!built_ || bodies_ != p.Size()) {
+    Build(p.Size());
+  }
+
+  stretch_.resize(a_.size());
+  Split(pool, a_.size(), [&](std::size_t begin, std::size_t end, std::size_t) {
+    for (std::size_t s = begin; s < end; ++s) {
+      const double dx = p.x[b_[s]] - p.x[a_[s]];
+      const double dy = p.y[b_[s]] - p.y[a_[s]];
+      const double dz = p.z[b_[s]] - p.z[a_[s]];
+      stretch_[s] = units::Length{std::sqrt(dx * dx + dy * dy + dz * dz) - rest_[s].value};
+    }
+  });
+}
+
+template <typename S>
+void SpringNetwork::Tensions(const BasicParticleStore<S>& particles, std::span<units::Force> out, parallel::ThreadPool* pool) const {
+  Stretches(particles, pool);
+  mech::ElasticForce(stiffness_, stretch_, out, pool);
+}
+
+template <typename S>
+double SpringNetwork::Energy(const BasicParticleStore<S>& particles, parallel::ThreadPool* pool) const {
+  Stretches(particles, pool);
+  energy_.resize(a_.size());
+  mech::ElasticPotentialEnergy(stiffness_, stretch_, energy_, pool);
+
+  double total = 0.0;
+  for (const auto& e : energy_) {
+    total += e.value;
+  }
+  return total;
+}
+
+template void SpringNetwork::AddAccelerations(const ParticleStore&, double*, double*, double*, parallel::ThreadPool*) const;
+template void SpringNetwork::AddAccelerations(const ParticleStore32&, float*, float*, float*, parallel::ThreadPool*) const;
+template void SpringNetwork::AccelerationOn(std::size_t, const ParticleStore&, double[3]) const;
+template void SpringNetwork::AccelerationOn(std::size_t, const ParticleStore32&, double[3]) const;
+template void SpringNetwork::Tensions(const ParticleStore&, std::span<units::Force>, parallel::ThreadPool*) const;
+template void SpringNetwork::Tensions(const ParticleStore32&, std::span<units::Force>, parallel::ThreadPool*) const;
+template double SpringNetwork::Energy(const ParticleStore&, parallel::ThreadPool*) const;
+template double SpringNetwork::Energy(const ParticleStore32&, parallel::ThreadPool*) const;
+
+}  // namespace physics::simulator
@@ -0,0 +1,91 @@
+#include "physics/simulator/stats.hpp"
+
+#include <fstream>
+#include <stdexcept>
+
+namespace physics::simulator {
+
+const char* StepPhaseName(StepPhase phase) {
+  switch (phase) {
+    case StepPhase::kStep:
+      return "step";
+    case StepPhase::kGravity:
+      return "gravity";
+    case StepPhase::kIntegration:
+      return "integration";
+    case StepPhase::kCollisions:
+      return "collisions";
+    case StepPhase::kRecording:
+      return "recording";
+  }
+  return "unknown";
+}
+
+void StatsCollector::Reset() {
+  stats_ = StepStats{};
+}
+
+void StatsCollector::EnableTrace(bool enabled) {
+  if (enabled && !trace_enabled_) {
+    events_.clear();
+    trace_origin_ = Clock::now();
+  }
+  trace_enabled_ = enabled;
+}
+
+void StatsCollector::Finish(const Scope& scope, Clock::time_point end) {
+  const std::size_t index = static_cast<std::size_t>(scope.phase_);
+  const auto duration = end - scope.start_;
+  stats_.phase_seconds[index] += std::chrono::duration<double>(duration).count();
+
+  const bool step = scope.phase_ == StepPhase::kStep;
+  if (step) {
+    ++stats_.steps;
+  }
+
+  if (!trace_enabled_) {
+    return;
+  }
+
+  TraceEvent event{scope.phase_, std::chrono::duration_cast<std::chrono::nanoseconds>(scope.start_ - trace_origin_).count(),
+                   std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count(), 0, 0, 0};
+  if (step) {
+    event.pairs = stats_.pairs_examined - scope.counters_at_start_.pairs_examined;
+    event.collisions = stats_.collisions_resolved - scope.counters_at_start_.collisions_resolved;
+    event.bodies = stats_.bodies_integrated - scope.counters_at_start_.bodies_integrated;
+  }
+  events_.push_back(event);
+}
+
+void StatsCollector::WriteTrace(const std::string& path) const {
+  std::ofstream out(path);
+  if (!out) {
+    throw std::runtime_error("cannot create trace " + path);
+  }
+
+  // Время в микросекундах, как требует формат
+  auto micros = [](std::int64_t ns) { return static_cast<double>(ns) / 1000.0; };
+  out.setf(std::ios::fixed);
+  out.precision(3);
+
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  bool first = true;
+  for (const auto& event : events_) {
+    out << (first ? "\n" : ",\n");
+    first = false;
+    out << "{\"name\":\"" << StepPhaseName(event.phase) << "\",\"cat\":\"physics\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":" << micros(event.start_ns)
+        << ",\"dur\":" << micros(event.duration_ns) << "}";
+
+    if (event.phase == StepPhase::kStep) {
+      out << ",\n{\"name\":\"counters\",\"cat\":\"physics\",\"ph\":\"C\",\"pid\":1,\"tid\":1,\"ts\":" << micros(event.start_ns)
+          << ",\"args\":{\"pairs\":" << event.pairs << ",\"collisions\":" << event.collisions << ",\"bodies\":" << event.bodies << "}}";
+    }
+  }
+  out << "\n]}\n";
+
+  if (!out) {
+    throw std::runtime_error("cannot write trace " + path);
+  }
+}
+
+}  // namespace physics::simulator
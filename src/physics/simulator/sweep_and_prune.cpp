@@ -0,0 +1,174 @@
+#include "physics/simulator/sweep_and_prune.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+namespace physics::simulator {
+
+namespace {
+
+template <typename S>
+double Distance2(const BasicParticleStore<S>& p, std::size_t i, std::size_t j) {
+  const double dx = p.x[j] - p.x[i];
+  const double dy = p.y[j] - p.y[i];
+  const double dz = p.z[j] - p.z[i];
+  return dx * dx + dy * dy + dz * dz;
+}
+
+// При равных значениях минимум идет раньше максимума, чтобы касающиеся кубы считались пересекающимися
+template <typename Endpoint>
+bool Less(const Endpoint& a, const Endpoint& b) {
+  return a.value < b.value || (a.value == b.value && a.is_min && !b.is_min);
+}
+
+}  // namespace
+
+std::uint64_t SweepAndPrune::Key(std::uint32_t a, std::uint32_t b) {
+  if (a > b) {
+    std::swap(a, b);
+  }
+  return (static_cast<std::uint64_t>(a) << 32) | b;
+}
+
+template <typename S>
+void SweepAndPrune::FindPairs(const BasicParticleStore<S>& particles, double distance, std::vector<Pair>& pairs) {
+  pairs.clear();
+
+  const std::size_t n = particles.Size();
+  const double dist2 = distance * distance;
+
+  // Вырожденный радиус: кубы построить нельзя, перебираем все пары и сбрасываем состояние
+  if (!(distance > 0.0) || !std::isfinite(distance)) {
+    bodies_ = 0;
+    overlaps_.clear();
+    for (std::size_t i = 0; i < n; ++i) {
+      for (std::size_t j = i + 1; j < n; ++j) {
+        if (Distance2(particles, i, j) <= dist2) {
+          pairs.emplace_back(static_cast<std::uint32_t>(i), static_cast<std::uint32_t>(j));
+        }
+      }
+    }
+    return;
+  }
+
+  if (n != bodies_ || distance != distance_) {
+    Rebuild(particles, distance);
+  } else {
+    UpdateBounds(particles);
+    for (std::size_t axis = 0; axis < 3; ++axis) {
+      SortAxis(axis);
+    }
+  }
+
+  // Кубы пересекаются, но шары могут и не касаться
+  for (const std::uint64_t key : overlaps_) {
+    const auto i = static_cast<std::uint32_t>(key >> 32);
+    const auto j = static_cast<std::uint32_t>(key);
+    if (Distance2(particles, i, j) <= dist2) {
+      pairs.emplace_back(i, j);
+    }
+  }
+  std::sort(pairs.begin(), pairs.end());
+}
+
+template <typename S>
+void SweepAndPrune::UpdateBounds(const BasicParticleStore<S>& particles) {
+  const std::size_t n = particles.Size();
+  const double half = 0.5 * distance_;
+  const std::vector<S>* coords[3] = {&particles.x, &particles.y, &particles.z};
+
+  bounds_.resize(6 * n);
+  for (std::size_t i = 0; i < n; ++i) {
+    for (std::size_t k = 0; k < 3; ++k) {
+      bounds_[6 * i + 2 * k] = (*coords[k])[i] - half;
+      bounds_[6 * i + 2 * k + 1] = (*coords[k])[i] + half;
+    }
+  }
+
+  for (std::size_t k = 0; k < 3; ++k) {
+    for (auto& e : axes_[k]) {
+      e.value = bounds_[6 * e.body + 2 * k + (e.is_min ? 0 : 1)];
+    }
+  }
+}
+
+template <typename S>
+void SweepAndPrune::Rebuild(const BasicParticleStore<S>& particles, double distance) {
+  const std::size_t n = particles.Size();
+  bodies_ = n;
+  distance_ = distance;
+  overlaps_.clear();
+
+  for (auto& axis : axes_) {
+    axis.resize(2 * n);
+    for (std::size_t i = 0; i < n; ++i) {
+      axis[2 * i] = {0.0, static_cast<std::uint32_t>(i), true};
+      axis[2 * i + 1] = {0.0, static_cast<std::uint32_t>(i), false};
+    }
+  }
+
+  UpdateBounds(particles);
+  for (auto& axis : axes_) {
+    std::sort(axis.begin(), axis.end(), Less<Endpoint>);
+  }
+
+  // Первоначальный проход по оси x с множеством открытых кубов
+  std::vector<std::uint32_t> active;
+  for (const auto& e : axes_[0]) {
+    if (!e.is_min) {
+      active.erase(std::find(active.begin(), active.end(), e.body));
+      continue;
+    }
+
+    for (const std::uint32_t other : active) {
+      if (BoxesOverlap(e.body, other)) {
+        overlaps_.insert(Key(e.body, other));
+      }
+    }
+    active.push_back(e.body);
+  }
+}
+
+void SweepAndPrune::SortAxis(std::size_t axis) {
+  auto& endpoints = axes_[axis];
+
+  // Сортировка вставками: между кадрами порядок почти не меняется, и каждая перестановка двух концов
+  // означает, что пара кубов начала или перестала пересекаться по этой оси
+  for (std::size_t i = 1; i < endpoints.size(); ++i) {
+    const Endpoint e = endpoints[i];
+    std::size_t j = i;
+
+    while (j > 0 && Less(e, endpoints[j - 1])) {
+      const Endpoint& other = endpoints[j - 1];
+
+      if (e.is_min && !other.is_min) {
+        if (BoxesOverlap(e.body, other.body)) {
+          overlaps_.insert(Key(e.body, other.body));
+        }
+      } else if (!e.is_min && other.is_min) {
+        overlaps_.erase(Key(e.body, other.body));
+      }
+
+      endpoints[j] = other;
+      --j;
+    }
+    endpoints[j] = e;
+  }
+}
+
+bool SweepAndPrune::BoxesOverlap(std::uint32_t a, std::uint32_t b) const {
+  const double* ba = bounds_.data() + 6 * static_cast<std::size_t>(a);
+  const double* bb = bounds_.data() + 6 * static_cast<std::size_t>(b);
+  for (std::size_t k = 0; k < 3; ++k) {
+    if (ba[2 * k] > bb[2 * k + 1] || bb[2 * k] > ba[2 * k + 1]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template void SweepAndPrune::FindPairs(const ParticleStore&, double, std::vector<Pair>&);
+template void SweepAndPrune::FindPairs(const ParticleStore32&, double, std::vector<Pair>&);
+
+}  // namespace physics::simulator
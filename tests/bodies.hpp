@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <physics/object/object.hpp>
+#include <physics/units/quantity.hpp>
+#include <physics/vector/vector.hpp>
+
+namespace physics::tests {
+
+// Случайное облако: координаты равномерно в кубе [low, high)^3, компоненты скорости - в [-speed, speed], массы - в [mass_low, mass_high]
+struct Cloud {
+  double low = 0.0;
+  double high = 1.0;
+  double speed = 0.0;
+  double mass_low = 1.0;
+  double mass_high = 1.0;
+};
+
+inline std::vector<object::Object> RandomBodies(std::size_t n, const Cloud& cloud, std::uint32_t seed) {
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<double> pos(cloud.low, cloud.high);
+  std::uniform_real_distribution<double> vel(-cloud.speed, cloud.speed);
+  std::uniform_real_distribution<double> mass(cloud.mass_low, cloud.mass_high);
+
+  std::vector<object::Object> objects;
+  objects.reserve(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    const vector::Vector<units::Length, 3> r{units::Length{pos(gen)}, units::Length{pos(gen)}, units::Length{pos(gen)}};
+    const vector::Vector<units::Speed, 3> v{units::Speed{vel(gen)}, units::Speed{vel(gen)}, units::Speed{vel(gen)}};
+    objects.emplace_back(units::Weight{mass(gen)}, r, v);
+  }
+  return objects;
+}
+
+// Тело в плоскости z = 0
+inline object::Object Body(double mass, double x, double y, double vx, double vy) {
+  return object::Object(units::Weight{mass}, vector::Vector<units::Length, 3>{units::Length{x}, units::Length{y}, units::Length{0.0}},
+                        vector::Vector<units::Speed, 3>{units::Speed{vx}, units::Speed{vy}, units::Speed{0.0}});
+}
+
+// Три тяжелых шара, как в examples/three_balls.py, но с гравитацией: притягиваются и несколько раз сталкиваются
+inline std::array<object::Object, 3> ThreeBalls() {
+  return {Body(1e10, -1.0, 0.0, 0.5, 0.1), Body(2e10, 1.0, 0.2, -0.5, 0.0), Body(1.5e10, 0.0, 1.5, 0.0, -0.4)};
+}
+
+}  // namespace physics::tests
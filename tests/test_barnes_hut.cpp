@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include <physics/object/object.hpp>
+#include <physics/simulator/simulator.hpp>
+#include <physics/units/quantity.hpp>
+#include <physics/vector/vector.hpp>
+
+#include "bodies.hpp"
+
+namespace pu = physics::units;
+using physics::object::Object;
+using physics::simulator::GravitySolver;
+using physics::simulator::Simulator;
+using physics::tests::Cloud;
+using physics::tests::RandomBodies;
+
+constexpr Cloud kCluster{.low = -100.0, .high = 100.0, .mass_low = 1e9, .mass_high = 1e10};
+
+double MaxRelativeError(const Simulator& a, const Simulator& b) {
+  double worst = 0.0;
+  for (std::size_t i = 0; i < a.Objects().size(); ++i) {
+    const auto& aa = a.Objects()[i].acceleration;
+    const auto& ab = b.Objects()[i].acceleration;
+
+    double diff = 0.0;
+    double norm = 0.0;
+    for (std::size_t k = 0; k < 3; ++k) {
+      diff += (aa[k].value - ab[k].value) * (aa[k].value - ab[k].value);
+      norm += ab[k].value * ab[k].value;
+    }
+    worst = std::max(worst, std::sqrt(diff / norm));
+  }
+  return worst;
+}
+
+TEST(BarnesHutTest, ZeroThetaMatchesDirectSummation) {
+  auto objects = RandomBodies(300, kCluster, 42);
+
+  Simulator direct(objects, pu::Length{0.0});
+  Simulator tree(objects, pu::Length{0.0});
+  tree.SetGravitySolver(GravitySolver::kBarnesHut);
+  tree.SetTheta(0.0);
+
+  direct.Step(pu::Time{1.0});
+  tree.Step(pu::Time{1.0});
+
+  EXPECT_LT(MaxRelativeError(tree, direct), 1e-10);
+}
+
+TEST(BarnesHutTest, ApproximationErrorIsSmall) {
+  auto objects = RandomBodies(1000, kCluster, 42);
+
+  Simulator direct(objects, pu::Length{0.0});
+  Simulator tree(objects, pu::Length{0.0});
+  tree.SetGravitySolver(GravitySolver::kBarnesHut);
+  tree.SetTheta(0.5);
+
+  direct.Step(pu::Time{1.0});
+  tree.Step(pu::Time{1.0});
+
+  EXPECT_LT(MaxRelativeError(tree, direct), 5e-2);
+}
+
+TEST(BarnesHutTest, CoincidentBodiesDoNotRecurseForever) {
+  std::vector<Object> objects(100, Object(pu::Weight{1.0}));
+  objects.emplace_back(pu::Weight{1.0}, physics::vector::Vector<pu::Length, 3>{pu::Length{1.0}, pu::Length{0.0}, pu::Length{0.0}});
+
+  Simulator sim(objects, pu::Length{0.0});
+  sim.SetGravitySolver(GravitySolver::kBarnesHut);
+  sim.Step(pu::Time{1.0});
+
+  EXPECT_LT(sim.Objects().back().acceleration[0].value, 0.0);
+}
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include <physics/constants.hpp>
+#include <physics/object/object.hpp>
+#include <physics/simulator/simulator.hpp>
+#include <physics/units/quantity.hpp>
+#include <physics/vector/vector.hpp>
+
+namespace pu = physics::units;
+using physics::object::Object;
+using physics::simulator::Integrator;
+using physics::simulator::Simulator;
+
+namespace {
+
+constexpr double kSunMass = 1e24;
+
+Object Satellite(double radius) {
+  const double v = std::sqrt(physics::constants::kG.value * kSunMass / radius);
+  return Object(pu::Weight{1.0}, physics::vector::Vector<pu::Length, 3>{pu::Length{radius}, pu::Length{0.0}, pu::Length{0.0}},
+                physics::vector::Vector<pu::Speed, 3>{pu::Speed{0.0}, pu::Speed{v}, pu::Speed{0.0}});
+}
+
+// Быстрый спутник с периодом около секунды и медленный с периодом около тысячи секунд
+std::vector<Object> MixedScales() {
+  return {Object(pu::Weight{kSunMass}), Satellite(1e4), Satellite(1e6)};
+}
+
+double SpecificEnergy(const Simulator& sim, std::size_t i) {
+  const auto& p = sim.Particles();
+  const double r = std::hypot(p.x[i] - p.x[0], p.y[i] - p.y[0], p.z[i] - p.z[0]);
+  const double v2 = std::pow(p.vx[i] - p.vx[0], 2) + std::pow(p.vy[i] - p.vy[0], 2) + std::pow(p.vz[i] - p.vz[0], 2);
+  return 0.5 * v2 - physics::constants::kG.value * kSunMass / r;
+}
+
+}  // namespace
+
+TEST(BlockStepsTest, FastBodiesGetDeeperLevels) {
+  Simulator sim(MixedScales(), pu::Length{0.0});
+  sim.SetBlockTimeSteps(10);
+
+  const double e0 = SpecificEnergy(sim, 1);
+  for (std::size_t step = 0; step < 4; ++step) {
+    sim.Step(pu::Time{0.5});
+  }
+
+  EXPECT_GE(sim.TimeStepLevel(1), 6u);
+  EXPECT_EQ(sim.TimeStepLevel(2), 0u);
+
+  // Шаг 0.5 с больше периода быстрого спутника, но его орбита остается точной
+  EXPECT_NEAR(SpecificEnergy(sim, 1) / e0, 1.0, 1e-3);
+}
+
+TEST(BlockStepsTest, CoarseBodiesSkipUnusedSubsteps) {
+  if (!physics::simulator::kStatsEnabled) {
+    GTEST_SKIP() << "built without PHYSICS_ENABLE_STATS";
+  }
+
+  // Только медленный спутник: оба тела сразу получают уровень 0, и шаг не проходит 2^16 пустых подшагов
+  Simulator sim({Object(pu::Weight{kSunMass}), Satellite(1e6)}, pu::Length{0.0});
+  sim.SetBlockTimeSteps(100);
+  EXPECT_EQ(sim.BlockTimeSteps(), 16u);
+
+  for (std::size_t step = 0; step < 3; ++step) {
+    sim.Step(pu::Time{0.5});
+  }
+  EXPECT_EQ(sim.TimeStepLevel(0), 0u);
+  EXPECT_EQ(sim.TimeStepLevel(1), 0u);
+  EXPECT_EQ(sim.Stats().bodies_integrated, 6u);
+}
+
+TEST(BlockStepsTest, GlobalStepWithSameDtFails) {
+  Simulator sim(MixedScales(), pu::Length{0.0});
+  sim.SetIntegrator(Integrator::kVelocityVerlet);
+
+  const double e0 = SpecificEnergy(sim, 1);
+  for (std::size_t step = 0; step < 4; ++step) {
+    sim.Step(pu::Time{0.5});
+  }
+
+  EXPECT_GT(std::abs(SpecificEnergy(sim, 1) / e0 - 1.0), 1e-1);
+}
+
+TEST(BlockStepsTest, CollisionsMatchGlobalStep) {
+  using pu::operator""_kg;
+  using pu::operator""_m;
+  using pu::operator""_ms;
+
+  std::vector<Object> balls = {
+      Object(0.17_kg, {0.6_m * -1, 0.0_m, 0.0_m}, {1.5_ms, 0.0_ms, 0.0_ms}),
+      Object(0.17_kg, {0.6_m, 0.3_m * -1, 0.0_m}, {0.5_ms * -1, 0.5_ms, 0.0_ms}),
+      Object(0.17_kg, {0.0_m, 0.4_m, 0.0_m}, {0.0_ms, 1.0_ms * -1, 0.0_ms}),
+  };
+
+  Simulator global(balls, pu::Length{0.114});
+  Simulator block(balls, pu::Length{0.114});
+  global.EnableGravity(false);
+  block.EnableGravity(false);
+  block.SetBlockTimeSteps(4);
+
+  for (std::size_t step = 0; step < 300; ++step) {
+    global.Step(pu::Time{0.005});
+    block.Step(pu::Time{0.005});
+  }
+
+  for (std::size_t i = 0; i < balls.size(); ++i) {
+    for (std::size_t k = 0; k < 3; ++k) {
+      EXPECT_NEAR(block.Objects()[i].position[k].value, global.Objects()[i].position[k].value, 1e-9);
+      EXPECT_NEAR(block.Objects()[i].speed[k].value, global.Objects()[i].speed[k].value, 1e-9);
+    }
+  }
+}
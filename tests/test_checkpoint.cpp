@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <physics/io/checkpoint.hpp>
+#include <physics/object/object.hpp>
+#include <physics/simulator/simulator.hpp>
+#include <physics/units/quantity.hpp>
+#include <physics/vector/vector.hpp>
+
+namespace pu = physics::units;
+namespace fs = std::filesystem;
+using physics::object::Object;
+using physics::simulator::Simulator;
+
+namespace {
+
+std::vector<Object> Balls() {
+  using pu::operator""_kg;
+  using pu::operator""_m;
+  using pu::operator""_ms;
+
+  return {
+      Object(1e9_kg, {0.6_m * -1, 0.0_m, 0.0_m}, {1.5_ms, 0.0_ms, 0.0_ms}),
+      Object(2e9_kg, {0.6_m, 0.3_m * -1, 0.0_m}, {0.5_ms * -1, 0.5_ms, 0.0_ms}),
+      Object(3e9_kg, {0.0_m, 0.4_m, 0.1_m}, {0.0_ms, 1.0_ms * -1, 0.0_ms}),
+  };
+}
+
+std::string TempPath(const std::string& name) {
+  return (fs::temp_directory_path() / ("physics_" + name + ".ckpt")).string();
+}
+
+}  // namespace
+
+TEST(CheckpointTest, RestoredRunContinuesBitwise) {
+  const std::string path = TempPath("round_trip");
+
+  Simulator original(Balls(), pu::Length{0.114});
+  for (std::size_t step = 0; step < 50; ++step) {
+    original.Step(pu::Time{0.005});
+  }
+  physics::io::SaveCheckpoint(original, path);
+  EXPECT_FALSE(fs::exists(path + ".tmp"));
+
+  Simulator restored;
+  restored.EnableGravity(false);
+  physics::io::LoadCheckpoint(path, restored);
+  fs::remove(path);
+
+  EXPECT_TRUE(restored.GravityEnabled());
+  EXPECT_EQ(restored.CollisionDistance().value, 0.114);
+  EXPECT_EQ(restored.StepCount(), 50u);
+  EXPECT_EQ(restored.ElapsedTime().value, original.ElapsedTime().value);
+  ASSERT_EQ(restored.Size(), 3u);
+
+  for (std::size_t step = 0; step < 50; ++step) {
+    original.Step(pu::Time{0.005});
+    restored.Step(pu::Time{0.005});
+  }
+
+  const auto& a = original.Particles();
+  const auto& b = restored.Particles();
+  for (std::size_t i = 0; i < a.Size(); ++i) {
+    EXPECT_EQ(a.x[i], b.x[i]);
+    EXPECT_EQ(a.y[i], b.y[i]);
+    EXPECT_EQ(a.z[i], b.z[i]);
+    EXPECT_EQ(a.vx[i], b.vx[i]);
+    EXPECT_EQ(a.mass[i], b.mass[i]);
+  }
+  EXPECT_EQ(restored.StepCount(), 100u);
+}
+
+TEST(CheckpointTest, RejectsBrokenFiles) {
+  const std::string path = TempPath("broken");
+  Simulator sim(Balls(), pu::Length{0.114});
+
+  EXPECT_THROW(physics::io::LoadCheckpoint(TempPath("missing"), sim), std::runtime_error);
+
+  {
+    std::ofstream out(path, std::ios::binary);
+    out << "definitely not a checkpoint, but long enough to hold a header of sixty-four bytes";
+  }
+  EXPECT_THROW(physics::io::LoadCheckpoint(path, sim), std::runtime_error);
+
+  // Обрезанный хвост с массивами
+  physics::io::SaveCheckpoint(sim, path);
+  fs::resize_file(path, fs::file_size(path) - sizeof(double));
+  EXPECT_THROW(physics::io::LoadCheckpoint(path, sim), std::runtime_error);
+  fs::remove(path);
+
+  // Неудачная загрузка не трогает тела
+  EXPECT_EQ(sim.Size(), 3u);
+}
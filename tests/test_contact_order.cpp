@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include <physics/object/object.hpp>
+#include <physics/simulator/simulator.hpp>
+#include <physics/units/quantity.hpp>
+#include <physics/vector/vector.hpp>
+
+#include "bodies.hpp"
+
+namespace pu = physics::units;
+using physics::object::Object;
+using physics::simulator::BroadPhase;
+using physics::simulator::ContactOrder;
+using physics::simulator::ParticleStore;
+using physics::simulator::Simulator;
+using physics::tests::Cloud;
+using physics::tests::RandomBodies;
+
+namespace {
+
+// Плотная гранулированная упаковка: около дюжины соседей в радиусе удара у каждого тела
+constexpr Cloud kPack{.high = 10.0, .speed = 1.0, .mass_low = 0.5, .mass_high = 2.0};
+
+void Momentum(const ParticleStore& p, double out[4]) {
+  for (std::size_t k = 0; k < 4; ++k) {
+    out[k] = 0.0;
+  }
+  for (std::size_t i = 0; i < p.Size(); ++i) {
+    out[0] += p.mass[i] * p.vx[i];
+    out[1] += p.mass[i] * p.vy[i];
+    out[2] += p.mass[i] * p.vz[i];
+    out[3] += 0.5 * p.mass[i] * (p.vx[i] * p.vx[i] + p.vy[i] * p.vy[i] + p.vz[i] * p.vz[i]);
+  }
+}
+
+}  // namespace
+
+TEST(ContactOrderTest, ColoredIsIdenticalForAnyThreadCount) {
+  const auto objects = RandomBodies(3000, kPack, 2);
+
+  std::vector<double> x;
+  std::vector<double> vy;
+  for (std::size_t threads : {1, 2, 4}) {
+    Simulator sim(objects, pu::Length{1.0});
+    sim.EnableGravity(false);
+    sim.SetThreads(threads);
+    ASSERT_EQ(sim.GetContactOrder(), ContactOrder::kSequential);
+    sim.SetContactOrder(ContactOrder::kColored);
+    for (int step = 0; step < 10; ++step) {
+      sim.Step(pu::Time{0.01});
+    }
+
+    const auto& p = sim.Particles();
+    if (x.empty()) {
+      x.assign(p.x.begin(), p.x.end());
+      vy.assign(p.vy.begin(), p.vy.end());
+      continue;
+    }
+    for (std::size_t i = 0; i < p.Size(); ++i) {
+      ASSERT_EQ(p.x[i], x[i]) << "threads " << threads;
+      ASSERT_EQ(p.vy[i], vy[i]) << "threads " << threads;
+    }
+  }
+}
+
+TEST(ContactOrderTest, ConservesMomentumAndEnergyLikeSequential) {
+  const auto objects = RandomBodies(3000, kPack, 7);
+
+  Simulator sequential(objects, pu::Length{1.0});
+  Simulator colored(objects, pu::Length{1.0});
+  colored.SetContactOrder(ContactOrder::kColored);
+  colored.SetThreads(3);
+  for (Simulator* sim : {&sequential, &colored}) {
+    sim->EnableGravity(false);
+    sim->HandleCollisions();
+  }
+
+  // Упругие удары сохраняют импульс и энергию в любом порядке, хотя сами скорости после них различаются
+  double before[4];
+  double a[4];
+  double b[4];
+  Simulator initial(objects, pu::Length{1.0});
+  Momentum(initial.Particles(), before);
+  Momentum(sequential.Particles(), a);
+  Momentum(colored.Particles(), b);
+  for (std::size_t k = 0; k < 4; ++k) {
+    EXPECT_NEAR(a[k], before[k], 1e-9 * (1.0 + std::abs(before[k])));
+    EXPECT_NEAR(b[k], before[k], 1e-9 * (1.0 + std::abs(before[k])));
+  }
+
+  std::size_t differ = 0;
+  for (std::size_t i = 0; i < objects.size(); ++i) {
+    differ += sequential.Particles().vx[i] != colored.Particles().vx[i] ? 1 : 0;
+  }
+  EXPECT_GT(differ, 0U);
+}
+
+TEST(ContactOrderTest, SequentialKeepsPairOrder) {
+  // Колыбель Ньютона: в порядке пар удар проходит по всей цепочке за одну проверку, и скорость достается последнему шару
+  // В раскраске пары (0, 1) и (2, 3) получают общий цвет, поэтому за одну проверку удар доходит только до третьего шара
+  auto ball = [](double x, double vx) {
+    const physics::vector::Vector<pu::Length, 3> r{pu::Length{x}, pu::Length{0.0}, pu::Length{0.0}};
+    const physics::vector::Vector<pu::Speed, 3> v{pu::Speed{vx}, pu::Speed{0.0}, pu::Speed{0.0}};
+    return Object(pu::Weight{1.0}, r, v);
+  };
+  const std::vector<Object> cradle = {ball(0.0, 1.0), ball(1.0, 0.0), ball(2.0, 0.0), ball(3.0, 0.0)};
+
+  for (ContactOrder order : {ContactOrder::kSequential, ContactOrder::kColored}) {
+    for (BroadPhase broad_phase : {BroadPhase::kBruteForce, BroadPhase::kSpatialHash}) {
+      Simulator sim(cradle, pu::Length{1.0});
+      sim.EnableGravity(false);
+      sim.SetContactOrder(order);
+      sim.SetBroadPhase(broad_phase);
+      sim.HandleCollisions();
+
+      const auto& p = sim.Particles();
+      const std::size_t last = order == ContactOrder::kSequential ? 3 : 2;
+      for (std::size_t i = 0; i < 4; ++i) {
+        EXPECT_EQ(p.vx[i], i == last ? 1.0 : 0.0) << "ball " << i;
+      }
+    }
+  }
+}
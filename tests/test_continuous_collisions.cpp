@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include <physics/object/object.hpp>
+#include <physics/simulator/simulator.hpp>
+#include <physics/units/quantity.hpp>
+#include <physics/vector/vector.hpp>
+
+namespace pu = physics::units;
+using physics::object::Object;
+using physics::simulator::CollisionMode;
+using physics::simulator::Simulator;
+
+namespace {
+
+Object Ball(double x, double vx) {
+  return Object(pu::Weight{1.0}, physics::vector::Vector<pu::Length, 3>{pu::Length{x}, pu::Length{0.0}, pu::Length{0.0}},
+                physics::vector::Vector<pu::Speed, 3>{pu::Speed{vx}, pu::Speed{0.0}, pu::Speed{0.0}});
+}
+
+}  // namespace
+
+TEST(ContinuousCollisionsTest, FastBallsDoNotTunnel) {
+  // За шаг каждый шар пролетает 1 м при радиусе столкновения 0.1 м
+  std::vector<Object> balls = {Ball(-0.75, 10.0), Ball(0.75, -10.0)};
+
+  Simulator discrete(balls, pu::Length{0.1});
+  Simulator swept(balls, pu::Length{0.1});
+  discrete.EnableGravity(false);
+  swept.EnableGravity(false);
+  swept.SetCollisionMode(CollisionMode::kContinuous);
+
+  discrete.Step(pu::Time{0.1});
+  swept.Step(pu::Time{0.1});
+
+  EXPECT_DOUBLE_EQ(discrete.Objects()[0].speed[0].value, 10.0);
+
+  // Касание через 0.07 с, оставшиеся 0.03 с шары летят обратно
+  EXPECT_NEAR(swept.Objects()[0].speed[0].value, -10.0, 1e-12);
+  EXPECT_NEAR(swept.Objects()[1].speed[0].value, 10.0, 1e-12);
+  EXPECT_NEAR(swept.Objects()[0].position[0].value, -0.35, 1e-12);
+  EXPECT_NEAR(swept.Objects()[1].position[0].value, 0.35, 1e-12);
+}
+
+TEST(ContinuousCollisionsTest, EventDrivenChainWithinOneStep) {
+  // Колыбель Ньютона: за один большой шаг происходят два удара подряд
+  Simulator sim({Ball(0.0, 10.0), Ball(0.3, 0.0), Ball(0.6, 0.0)}, pu::Length{0.1});
+  sim.EnableGravity(false);
+  sim.SetCollisionMode(CollisionMode::kEventDriven);
+
+  sim.Step(pu::Time{1.0});
+
+  const auto& p = sim.Particles();
+  EXPECT_NEAR(p.vx[0], 0.0, 1e-12);
+  EXPECT_NEAR(p.vx[1], 0.0, 1e-12);
+  EXPECT_NEAR(p.vx[2], 10.0, 1e-12);
+  EXPECT_NEAR(p.x[0], 0.2, 1e-12);
+  EXPECT_NEAR(p.x[1], 0.5, 1e-12);
+  EXPECT_NEAR(p.x[2], 10.2, 1e-12);
+}
+
+TEST(ContinuousCollisionsTest, HardSphereGasConservesEnergyWithoutOverlaps) {
+  std::mt19937 gen(11);
+  std::uniform_real_distribution<double> pos(0.0, 10.0);
+  std::normal_distribution<double> vel(0.0, 5.0);
+
+  // Разреженный газ без начальных перекрытий
+  constexpr double kDistance = 0.3;
+  std::vector<Object> gas;
+  while (gas.size() < 300) {
+    Object ball(pu::Weight{1.0}, physics::vector::Vector<pu::Length, 3>{pu::Length{pos(gen)}, pu::Length{pos(gen)}, pu::Length{pos(gen)}},
+                physics::vector::Vector<pu::Speed, 3>{pu::Speed{vel(gen)}, pu::Speed{vel(gen)}, pu::Speed{vel(gen)}});
+
+    bool free = true;
+    for (const auto& other : gas) {
+      free = free && ball.DistanceTo(other).value > kDistance;
+    }
+    if (free) {
+      gas.push_back(ball);
+    }
+  }
+
+  Simulator sim(gas, pu::Length{kDistance});
+  sim.EnableGravity(false);
+  sim.SetCollisionMode(CollisionMode::kEventDriven);
+
+  auto energy = [&sim] {
+    const auto& p = sim.Particles();
+    double e = 0.0;
+    for (std::size_t i = 0; i < p.Size(); ++i) {
+      e += 0.5 * p.mass[i] * (p.vx[i] * p.vx[i] + p.vy[i] * p.vy[i] + p.vz[i] * p.vz[i]);
+    }
+    return e;
+  };
+
+  const double e0 = energy();
+  for (std::size_t step = 0; step < 5; ++step) {
+    sim.Step(pu::Time{0.2});
+  }
+  EXPECT_NEAR(energy() / e0, 1.0, 1e-12);
+
+  const auto& p = sim.Particles();
+  for (std::size_t i = 0; i < p.Size(); ++i) {
+    for (std::size_t j = i + 1; j < p.Size(); ++j) {
+      const double d = std::hypot(p.x[j] - p.x[i], p.y[j] - p.y[i], p.z[j] - p.z[i]);
+      EXPECT_GT(d, kDistance * (1.0 - 1e-9)) << i << " " << j;
+    }
+  }
+}
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include <physics/object/object.hpp>
+#include <physics/simulator/simulator.hpp>
+#include <physics/units/quantity.hpp>
+#include <physics/vector/vector.hpp>
+
+#include "bodies.hpp"
+
+namespace pu = physics::units;
+using physics::object::Object;
+using physics::simulator::GravitySolver;
+using physics::simulator::Integrator;
+using physics::simulator::KernelIsa;
+using physics::simulator::Simulator;
+using physics::tests::Cloud;
+using physics::tests::RandomBodies;
+
+namespace {
+
+// Тяжелые тела в кубе 8 м: и гравитация, и удары заметно меняют траектории за несколько шагов
+constexpr Cloud kCloud{.high = 8.0, .speed = 1.0, .mass_low = 1e9, .mass_high = 1e11};
+
+// Положения, скорости, ускорения и полная энергия после нескольких шагов
+std::vector<double> Run(const std::vector<Object>& objects, std::size_t threads, const std::function<void(Simulator&)>& setup) {
+  Simulator sim(objects, pu::Length{0.3});
+  sim.SetDeterministic(true);
+  sim.SetThreads(threads);
+  sim.SetDiagnostics(1);
+  setup(sim);
+  for (int step = 0; step < 3; ++step) {
+    sim.Step(pu::Time{0.01});
+  }
+
+  const auto& p = sim.Particles();
+  std::vector<double> state;
+  for (std::size_t i = 0; i < p.Size(); ++i) {
+    state.insert(state.end(), {p.x[i], p.y[i], p.z[i], p.vx[i], p.vy[i], p.vz[i], p.ax[i], p.ay[i], p.az[i]});
+  }
+  state.push_back(sim.DiagnosticsSeries().back().Total());
+  return state;
+}
+
+void ExpectSameForAnyThreads(const std::vector<Object>& objects, const std::function<void(Simulator&)>& setup) {
+  const auto reference = Run(objects, 1, setup);
+  for (std::size_t threads : {2, 3}) {
+    const auto state = Run(objects, threads, setup);
+    ASSERT_EQ(state.size(), reference.size());
+    for (std::size_t k = 0; k < state.size(); ++k) {
+      // Сравниваем биты: у сетки потенциал не определен, и энергия - NaN
+      ASSERT_EQ(std::bit_cast<std::uint64_t>(state[k]), std::bit_cast<std::uint64_t>(reference[k])) << "threads " << threads << ", value " << k;
+    }
+  }
+}
+
+}  // namespace
+
+TEST(DeterministicTest, PairwiseIsIdenticalForAnyThreadCount) {
+  const auto objects = RandomBodies(300, kCloud, 1);
+  ExpectSameForAnyThreads(objects, [](Simulator& sim) { sim.SetKernelIsa(KernelIsa::kScalar); });
+  ExpectSameForAnyThreads(objects, [](Simulator& sim) {
+    sim.SetKernelIsa(KernelIsa::kScalar);
+    sim.SetIntegrator(Integrator::kVelocityVerlet);
+  });
+}
+
+TEST(DeterministicTest, SolversAndBlockStepsAreIdenticalForAnyThreadCount) {
+  // Вектор целей режется на куски, кратные ширине регистра, поэтому хвост векторного ядра не зависит от потоков
+  const auto objects = RandomBodies(321, kCloud, 2);
+  ExpectSameForAnyThreads(objects, [](Simulator&) {});
+  ExpectSameForAnyThreads(objects, [](Simulator& sim) { sim.SetBlockTimeSteps(3); });
+  ExpectSameForAnyThreads(objects, [](Simulator& sim) { sim.SetGravitySolver(GravitySolver::kBarnesHut); });
+  ExpectSameForAnyThreads(objects, [](Simulator& sim) {
+    physics::simulator::MeshOptions mesh;
+    mesh.grid = 16;
+    sim.SetGravitySolver(GravitySolver::kParticleMesh);
+    sim.SetMeshOptions(mesh);
+  });
+}
+
+TEST(DeterministicTest, MatchesFastModeUpToRounding) {
+  const auto objects = RandomBodies(300, kCloud, 3);
+  Simulator fast(objects, pu::Length{0.0});
+  Simulator deterministic(objects, pu::Length{0.0});
+  EXPECT_FALSE(fast.Deterministic());
+  deterministic.SetDeterministic(true);
+  for (Simulator* sim : {&fast, &deterministic}) {
+    sim->SetKernelIsa(KernelIsa::kScalar);
+    sim->SetThreads(3);
+    sim->Step(pu::Time{0.0});
+  }
+
+  // Меняется только порядок сложения вкладов пар
+  const auto& a = fast.Particles();
+  const auto& b = deterministic.Particles();
+  for (std::size_t i = 0; i < objects.size(); ++i) {
+    ASSERT_NEAR(b.ax[i], a.ax[i], 1e-12 * (1.0 + std::abs(a.ax[i])));
+    ASSERT_NEAR(b.az[i], a.az[i], 1e-12 * (1.0 + std::abs(a.az[i])));
+  }
+}
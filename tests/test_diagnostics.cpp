@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include <physics/constants.hpp>
+#include <physics/object/object.hpp>
+#include <physics/simulator/diagnostics.hpp>
+#include <physics/simulator/simulator.hpp>
+#include <physics/units/quantity.hpp>
+#include <physics/vector/vector.hpp>
+
+#include "bodies.hpp"
+
+namespace pu = physics::units;
+using physics::object::Object;
+using physics::simulator::Diagnostics;
+using physics::simulator::GravitySolver;
+using physics::simulator::Integrator;
+using physics::simulator::KernelIsa;
+using physics::simulator::Simulator;
+using physics::tests::Cloud;
+using physics::tests::RandomBodies;
+
+namespace {
+
+// Плотное облако, чтобы часть тел сталкивалась
+constexpr Cloud kCloud{.low = -10.0, .high = 10.0, .speed = 0.5, .mass_low = 1e8, .mass_high = 1e10};
+
+// Энергии прямым перебором пар по текущему состоянию
+Diagnostics BruteForce(const Simulator& sim, double softening) {
+  const auto& p = sim.Particles();
+  const double g = physics::constants::kG.value;
+
+  Diagnostics d;
+  for (std::size_t i = 0; i < p.Size(); ++i) {
+    d.kinetic += 0.5 * p.mass[i] * (p.vx[i] * p.vx[i] + p.vy[i] * p.vy[i] + p.vz[i] * p.vz[i]);
+    d.momentum[0] += p.mass[i] * p.vx[i];
+    d.angular_momentum[2] += p.mass[i] * (p.x[i] * p.vy[i] - p.y[i] * p.vx[i]);
+    for (std::size_t j = i + 1; j < p.Size(); ++j) {
+      const double dx = p.x[j] - p.x[i];
+      const double dy = p.y[j] - p.y[i];
+      const double dz = p.z[j] - p.z[i];
+      const double r2 = dx * dx + dy * dy + dz * dz;
+      if (r2 > 0.0) {
+        d.potential -= g * p.mass[i] * p.mass[j] / std::sqrt(r2 + softening * softening);
+      }
+    }
+  }
+  return d;
+}
+
+}  // namespace
+
+TEST(DiagnosticsTest, FusedValuesMatchBruteForce) {
+  constexpr double kSoftening = 0.5;
+
+  for (auto isa : {KernelIsa::kScalar, physics::simulator::DetectKernelIsa()}) {
+    for (auto integrator : {Integrator::kSemiImplicitEuler, Integrator::kVelocityVerlet, Integrator::kLeapfrog, Integrator::kRungeKutta4}) {
+      for (std::size_t threads : {1, 3}) {
+        Simulator sim(RandomBodies(70, kCloud, 1), pu::Length{0.4});
+        sim.SetKernelIsa(isa);
+        sim.SetIntegrator(integrator);
+        sim.SetSoftening(pu::Length{kSoftening});
+        sim.SetThreads(threads);
+        sim.SetDiagnostics(1);
+
+        // Эталон считается по состоянию после каждого шага, пока ряд еще ждет потенциал
+        std::vector<Diagnostics> expected;
+        for (std::size_t step = 0; step < 30; ++step) {
+          sim.Step(pu::Time{0.5});
+          expected.push_back(BruteForce(sim, kSoftening));
+        }
+
+        const auto& series = sim.DiagnosticsSeries();
+        ASSERT_EQ(series.size(), expected.size());
+        for (std::size_t k = 0; k < series.size(); ++k) {
+          const auto& d = series[k];
+          const auto& e = expected[k];
+          EXPECT_EQ(d.step, k + 1);
+          EXPECT_NEAR(d.potential, e.potential, 1e-10 * std::abs(e.potential)) << "step " << k << " integrator " << static_cast<int>(integrator);
+          EXPECT_NEAR(d.kinetic, e.kinetic, 1e-12 * e.kinetic);
+          EXPECT_NEAR(d.momentum[0], e.momentum[0], 1e-6 * e.kinetic);
+          EXPECT_NEAR(d.angular_momentum[2], e.angular_momentum[2], 1e-6 * e.kinetic);
+        }
+
+        const Diagnostics now = sim.ComputeDiagnostics();
+        EXPECT_EQ(now.potential, series.back().potential);
+        EXPECT_EQ(now.kinetic, series.back().kinetic);
+      }
+    }
+  }
+}
+
+TEST(DiagnosticsTest, TrajectoryIsUnchanged) {
+  for (auto integrator : {Integrator::kSemiImplicitEuler, Integrator::kVelocityVerlet, Integrator::kYoshida4}) {
+    for (std::size_t block : {0, 3}) {
+      Simulator plain(RandomBodies(60, kCloud, 2), pu::Length{0.4});
+      Simulator observed(RandomBodies(60, kCloud, 2), pu::Length{0.4});
+      for (Simulator* sim : {&plain, &observed}) {
+        sim->SetIntegrator(integrator);
+        sim->SetBlockTimeSteps(block);
+        sim->SetSoftening(pu::Length{0.1});
+      }
+      observed.SetDiagnostics(3);
+
+      for (std::size_t step = 0; step < 40; ++step) {
+        plain.Step(pu::Time{0.5});
+        observed.Step(pu::Time{0.5});
+        if (step == 20) {
+          EXPECT_EQ(observed.DiagnosticsSeries().size(), 7U);
+        }
+      }
+      EXPECT_EQ(observed.DiagnosticsSeries().size(), 13U);
+
+      const auto& a = plain.Particles();
+      const auto& b = observed.Particles();
+      for (std::size_t i = 0; i < a.Size(); ++i) {
+        ASSERT_EQ(a.x[i], b.x[i]) << "integrator " << static_cast<int>(integrator) << " block " << block;
+        ASSERT_EQ(a.vy[i], b.vy[i]) << "integrator " << static_cast<int>(integrator) << " block " << block;
+      }
+    }
+  }
+}
+
+TEST(DiagnosticsTest, SeriesFollowsSolver) {
+  Simulator direct(RandomBodies(40, kCloud, 3), pu::Length{0.0});
+  direct.SetDiagnostics(5);
+  direct.Run(23, pu::Time{0.1});
+
+  const auto& series = direct.DiagnosticsSeries();
+  ASSERT_EQ(series.size(), 4U);
+  EXPECT_EQ(series[3].step, 20U);
+  EXPECT_NEAR(series[3].time, 2.0, 1e-12);
+  EXPECT_LT(series[3].potential, 0.0);
+
+  // При theta = 0 дерево раскрывается до листьев и дает ту же сумму
+  Simulator tree(RandomBodies(40, kCloud, 3), pu::Length{0.0});
+  tree.SetGravitySolver(GravitySolver::kBarnesHut);
+  tree.SetTheta(0.0);
+  const Diagnostics d = tree.ComputeDiagnostics();
+  EXPECT_NEAR(d.potential, BruteForce(tree, 0.0).potential, 1e-10 * std::abs(d.potential));
+
+  tree.SetGravitySolver(GravitySolver::kParticleMesh);
+  EXPECT_TRUE(std::isnan(tree.ComputeDiagnostics().potential));
+
+  direct.ClearDiagnostics();
+  EXPECT_TRUE(direct.DiagnosticsSeries().empty());
+}
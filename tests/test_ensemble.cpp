@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include <physics/object/object.hpp>
+#include <physics/simulator/ensemble.hpp>
+#include <physics/simulator/simulator.hpp>
+#include <physics/units/quantity.hpp>
+#include <physics/vector/vector.hpp>
+
+#include "bodies.hpp"
+
+namespace pu = physics::units;
+using physics::object::Object;
+using physics::simulator::Ensemble;
+using physics::simulator::Integrator;
+using physics::simulator::KernelIsa;
+using physics::simulator::Simulator;
+using physics::tests::ThreeBalls;
+
+namespace {
+
+// Копия r получает свой разброс начальных скоростей
+std::vector<double> PerturbedVelocities(std::size_t replicas, const std::vector<Object>& bodies) {
+  std::mt19937 gen(5);
+  std::normal_distribution<double> noise(0.0, 0.05);
+
+  std::vector<double> velocities;
+  for (std::size_t r = 0; r < replicas; ++r) {
+    for (const auto& body : bodies) {
+      for (std::size_t k = 0; k < 3; ++k) {
+        velocities.push_back(body.speed[k].value + (k < 2 ? noise(gen) : 0.0));
+      }
+    }
+  }
+  return velocities;
+}
+
+}  // namespace
+
+TEST(EnsembleTest, ReplicasMatchSimulatorBitwise) {
+  // Число копий не кратно ширине регистра, чтобы задеть пустые линии
+  constexpr std::size_t kReplicas = 13;
+  const auto balls = ThreeBalls();
+  const std::vector<Object> bodies(balls.begin(), balls.end());
+  const auto velocities = PerturbedVelocities(kReplicas, bodies);
+
+  for (auto isa : {KernelIsa::kScalar, KernelIsa::kSse2, KernelIsa::kAvx2, KernelIsa::kAvx512}) {
+    if (isa > physics::simulator::DetectKernelIsa()) {
+      continue;
+    }
+
+    for (auto integrator : {Integrator::kSemiImplicitEuler, Integrator::kVelocityVerlet, Integrator::kRungeKutta4}) {
+      Ensemble ensemble(kReplicas, bodies, pu::Length{0.3});
+      ensemble.SetKernelIsa(isa);
+      ensemble.SetIntegrator(integrator);
+      ensemble.SetSoftening(pu::Length{0.01});
+      ensemble.SetVelocities(velocities.data());
+      ensemble.SetThreads(3);
+      ensemble.Run(1000, pu::Time{0.01});
+
+      std::vector<double> positions(kReplicas * bodies.size() * 3);
+      ensemble.GetPositions(positions.data());
+
+      for (std::size_t r = 0; r < kReplicas; ++r) {
+        Simulator reference(bodies, pu::Length{0.3});
+        reference.SetKernelIsa(KernelIsa::kScalar);
+        reference.SetIntegrator(integrator);
+        reference.SetSoftening(pu::Length{0.01});
+        for (std::size_t i = 0; i < bodies.size(); ++i) {
+          const double* v = velocities.data() + 3 * (r * bodies.size() + i);
+          reference.Particles().vx[i] = v[0];
+          reference.Particles().vy[i] = v[1];
+          reference.Particles().vz[i] = v[2];
+        }
+        for (std::size_t step = 0; step < 1000; ++step) {
+          reference.Step(pu::Time{0.01});
+        }
+
+        const auto& p = reference.Particles();
+        for (std::size_t i = 0; i < bodies.size(); ++i) {
+          const double* q = positions.data() + 3 * (r * bodies.size() + i);
+          ASSERT_EQ(q[0], p.x[i]) << "isa " << static_cast<int>(isa) << " integrator " << static_cast<int>(integrator) << " replica " << r;
+          ASSERT_EQ(q[1], p.y[i]) << "isa " << static_cast<int>(isa) << " integrator " << static_cast<int>(integrator) << " replica " << r;
+          ASSERT_EQ(ensemble.Get(r, i).speed[0].value, p.vx[i]);
+        }
+        if (physics::simulator::kStatsEnabled) {
+          EXPECT_EQ(ensemble.CollisionCounts()[r], reference.Stats().collisions_resolved) << "replica " << r;
+        }
+      }
+    }
+  }
+}
+
+TEST(EnsembleTest, ArraysRoundTrip) {
+  const auto balls = ThreeBalls();
+  const std::vector<Object> bodies(balls.begin(), balls.end());
+  Ensemble ensemble(5, bodies, pu::Length{0.0});
+
+  std::vector<double> positions(5 * 3 * 3);
+  std::vector<double> masses(5 * 3);
+  for (std::size_t k = 0; k < positions.size(); ++k) {
+    positions[k] = static_cast<double>(k);
+  }
+  for (std::size_t k = 0; k < masses.size(); ++k) {
+    masses[k] = 1.0 + static_cast<double>(k);
+  }
+  ensemble.SetPositions(positions.data());
+  ensemble.SetMasses(masses.data());
+
+  std::vector<double> positions_out(positions.size());
+  std::vector<double> masses_out(masses.size());
+  ensemble.GetPositions(positions_out.data());
+  ensemble.GetMasses(masses_out.data());
+  EXPECT_EQ(positions_out, positions);
+  EXPECT_EQ(masses_out, masses);
+
+  // Копия 2, тело 1: координаты (2 * 3 + 1) * 3 .. + 2
+  const auto obj = ensemble.Get(2, 1);
+  EXPECT_EQ(obj.position[0].value, 21.0);
+  EXPECT_EQ(obj.position[2].value, 23.0);
+  EXPECT_EQ(obj.weight.value, 8.0);
+}
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+#include <physics/constants.hpp>
+#include <physics/object/object.hpp>
+#include <physics/simulator/fixed_simulator.hpp>
+#include <physics/simulator/simulator.hpp>
+#include <physics/units/quantity.hpp>
+#include <physics/vector/vector.hpp>
+
+#include "bodies.hpp"
+
+namespace pu = physics::units;
+using physics::object::Object;
+using physics::simulator::FixedSimulator;
+using physics::simulator::Integrator;
+using physics::simulator::KernelIsa;
+using physics::simulator::Simulator;
+using physics::tests::Body;
+using physics::tests::ThreeBalls;
+
+TEST(FixedSimulatorTest, MatchesSimulatorBitwise) {
+  static_assert(std::is_trivially_copyable_v<FixedSimulator<3>>, "state must live inside the object");
+
+  for (auto integrator : {Integrator::kSemiImplicitEuler, Integrator::kVelocityVerlet, Integrator::kLeapfrog, Integrator::kYoshida4, Integrator::kRungeKutta4}) {
+    const auto balls = ThreeBalls();
+
+    Simulator reference(std::vector<Object>(balls.begin(), balls.end()), pu::Length{0.3});
+    reference.SetKernelIsa(KernelIsa::kScalar);
+    reference.SetIntegrator(integrator);
+    reference.SetSoftening(pu::Length{0.01});
+
+    FixedSimulator<3> sim(balls, pu::Length{0.3});
+    sim.SetIntegrator(integrator);
+    sim.SetSoftening(pu::Length{0.01});
+
+    for (std::size_t step = 0; step < 2000; ++step) {
+      reference.Step(pu::Time{0.01});
+      sim.Step(pu::Time{0.01});
+    }
+
+    const auto& p = reference.Particles();
+    for (std::size_t i = 0; i < 3; ++i) {
+      EXPECT_EQ(sim.Positions(0)[i], p.x[i]) << "integrator " << static_cast<int>(integrator) << " body " << i;
+      EXPECT_EQ(sim.Positions(1)[i], p.y[i]) << "integrator " << static_cast<int>(integrator) << " body " << i;
+      EXPECT_EQ(sim.Velocities(0)[i], p.vx[i]) << "integrator " << static_cast<int>(integrator) << " body " << i;
+      EXPECT_EQ(sim.Velocities(1)[i], p.vy[i]) << "integrator " << static_cast<int>(integrator) << " body " << i;
+    }
+    EXPECT_EQ(sim.StepCount(), reference.StepCount());
+    if (physics::simulator::kStatsEnabled) {
+      EXPECT_GT(reference.Stats().collisions_resolved, 0u) << "integrator " << static_cast<int>(integrator);
+    }
+  }
+}
+
+TEST(FixedSimulatorTest, CopiesServeParameterSweep) {
+  // Планета и спутник: подбираем скорость спутника, при которой орбита почти круговая
+  constexpr double kPlanetMass = 6e24;
+  constexpr double kRadius = 4e8;
+  const double circular = std::sqrt(physics::constants::kG.value * kPlanetMass / kRadius);
+
+  FixedSimulator<2> base({Object(pu::Weight{kPlanetMass}), Body(7e22, kRadius, 0.0, 0.0, 0.0)}, pu::Length{0.0});
+  base.SetIntegrator(Integrator::kVelocityVerlet);
+
+  double best_speed = 0.0;
+  double best_spread = 1e300;
+  for (double factor = 0.90; factor <= 1.10; factor += 0.01) {
+    auto sim = base;
+    sim.Set(1, Body(7e22, kRadius, 0.0, 0.0, factor * circular));
+
+    double r_min = 1e300;
+    double r_max = 0.0;
+    for (std::size_t step = 0; step < 2000; ++step) {
+      sim.Step(pu::Time{1000.0});
+      const double r = std::hypot(sim.Positions(0)[1] - sim.Positions(0)[0], sim.Positions(1)[1] - sim.Positions(1)[0]);
+      r_min = std::min(r_min, r);
+      r_max = std::max(r_max, r);
+    }
+
+    if (r_max - r_min < best_spread) {
+      best_spread = r_max - r_min;
+      best_speed = factor * circular;
+    }
+  }
+
+  // Копии не делят состояние: исходный симулятор не сдвинулся
+  EXPECT_EQ(base.StepCount(), 0u);
+  // Масса спутника чуть ускоряет круговую скорость относительной орбиты
+  EXPECT_NEAR(best_speed / circular, 1.0, 0.015);
+}
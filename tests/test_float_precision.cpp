@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <numbers>
+#include <vector>
+
+#include <physics/constants.hpp>
+#include <physics/object/object.hpp>
+#include <physics/simulator/gravity_kernel.hpp>
+#include <physics/simulator/particles.hpp>
+#include <physics/simulator/simulator.hpp>
+#include <physics/units/quantity.hpp>
+#include <physics/vector/vector.hpp>
+
+#include "bodies.hpp"
+
+namespace pu = physics::units;
+namespace ps = physics::simulator;
+using physics::object::Object;
+using physics::tests::RandomBodies;
+
+namespace {
+
+// Среднеквадратичная относительная ошибка float-ускорений против double
+double RelativeError(const ps::ParticleStore32& p, const ps::ParticleStore& reference) {
+  double error = 0.0;
+  double norm = 0.0;
+  for (std::size_t i = 0; i < p.Size(); ++i) {
+    error += std::pow(p.ax[i] - reference.ax[i], 2) + std::pow(p.ay[i] - reference.ay[i], 2) + std::pow(p.az[i] - reference.az[i], 2);
+    norm += std::pow(reference.ax[i], 2) + std::pow(reference.ay[i], 2) + std::pow(reference.az[i], 2);
+  }
+  return std::sqrt(error / norm);
+}
+
+// Наибольшее расхождение положений float- и double-симуляторов
+double MaxDistance(const ps::Simulator32& sim, const ps::Simulator& reference) {
+  const auto& p = sim.Particles();
+  const auto& q = reference.Particles();
+  double distance = 0.0;
+  for (std::size_t i = 0; i < p.Size(); ++i) {
+    distance = std::max(distance, std::hypot(p.x[i] - q.x[i], p.y[i] - q.y[i], p.z[i] - q.z[i]));
+  }
+  return distance;
+}
+
+}  // namespace
+
+TEST(FloatPrecisionTest, KernelsMatchDoubleAndAccumulatorsHelp) {
+  const auto objects = RandomBodies(4001, {.high = 100.0, .speed = 0.05, .mass_low = 1e8, .mass_high = 1e10}, 11);
+
+  // Эталон считается в double от уже округленных до float входов, чтобы сравнивать только ошибку суммирования
+  ps::ParticleStore32 rounded;
+  rounded.Assign(objects);
+  ps::ParticleStore reference;
+  reference.Assign(objects);
+  for (std::size_t i = 0; i < reference.Size(); ++i) {
+    reference.x[i] = rounded.x[i];
+    reference.y[i] = rounded.y[i];
+    reference.z[i] = rounded.z[i];
+    reference.mass[i] = rounded.mass[i];
+  }
+  ps::AccumulateGravity(ps::KernelIsa::kScalar, ps::GravitySources{reference.x.data(), reference.y.data(), reference.z.data(), reference.mass.data(), reference.Size()},
+                        ps::GravityTargets{reference.x.data(), reference.y.data(), reference.z.data(), reference.ax.data(), reference.ay.data(),
+                                           reference.az.data(), reference.Size()},
+                        0.0);
+
+  for (auto isa : {ps::KernelIsa::kScalar, ps::KernelIsa::kSse2, ps::KernelIsa::kAvx2, ps::KernelIsa::kAvx512}) {
+    if (isa > ps::DetectKernelIsa()) {
+      continue;
+    }
+
+    double errors[2];
+    for (const bool double_accumulators : {false, true}) {
+      ps::ParticleStore32 p;
+      p.Assign(objects);
+      ps::BasicGravitySources<float> sources{p.x.data(), p.y.data(), p.z.data(), p.mass.data(), p.Size()};
+      ps::BasicGravityTargets<float> targets{p.x.data(), p.y.data(), p.z.data(), p.ax.data(), p.ay.data(), p.az.data(), p.Size()};
+      ps::AccumulateGravity(isa, sources, targets, 0.0, double_accumulators);
+      errors[double_accumulators ? 1 : 0] = RelativeError(p, reference);
+    }
+
+    // Сумма 4000 вкладов во float теряет около 1e-6, в double-накопителях остается ошибка отдельных вкладов
+    EXPECT_LT(errors[0], 1e-5) << "isa " << static_cast<int>(isa);
+    EXPECT_LT(errors[1], 3e-7) << "isa " << static_cast<int>(isa);
+    EXPECT_LT(errors[1], 0.5 * errors[0]) << "isa " << static_cast<int>(isa);
+  }
+}
+
+TEST(FloatPrecisionTest, OrbitStaysCloseToDouble) {
+  constexpr double kSunMass = 1e24;
+  constexpr double kRadius = 1e4;
+  const double v = std::sqrt(physics::constants::kG.value * kSunMass / kRadius);
+  const double period = 2.0 * std::numbers::pi * kRadius / v;
+
+  const std::vector<Object> orbit = {
+      Object(pu::Weight{kSunMass}),
+      Object(pu::Weight{1.0}, physics::vector::Vector<pu::Length, 3>{pu::Length{kRadius}, pu::Length{0.0}, pu::Length{0.0}},
+             physics::vector::Vector<pu::Speed, 3>{pu::Speed{0.0}, pu::Speed{v}, pu::Speed{0.0}}),
+  };
+
+  ps::Simulator reference(orbit, pu::Length{0.0});
+  ps::Simulator32 sim(orbit, pu::Length{0.0});
+  reference.SetIntegrator(ps::Integrator::kVelocityVerlet);
+  sim.SetIntegrator(ps::Integrator::kVelocityVerlet);
+
+  // Один оборот за 1000 шагов; после оборота тело должно вернуться в начальную точку у обоих
+  const pu::Time dt{period / 1000.0};
+  for (std::size_t step = 0; step < 1000; ++step) {
+    reference.Step(dt);
+    sim.Step(dt);
+  }
+
+  EXPECT_LT(MaxDistance(sim, reference), 1e-4 * kRadius);
+  const auto& p = sim.Particles();
+  EXPECT_NEAR(std::hypot(p.x[1] - p.x[0], p.y[1] - p.y[0]), kRadius, 1e-3 * kRadius);
+}
+
+TEST(FloatPrecisionTest, SolversAndCollisionsRunInFloat) {
+  // Плотное облако, где за 20 шагов успевают случиться столкновения
+  const auto objects = RandomBodies(500, {.high = 20.0, .speed = 0.05, .mass_low = 1e8, .mass_high = 1e10}, 11);
+
+  for (auto solver : {ps::GravitySolver::kDirect, ps::GravitySolver::kBarnesHut, ps::GravitySolver::kParticleMesh}) {
+    ps::Simulator reference(objects, pu::Length{0.5});
+    ps::Simulator32 sim(objects, pu::Length{0.5});
+    ps::MeshOptions mesh;
+    mesh.grid = 16;
+    reference.SetGravitySolver(solver);
+    reference.SetMeshOptions(mesh);
+    sim.SetGravitySolver(solver);
+    sim.SetMeshOptions(mesh);
+    sim.SetDoubleAccumulators(true);
+
+    for (std::size_t step = 0; step < 20; ++step) {
+      reference.Step(pu::Time{0.01});
+      sim.Step(pu::Time{0.01});
+    }
+
+    if (ps::kStatsEnabled) {
+      EXPECT_GT(sim.Stats().collisions_resolved, 0u) << "solver " << static_cast<int>(solver);
+    }
+    // Столкновения делают систему хаотичной, поэтому сравнение грубое: float не должен разойтись с double по всему облаку
+    const auto& p = sim.Particles();
+    const auto& q = reference.Particles();
+    double drift = 0.0;
+    for (std::size_t i = 0; i < p.Size(); ++i) {
+      drift += std::hypot(p.x[i] - q.x[i], p.y[i] - q.y[i], p.z[i] - q.z[i]);
+    }
+    EXPECT_LT(drift / static_cast<double>(p.Size()), 0.05) << "solver " << static_cast<int>(solver);
+  }
+}
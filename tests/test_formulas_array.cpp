@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <physics/formulas/gravity.hpp>
+#include <physics/formulas/mech.hpp>
+#include <physics/parallel/thread_pool.hpp>
+#include <physics/units/quantity.hpp>
+
+namespace pg = physics::gravity;
+namespace pm = physics::mech;
+namespace pu = physics::units;
+
+namespace {
+
+// n случайных значений величины Q из [lo, hi)
+template <typename Q>
+std::vector<Q> Random(std::size_t n, double lo, double hi, unsigned seed) {
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<double> dist(lo, hi);
+  std::vector<Q> values(n);
+  for (auto& v : values) {
+    v.value = dist(gen);
+  }
+  return values;
+}
+
+}  // namespace
+
+TEST(FormulasArrayTest, MatchesScalarFormulas) {
+  constexpr std::size_t kN = 1001;
+  const auto mass = Random<pu::Weight>(kN, 1.0, 1e3, 1);
+  const auto mass2 = Random<pu::Weight>(kN, 1e20, 1e25, 2);
+  const auto speed = Random<pu::Speed>(kN, -50.0, 50.0, 3);
+  const auto length = Random<pu::Length>(kN, 1e3, 1e7, 4);
+  const auto accel = Random<pu::Acceleration>(kN, 0.0, 20.0, 5);
+  const auto time = Random<pu::Time>(kN, 0.1, 10.0, 6);
+  const auto spring = Random<pu::SpringConstant>(kN, 1.0, 500.0, 7);
+
+  std::vector<pu::Energy> energy(kN);
+  std::vector<pu::Force> force(kN);
+  std::vector<pu::Speed> speed_out(kN);
+  std::vector<pu::Length> length_out(kN);
+  std::vector<pu::Acceleration> accel_out(kN);
+
+  pm::KineticEnergy(mass, speed, energy);
+  for (std::size_t i = 0; i < kN; ++i) {
+    ASSERT_EQ(energy[i].value, pm::KineticEnergy(mass[i], speed[i]).value);
+  }
+
+  pm::AcceleratedMotion(length, speed, accel, time, length_out);
+  for (std::size_t i = 0; i < kN; ++i) {
+    ASSERT_EQ(length_out[i].value, pm::AcceleratedMotion(length[i], speed[i], accel[i], time[i]).value);
+  }
+
+  pm::ElasticForce(spring, length, force);
+  for (std::size_t i = 0; i < kN; ++i) {
+    ASSERT_EQ(force[i].value, pm::ElasticForce(spring[i], length[i]).value);
+  }
+
+  pg::GravitationalForce(mass, mass2, length, force);
+  for (std::size_t i = 0; i < kN; ++i) {
+    ASSERT_EQ(force[i].value, pg::GravitationalForce(mass[i], mass2[i], length[i]).value);
+  }
+
+  pg::GravitationalAcceleration(mass2, length, accel_out);
+  for (std::size_t i = 0; i < kN; ++i) {
+    ASSERT_EQ(accel_out[i].value, pg::GravitationalAcceleration(mass2[i], length[i]).value);
+  }
+
+  pg::EscapeVelocity(mass2, length, speed_out);
+  for (std::size_t i = 0; i < kN; ++i) {
+    ASSERT_EQ(speed_out[i].value, pg::EscapeVelocity(mass2[i], length[i]).value);
+  }
+}
+
+TEST(FormulasArrayTest, ThreadsDoNotChangeResult) {
+  constexpr std::size_t kN = 200000;
+  const auto mass = Random<pu::Weight>(kN, 1e20, 1e25, 8);
+  const auto radius = Random<pu::Length>(kN, 1e6, 1e8, 9);
+
+  std::vector<pu::Speed> serial(kN);
+  std::vector<pu::Speed> parallel(kN);
+  physics::parallel::ThreadPool pool(4);
+
+  pg::OrbitalVelocity(mass, radius, serial);
+  pg::OrbitalVelocity(mass, radius, parallel, &pool);
+  for (std::size_t i = 0; i < kN; ++i) {
+    ASSERT_EQ(serial[i].value, parallel[i].value) << "element " << i;
+  }
+}
+
+TEST(FormulasArrayTest, SizeMismatchThrows) {
+  const std::vector<pu::Weight> mass(3, pu::Weight{1.0});
+  const std::vector<pu::Speed> speed(4, pu::Speed{1.0});
+  std::vector<pu::Energy> energy(3);
+
+  EXPECT_THROW(pm::KineticEnergy(mass, speed, energy), std::invalid_argument);
+}
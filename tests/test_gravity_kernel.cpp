@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include <physics/constants.hpp>
+#include <physics/object/object.hpp>
+#include <physics/simulator/gravity_kernel.hpp>
+#include <physics/simulator/particles.hpp>
+#include <physics/simulator/simulator.hpp>
+#include <physics/units/quantity.hpp>
+#include <physics/vector/vector.hpp>
+
+#include "bodies.hpp"
+
+namespace pu = physics::units;
+using physics::object::Object;
+using physics::simulator::AccumulateGravity;
+using physics::simulator::GravitySources;
+using physics::simulator::GravityTargets;
+using physics::simulator::KernelIsa;
+using physics::simulator::ParticleStore;
+using physics::simulator::Simulator;
+using physics::tests::Cloud;
+using physics::tests::RandomBodies;
+
+constexpr Cloud kCluster{.low = -50.0, .high = 50.0, .mass_low = 1e8, .mass_high = 1e10};
+
+// Эталон - старый ApplyGravity через Object::GravitationalForceVector
+std::vector<Object> ReferenceAccelerations(std::vector<Object> objects) {
+  for (std::size_t i = 0; i < objects.size(); ++i) {
+    for (std::size_t j = i + 1; j < objects.size(); ++j) {
+      auto f = objects[i].GravitationalForceVector(objects[j]);
+      objects[i].ApplyForce(f);
+      objects[j].ApplyForce(f * -1.0);
+    }
+  }
+  return objects;
+}
+
+TEST(GravityKernelTest, AllKernelsMatchReference) {
+  // Нечетное число тел, чтобы проверить хвост после векторных пачек
+  auto objects = RandomBodies(203, kCluster, 3);
+  auto reference = ReferenceAccelerations(objects);
+
+  for (auto isa : {KernelIsa::kScalar, KernelIsa::kSse2, KernelIsa::kAvx2, KernelIsa::kAvx512}) {
+    if (isa > physics::simulator::DetectKernelIsa()) {
+      continue;
+    }
+
+    ParticleStore p;
+    p.Assign(objects);
+
+    GravitySources sources{p.x.data(), p.y.data(), p.z.data(), p.mass.data(), p.Size()};
+    GravityTargets targets{p.x.data(), p.y.data(), p.z.data(), p.ax.data(), p.ay.data(), p.az.data(), p.Size()};
+    AccumulateGravity(isa, sources, targets, 0.0);
+
+    for (std::size_t i = 0; i < objects.size(); ++i) {
+      const auto& expected = reference[i].acceleration;
+      const double scale = std::abs(expected[0].value) + std::abs(expected[1].value) + std::abs(expected[2].value);
+      EXPECT_NEAR(p.ax[i], expected[0].value, 1e-12 * scale) << "isa " << static_cast<int>(isa);
+      EXPECT_NEAR(p.ay[i], expected[1].value, 1e-12 * scale) << "isa " << static_cast<int>(isa);
+      EXPECT_NEAR(p.az[i], expected[2].value, 1e-12 * scale) << "isa " << static_cast<int>(isa);
+    }
+  }
+}
+
+TEST(GravityKernelTest, PlummerSoftening) {
+  ParticleStore p;
+  p.PushBack(Object(pu::Weight{1e10}));
+  p.PushBack(Object(pu::Weight{1e10}, physics::vector::Vector<pu::Length, 3>{pu::Length{3.0}, pu::Length{0.0}, pu::Length{0.0}}));
+
+  GravitySources sources{p.x.data(), p.y.data(), p.z.data(), p.mass.data(), p.Size()};
+  GravityTargets targets{p.x.data(), p.y.data(), p.z.data(), p.ax.data(), p.ay.data(), p.az.data(), p.Size()};
+  AccumulateGravity(physics::simulator::DetectKernelIsa(), sources, targets, 4.0);
+
+  const double expected = physics::constants::kG.value * 1e10 * 3.0 / std::pow(3.0 * 3.0 + 4.0 * 4.0, 1.5);
+  EXPECT_NEAR(p.ax[0], expected, 1e-15);
+  EXPECT_NEAR(p.ax[1], -expected, 1e-15);
+}
+
+TEST(GravityKernelTest, SimulatorScalarAndVectorPathsAgree) {
+  auto objects = RandomBodies(101, kCluster, 3);
+
+  Simulator scalar(objects, pu::Length{0.0});
+  Simulator vectorized(objects, pu::Length{0.0});
+  scalar.SetKernelIsa(KernelIsa::kScalar);
+  scalar.SetSoftening(pu::Length{0.5});
+  vectorized.SetSoftening(pu::Length{0.5});
+
+  scalar.Step(pu::Time{1.0});
+  vectorized.Step(pu::Time{1.0});
+
+  for (std::size_t i = 0; i < objects.size(); ++i) {
+    for (std::size_t k = 0; k < 3; ++k) {
+      const double a = scalar.Objects()[i].acceleration[k].value;
+      EXPECT_NEAR(vectorized.Objects()[i].acceleration[k].value, a, 1e-10 * std::abs(a) + 1e-18);
+    }
+  }
+}
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <numbers>
+#include <vector>
+
+#include <physics/constants.hpp>
+#include <physics/object/object.hpp>
+#include <physics/simulator/simulator.hpp>
+#include <physics/units/quantity.hpp>
+#include <physics/vector/vector.hpp>
+
+namespace pu = physics::units;
+using physics::object::Object;
+using physics::simulator::Integrator;
+using physics::simulator::Simulator;
+
+namespace {
+
+constexpr double kSunMass = 1e24;
+constexpr double kRadius = 1e4;
+
+// Пробное тело на эллиптической орбите вокруг тяжелого центра
+std::vector<Object> Orbit() {
+  const double v = 0.8 * std::sqrt(physics::constants::kG.value * kSunMass / kRadius);
+  return {
+      Object(pu::Weight{kSunMass}),
+      Object(pu::Weight{1.0}, physics::vector::Vector<pu::Length, 3>{pu::Length{kRadius}, pu::Length{0.0}, pu::Length{0.0}},
+             physics::vector::Vector<pu::Speed, 3>{pu::Speed{0.0}, pu::Speed{v}, pu::Speed{0.0}}),
+  };
+}
+
+double Period() {
+  return 2.0 * std::numbers::pi * std::sqrt(kRadius * kRadius * kRadius / (physics::constants::kG.value * kSunMass));
+}
+
+// Удельная энергия пробного тела относительно центра
+double Energy(const Simulator& sim) {
+  const auto& p = sim.Particles();
+  const double r = std::hypot(p.x[1] - p.x[0], p.y[1] - p.y[0], p.z[1] - p.z[0]);
+  const double v2 = std::pow(p.vx[1] - p.vx[0], 2) + std::pow(p.vy[1] - p.vy[0], 2) + std::pow(p.vz[1] - p.vz[0], 2);
+  return 0.5 * v2 - physics::constants::kG.value * kSunMass / r;
+}
+
+// Наибольшая относительная ошибка энергии за один оборот
+double EnergyError(Integrator integrator, std::size_t steps) {
+  Simulator sim(Orbit(), pu::Length{0.0});
+  sim.SetIntegrator(integrator);
+
+  const double e0 = Energy(sim);
+  double error = 0.0;
+  for (std::size_t step = 0; step < steps; ++step) {
+    sim.Step(pu::Time{Period() / static_cast<double>(steps)});
+    error = std::max(error, std::abs(Energy(sim) / e0 - 1.0));
+  }
+  return error;
+}
+
+}  // namespace
+
+TEST(IntegratorTest, HigherOrderSchemesAreMoreAccurate) {
+  const double euler = EnergyError(Integrator::kSemiImplicitEuler, 200);
+  const double verlet = EnergyError(Integrator::kVelocityVerlet, 200);
+  const double leapfrog = EnergyError(Integrator::kLeapfrog, 200);
+  const double yoshida = EnergyError(Integrator::kYoshida4, 200);
+  const double rk4 = EnergyError(Integrator::kRungeKutta4, 200);
+
+  EXPECT_LT(verlet, euler / 10.0);
+  EXPECT_LT(leapfrog, euler / 10.0);
+  EXPECT_LT(yoshida, verlet / 10.0);
+  EXPECT_LT(rk4, verlet / 10.0);
+}
+
+TEST(IntegratorTest, ConvergenceOrder) {
+  // При уменьшении шага вдвое ошибка падает в 2^p раз
+  EXPECT_NEAR(std::log2(EnergyError(Integrator::kSemiImplicitEuler, 400) / EnergyError(Integrator::kSemiImplicitEuler, 800)), 1.0, 0.3);
+  EXPECT_NEAR(std::log2(EnergyError(Integrator::kVelocityVerlet, 400) / EnergyError(Integrator::kVelocityVerlet, 800)), 2.0, 0.3);
+  EXPECT_NEAR(std::log2(EnergyError(Integrator::kYoshida4, 200) / EnergyError(Integrator::kYoshida4, 400)), 4.0, 0.5);
+  // У Рунге-Кутты энергия уходит монотонно и может сходиться даже быстрее
+  EXPECT_GT(std::log2(EnergyError(Integrator::kRungeKutta4, 200) / EnergyError(Integrator::kRungeKutta4, 400)), 3.5);
+}
+
+TEST(IntegratorTest, VerletRecomputesForcesAfterEdit) {
+  Simulator continued(Orbit(), pu::Length{0.0});
+  continued.SetIntegrator(Integrator::kVelocityVerlet);
+  continued.Run(10, pu::Time{1e-3});
+
+  // Правка тел через Objects() должна сбросить запомненные ускорения
+  continued.Objects()[1].position[0] = pu::Length{2.0 * kRadius};
+  Simulator fresh(continued.Objects(), pu::Length{0.0});
+  fresh.SetIntegrator(Integrator::kVelocityVerlet);
+
+  continued.Step(pu::Time{1e-3});
+  fresh.Step(pu::Time{1e-3});
+
+  for (std::size_t i = 0; i < 2; ++i) {
+    for (std::size_t k = 0; k < 3; ++k) {
+      EXPECT_DOUBLE_EQ(continued.Objects()[i].position[k].value, fresh.Objects()[i].position[k].value);
+      EXPECT_DOUBLE_EQ(continued.Objects()[i].speed[k].value, fresh.Objects()[i].speed[k].value);
+    }
+  }
+}
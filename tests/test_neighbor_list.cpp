@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include <physics/constants.hpp>
+#include <physics/object/object.hpp>
+#include <physics/simulator/neighbor_list.hpp>
+#include <physics/simulator/particles.hpp>
+#include <physics/simulator/simulator.hpp>
+#include <physics/units/quantity.hpp>
+#include <physics/vector/vector.hpp>
+
+#include "bodies.hpp"
+
+namespace pu = physics::units;
+using physics::object::Object;
+using physics::simulator::BroadPhase;
+using physics::simulator::GravitySolver;
+using physics::simulator::NeighborList;
+using physics::simulator::ParticleStore;
+using physics::simulator::Simulator;
+using physics::tests::RandomBodies;
+
+namespace {
+
+std::vector<NeighborList::Pair> BrutePairs(const ParticleStore& p, double distance) {
+  std::vector<NeighborList::Pair> pairs;
+  for (std::size_t i = 0; i < p.Size(); ++i) {
+    for (std::size_t j = i + 1; j < p.Size(); ++j) {
+      const double dx = p.x[j] - p.x[i];
+      const double dy = p.y[j] - p.y[i];
+      const double dz = p.z[j] - p.z[i];
+      if (dx * dx + dy * dy + dz * dz <= distance * distance) {
+        pairs.emplace_back(i, j);
+      }
+    }
+  }
+  return pairs;
+}
+
+}  // namespace
+
+TEST(NeighborListTest, KeepsPairsUntilHalfSkinMoved) {
+  ParticleStore p;
+  p.Assign(RandomBodies(600, {.high = 8.0, .speed = 1.0, .mass_low = 1e9, .mass_high = 1e9}, 5));
+  std::mt19937 gen(9);
+  std::normal_distribution<double> jitter(0.0, 0.01);
+
+  NeighborList list;
+  ASSERT_TRUE(list.Update(p, 0.6, 0.3));
+
+  // Пока список не перестроен, в нем должны быть все пары ближе радиуса
+  for (int frame = 0; frame < 40; ++frame) {
+    list.Update(p, 0.6, 0.3);
+    const auto& pairs = list.Pairs();
+    for (const auto& pair : BrutePairs(p, 0.6)) {
+      ASSERT_TRUE(std::binary_search(pairs.begin(), pairs.end(), pair)) << "frame " << frame;
+    }
+
+    for (std::size_t i = 0; i < p.Size(); ++i) {
+      p.x[i] += jitter(gen);
+      p.y[i] += jitter(gen);
+      p.z[i] += jitter(gen);
+    }
+  }
+  EXPECT_GT(list.Rebuilds(), 1U);
+  EXPECT_LT(list.Rebuilds(), 20U);
+
+  // Списки по телам - те же пары в обе стороны
+  std::size_t entries = 0;
+  for (std::size_t i = 0; i < p.Size(); ++i) {
+    entries += list.Start(i + 1) - list.Start(i);
+  }
+  EXPECT_EQ(entries, 2 * list.Pairs().size());
+
+  list.Update(p, 0.6, 0.3);
+  EXPECT_FALSE(list.Update(p, 0.6, 0.3));
+  EXPECT_TRUE(list.Update(p, 0.7, 0.3));
+}
+
+TEST(NeighborListTest, CutoffGravityMatchesTruncatedSum) {
+  const auto objects = RandomBodies(300, {.high = 10.0, .speed = 1.0, .mass_low = 1e9, .mass_high = 1e9}, 3);
+  constexpr double kCutoff = 2.5;
+
+  for (std::size_t threads : {1, 3}) {
+    Simulator sim(objects, pu::Length{0.0});
+    sim.SetGravitySolver(GravitySolver::kCutoff);
+    sim.SetCutoff(pu::Length{kCutoff});
+    sim.SetSkin(pu::Length{0.5});
+    sim.SetSoftening(pu::Length{0.1});
+    sim.SetThreads(threads);
+    sim.SetDiagnostics(1);
+    sim.Step(pu::Time{0.0});
+
+    const auto& p = sim.Particles();
+    const double g = physics::constants::kG.value;
+    double potential = 0.0;
+    for (std::size_t i = 0; i < p.Size(); ++i) {
+      double acc[3] = {0.0, 0.0, 0.0};
+      for (std::size_t j = 0; j < p.Size(); ++j) {
+        const double d[3] = {p.x[j] - p.x[i], p.y[j] - p.y[i], p.z[j] - p.z[i]};
+        const double r2 = d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+        if (j == i || r2 > kCutoff * kCutoff) {
+          continue;
+        }
+        const double d2 = r2 + 0.01;
+        for (std::size_t k = 0; k < 3; ++k) {
+          acc[k] += g * p.mass[j] * d[k] / (d2 * std::sqrt(d2));
+        }
+        potential -= 0.5 * g * p.mass[i] * p.mass[j] / std::sqrt(d2);
+      }
+      EXPECT_NEAR(p.ax[i], acc[0], 1e-12 * std::abs(acc[0]) + 1e-18);
+      EXPECT_NEAR(p.az[i], acc[2], 1e-12 * std::abs(acc[2]) + 1e-18);
+    }
+    EXPECT_NEAR(sim.DiagnosticsSeries().back().potential, potential, 1e-10 * std::abs(potential));
+  }
+}
+
+TEST(NeighborListTest, CollisionsMatchBruteForce) {
+  const auto objects = RandomBodies(500, {.high = 8.0, .speed = 1.0, .mass_low = 1e9, .mass_high = 1e9}, 13);
+
+  // Запас списка покрывает и тела, которые сдвинули предыдущие удары того же шага, как в полном переборе
+  Simulator brute(objects, pu::Length{0.4});
+  Simulator list(objects, pu::Length{0.4});
+  for (Simulator* sim : {&brute, &list}) {
+    sim->SetGravitySolver(GravitySolver::kCutoff);
+    sim->SetCutoff(pu::Length{1.0});
+  }
+  brute.SetBroadPhase(BroadPhase::kBruteForce);
+  list.SetBroadPhase(BroadPhase::kNeighborList);
+  list.SetSkin(pu::Length{0.3});
+
+  for (int step = 0; step < 50; ++step) {
+    brute.Step(pu::Time{0.02});
+    list.Step(pu::Time{0.02});
+  }
+
+  const auto& a = brute.Particles();
+  const auto& b = list.Particles();
+  for (std::size_t i = 0; i < a.Size(); ++i) {
+    ASSERT_EQ(a.x[i], b.x[i]);
+    ASSERT_EQ(a.vy[i], b.vy[i]);
+  }
+  // Тела проходят около 0.02 за шаг, поэтому половину запаса проходят не раньше чем за несколько шагов
+  EXPECT_LT(list.NeighborListRebuilds(), 25U);
+}
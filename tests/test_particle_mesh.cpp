@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include <physics/constants.hpp>
+#include <physics/object/object.hpp>
+#include <physics/simulator/particle_mesh.hpp>
+#include <physics/simulator/particles.hpp>
+#include <physics/simulator/simulator.hpp>
+#include <physics/units/quantity.hpp>
+#include <physics/vector/vector.hpp>
+
+namespace pu = physics::units;
+using physics::object::Object;
+using physics::simulator::GravitySolver;
+using physics::simulator::MeshAssignment;
+using physics::simulator::MeshBoundary;
+using physics::simulator::MeshOptions;
+using physics::simulator::ParticleMesh;
+using physics::simulator::ParticleStore;
+using physics::simulator::Simulator;
+
+namespace {
+
+Object Body(double x, double y, double z) {
+  return Object(pu::Weight{1e10}, physics::vector::Vector<pu::Length, 3>{pu::Length{x}, pu::Length{y}, pu::Length{z}});
+}
+
+// Доля тел с относительной ошибкой ускорения не больше tolerance
+double FractionWithin(const std::vector<Object>& got, const std::vector<Object>& expected, double tolerance) {
+  std::size_t good = 0;
+  for (std::size_t i = 0; i < got.size(); ++i) {
+    double diff = 0.0;
+    double norm = 0.0;
+    for (std::size_t k = 0; k < 3; ++k) {
+      diff += std::pow(got[i].acceleration[k].value - expected[i].acceleration[k].value, 2);
+      norm += std::pow(expected[i].acceleration[k].value, 2);
+    }
+    good += std::sqrt(diff) <= tolerance * std::sqrt(norm) ? 1 : 0;
+  }
+  return static_cast<double>(good) / static_cast<double>(got.size());
+}
+
+}  // namespace
+
+TEST(ParticleMeshTest, IsolatedP3MMatchesDirectSum) {
+  std::mt19937 gen(2);
+  std::normal_distribution<double> pos(0.0, 10.0);
+  std::vector<Object> cloud;
+  for (std::size_t i = 0; i < 1000; ++i) {
+    cloud.push_back(Body(pos(gen), pos(gen), pos(gen)));
+  }
+
+  Simulator direct(cloud, pu::Length{0.0});
+  Simulator mesh(cloud, pu::Length{0.0});
+  mesh.SetGravitySolver(GravitySolver::kParticleMesh);
+
+  for (auto assignment : {MeshAssignment::kCic, MeshAssignment::kTsc}) {
+    MeshOptions options;
+    options.grid = 32;
+    options.assignment = assignment;
+    options.short_range = true;
+    mesh.SetMeshOptions(options);
+
+    mesh.Objects() = cloud;
+    direct.Objects() = cloud;
+    mesh.Step(pu::Time{1e-9});
+    direct.Step(pu::Time{1e-9});
+
+    EXPECT_GE(FractionWithin(mesh.Objects(), direct.Objects(), 0.05), 0.9) << static_cast<int>(assignment);
+  }
+}
+
+TEST(ParticleMeshTest, PeriodicPairForceMatchesNewton) {
+  for (double separation : {0.5, 2.0, 10.0}) {
+    ParticleStore p;
+    p.PushBack(Body(50.0, 50.0, 50.0));
+    p.PushBack(Body(50.0 + separation, 50.0, 50.0));
+
+    MeshOptions options;
+    options.boundary = MeshBoundary::kPeriodic;
+    options.box_size = 100.0;
+    options.short_range = true;
+
+    ParticleMesh mesh;
+    mesh.AddAccelerations(p, options, 0.0, p.ax.data(), p.ay.data(), p.az.data());
+
+    // Образы в соседних коробках дают поправку меньше процента
+    const double expected = physics::constants::kG.value * 1e10 / (separation * separation);
+    EXPECT_NEAR(p.ax[0] / expected, 1.0, 0.02) << separation;
+    EXPECT_NEAR(p.ax[1] / expected, -1.0, 0.02) << separation;
+    EXPECT_NEAR(p.ay[0] / expected, 0.0, 1e-9);
+  }
+}
+
+TEST(ParticleMeshTest, PeriodicMomentumIsConserved) {
+  std::mt19937 gen(4);
+  std::uniform_real_distribution<double> pos(0.0, 1.0);
+
+  ParticleStore p;
+  for (std::size_t i = 0; i < 500; ++i) {
+    p.PushBack(Body(pos(gen), pos(gen), pos(gen)));
+  }
+
+  MeshOptions options;
+  options.grid = 32;
+  options.boundary = MeshBoundary::kPeriodic;
+  options.box_size = 1.0;
+  ParticleMesh mesh;
+  mesh.AddAccelerations(p, options, 0.0, p.ax.data(), p.ay.data(), p.az.data());
+
+  // Одна и та же схема для раздачи и сбора: силы попарно уравновешены
+  double total[3] = {0.0, 0.0, 0.0};
+  double scale = 0.0;
+  for (std::size_t i = 0; i < p.Size(); ++i) {
+    total[0] += p.mass[i] * p.ax[i];
+    total[1] += p.mass[i] * p.ay[i];
+    total[2] += p.mass[i] * p.az[i];
+    scale += p.mass[i] * std::hypot(p.ax[i], p.ay[i], p.az[i]);
+  }
+  for (double t : total) {
+    EXPECT_LT(std::abs(t), 1e-10 * scale);
+  }
+}
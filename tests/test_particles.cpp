@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <vector>
+
+#include <physics/object/object.hpp>
+#include <physics/simulator/particles.hpp>
+#include <physics/simulator/simulator.hpp>
+#include <physics/units/quantity.hpp>
+#include <physics/vector/vector.hpp>
+
+namespace pu = physics::units;
+using physics::object::Object;
+using physics::simulator::ParticleStore;
+using physics::simulator::Simulator;
+using physics::vector::Vector;
+
+std::vector<Object> ThreeBodies() {
+  using pu::operator""_kg;
+  using pu::operator""_m;
+  using pu::operator""_ms;
+
+  return {
+      Object(1e10_kg, {0.0_m, 0.0_m, 0.0_m}, {0.0_ms, 0.1_ms, 0.0_ms}),
+      Object(2e10_kg, {10.0_m, 0.0_m, 1.0_m}, {0.0_ms, 0.2_ms * -1, 0.0_ms}),
+      Object(5e9_kg, {0.0_m, 7.0_m * -1, 0.0_m}, {0.3_ms, 0.0_ms, 0.1_ms}),
+  };
+}
+
+TEST(ParticleStoreTest, RoundTripsObjects) {
+  auto objects = ThreeBodies();
+
+  ParticleStore store;
+  store.Assign(objects);
+
+  std::vector<Object> back;
+  store.Store(back);
+
+  ASSERT_EQ(back.size(), objects.size());
+  for (std::size_t i = 0; i < objects.size(); ++i) {
+    EXPECT_EQ(back[i].weight.value, objects[i].weight.value);
+    for (std::size_t k = 0; k < 3; ++k) {
+      EXPECT_EQ(back[i].position[k].value, objects[i].position[k].value);
+      EXPECT_EQ(back[i].speed[k].value, objects[i].speed[k].value);
+    }
+  }
+}
+
+TEST(ParticleStoreTest, StepMatchesObjectUpdateReference) {
+  auto reference = ThreeBodies();
+  Simulator sim(ThreeBodies(), pu::Length{0.0});
+
+  for (int step = 0; step < 100; ++step) {
+    for (auto& obj : reference) {
+      obj.acceleration = {};
+    }
+    for (std::size_t i = 0; i < reference.size(); ++i) {
+      for (std::size_t j = i + 1; j < reference.size(); ++j) {
+        auto f = reference[i].GravitationalForceVector(reference[j]);
+        reference[i].ApplyForce(f);
+        reference[j].ApplyForce(f * -1.0);
+      }
+    }
+    for (auto& obj : reference) {
+      obj.Update(pu::Time{1.0});
+    }
+
+    sim.Step(pu::Time{1.0});
+  }
+
+  for (std::size_t i = 0; i < reference.size(); ++i) {
+    for (std::size_t k = 0; k < 3; ++k) {
+      EXPECT_NEAR(sim.Objects()[i].position[k].value, reference[i].position[k].value, 1e-9);
+      EXPECT_NEAR(sim.Objects()[i].speed[k].value, reference[i].speed[k].value, 1e-12);
+    }
+  }
+}
+
+TEST(ParticleStoreTest, ObjectsViewEditsReachTheSimulation) {
+  Simulator sim(ThreeBodies(), pu::Length{0.0});
+  sim.EnableGravity(false);
+  sim.Step(pu::Time{1.0});
+
+  sim.Objects()[0].speed[0] = pu::Speed{5.0};
+  const double x0 = sim.Objects()[0].position[0].value;
+
+  sim.Step(pu::Time{1.0});
+
+  EXPECT_DOUBLE_EQ(sim.Particles().vx[0], 5.0);
+  EXPECT_DOUBLE_EQ(sim.Objects()[0].position[0].value, x0 + 5.0);
+}
+
+TEST(ParticleStoreTest, HeldObjectsRefreshOnNextCall) {
+  // Правка через ссылку доходит до шага, даже если между ними хранилище прочитали обратно
+  Simulator held(ThreeBodies(), pu::Length{0.0});
+  Simulator fresh(ThreeBodies(), pu::Length{0.0});
+  held.SetIntegrator(physics::simulator::Integrator::kVelocityVerlet);
+  fresh.SetIntegrator(physics::simulator::Integrator::kVelocityVerlet);
+  auto& objects = held.Objects();
+  static_cast<const Simulator&>(held).Particles();
+  objects[2].position[1] = pu::Length{-3.0};
+  fresh.Objects()[2].position[1] = pu::Length{-3.0};
+
+  for (int step = 0; step < 3; ++step) {
+    held.Step(pu::Time{1.0});
+    fresh.Step(pu::Time{1.0});
+  }
+
+  // Шаг не трогает массив: ссылка устарела, правка через нее теряется, а следующий Objects() обновляет тот же массив
+  const double stale = objects[1].position[0].value;
+  objects[1].position[0] = pu::Length{100.0};
+  held.Step(pu::Time{1.0});
+  fresh.Step(pu::Time{1.0});
+  EXPECT_EQ(&held.Objects(), &objects);
+  EXPECT_NE(objects[1].position[0].value, stale);
+  for (std::size_t i = 0; i < objects.size(); ++i) {
+    EXPECT_EQ(objects[i].position[0].value, fresh.Objects()[i].position[0].value);
+    EXPECT_EQ(objects[i].position[1].value, fresh.Objects()[i].position[1].value);
+    EXPECT_EQ(objects[i].speed[0].value, fresh.Objects()[i].speed[0].value);
+  }
+}
+
+TEST(ParticleStoreTest, AddObjectAfterStep) {
+  Simulator sim(ThreeBodies(), pu::Length{0.0});
+  sim.Step(pu::Time{1.0});
+  sim.AddObject(Object(pu::Weight{1.0}));
+
+  EXPECT_EQ(sim.Size(), 4u);
+  EXPECT_EQ(sim.Objects().size(), 4u);
+  EXPECT_EQ(sim.Particles().Size(), 4u);
+}
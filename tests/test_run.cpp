@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <vector>
+
+#include <physics/object/object.hpp>
+#include <physics/simulator/simulator.hpp>
+#include <physics/units/quantity.hpp>
+#include <physics/vector/vector.hpp>
+
+namespace pu = physics::units;
+using physics::object::Object;
+using physics::simulator::Simulator;
+
+std::vector<Object> Balls() {
+  using pu::operator""_kg;
+  using pu::operator""_m;
+  using pu::operator""_ms;
+
+  return {
+      Object(0.17_kg, {0.6_m * -1, 0.0_m, 0.0_m}, {1.5_ms, 0.0_ms, 0.0_ms}),
+      Object(0.17_kg, {0.6_m, 0.3_m * -1, 0.0_m}, {0.5_ms * -1, 0.5_ms, 0.0_ms}),
+      Object(0.17_kg, {0.0_m, 0.4_m, 0.0_m}, {0.0_ms, 1.0_ms * -1, 0.0_ms}),
+  };
+}
+
+TEST(RunTest, MatchesStepLoop) {
+  Simulator stepped(Balls(), pu::Length{0.114});
+  Simulator run(Balls(), pu::Length{0.114});
+  stepped.EnableGravity(false);
+  run.EnableGravity(false);
+
+  auto trajectory = run.Run(500, pu::Time{0.005}, 5, true);
+
+  ASSERT_EQ(trajectory.frames, 100u);
+  ASSERT_EQ(trajectory.bodies, 3u);
+  ASSERT_EQ(trajectory.positions.size(), 100u * 3u * 3u);
+  ASSERT_EQ(trajectory.velocities.size(), 100u * 3u * 3u);
+
+  for (std::size_t step = 1; step <= 500; ++step) {
+    stepped.Step(pu::Time{0.005});
+    if (step % 5 != 0) {
+      continue;
+    }
+
+    const std::size_t frame = step / 5 - 1;
+    for (std::size_t body = 0; body < 3; ++body) {
+      for (std::size_t k = 0; k < 3; ++k) {
+        EXPECT_EQ(trajectory.positions[(frame * 3 + body) * 3 + k], stepped.Objects()[body].position[k].value);
+        EXPECT_EQ(trajectory.velocities[(frame * 3 + body) * 3 + k], stepped.Objects()[body].speed[k].value);
+      }
+    }
+  }
+}
+
+TEST(RunTest, VelocitiesAreOptional) {
+  Simulator sim(Balls(), pu::Length{0.114});
+  auto trajectory = sim.Run(10, pu::Time{0.01});
+
+  EXPECT_EQ(trajectory.frames, 10u);
+  EXPECT_EQ(trajectory.positions.size(), 10u * 3u * 3u);
+  EXPECT_TRUE(trajectory.velocities.empty());
+}
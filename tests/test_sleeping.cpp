@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <vector>
+
+#include <physics/object/object.hpp>
+#include <physics/simulator/simulator.hpp>
+#include <physics/units/quantity.hpp>
+#include <physics/vector/vector.hpp>
+
+namespace pu = physics::units;
+using physics::object::Object;
+using physics::simulator::Simulator;
+
+namespace {
+
+Object Body(double x, double y, double vx) {
+  const physics::vector::Vector<pu::Length, 3> r{pu::Length{x}, pu::Length{y}, pu::Length{0.0}};
+  const physics::vector::Vector<pu::Speed, 3> v{pu::Speed{vx}, pu::Speed{0.0}, pu::Speed{0.0}};
+  return Object(pu::Weight{1.0}, r, v);
+}
+
+void EnableSleeping(Simulator& sim, std::size_t steps) {
+  sim.SetSleeping(pu::Speed{1e-3}, pu::Acceleration{1e-3}, steps);
+}
+
+}  // namespace
+
+TEST(SleepingTest, RestingBodiesSleepAndStaySources) {
+  // Сетка покоящихся тел и ряд движущихся над ней; притяжение единичных масс далеко ниже порогов
+  std::vector<Object> objects;
+  for (std::size_t i = 0; i < 100; ++i) {
+    objects.push_back(Body(static_cast<double>(i % 10), static_cast<double>(i / 10), 0.0));
+  }
+  for (std::size_t i = 0; i < 10; ++i) {
+    objects.push_back(Body(static_cast<double>(i), 20.0, 1.0));
+  }
+
+  Simulator reference(objects, pu::Length{0.1});
+  Simulator sim(objects, pu::Length{0.1});
+  EnableSleeping(sim, 5);
+  std::vector<double> asleep_x;
+  for (int step = 0; step < 50; ++step) {
+    reference.Step(pu::Time{0.01});
+    sim.Step(pu::Time{0.01});
+    if (step == 9) {
+      const auto& p = static_cast<const Simulator&>(sim).Particles();
+      asleep_x.assign(p.x.begin(), p.x.begin() + 100);
+    }
+  }
+
+  EXPECT_EQ(sim.AwakeCount(), 10U);
+  const auto& p = sim.Particles();
+  for (std::size_t i = 0; i < 100; ++i) {
+    ASSERT_TRUE(sim.Asleep(i));
+    ASSERT_EQ(p.x[i], asleep_x[i]);
+    ASSERT_EQ(p.vx[i], 0.0);
+  }
+
+  // Спящие тела по-прежнему притягивают бодрствующие
+  const auto& q = reference.Particles();
+  for (std::size_t i = 100; i < p.Size(); ++i) {
+    EXPECT_FALSE(sim.Asleep(i));
+    EXPECT_NEAR(p.x[i], q.x[i], 1e-12);
+    EXPECT_NEAR(p.vy[i], q.vy[i], 1e-12);
+    EXPECT_LT(p.vy[i], 0.0);
+  }
+}
+
+TEST(SleepingTest, ImpactWakesSleeper) {
+  Simulator sim({Body(0.0, 0.0, 0.0), Body(-3.0, 0.0, 1.0)}, pu::Length{0.5});
+  sim.EnableGravity(false);
+  EnableSleeping(sim, 3);
+
+  for (int step = 0; step < 10; ++step) {
+    sim.Step(pu::Time{0.01});
+  }
+  ASSERT_TRUE(sim.Asleep(0));
+  ASSERT_FALSE(sim.Asleep(1));
+
+  // Равные массы обмениваются скоростями: налетевшее тело останавливается и засыпает, спящее уходит
+  for (int step = 0; step < 400; ++step) {
+    sim.Step(pu::Time{0.01});
+  }
+  EXPECT_FALSE(sim.Asleep(0));
+  EXPECT_NEAR(sim.Particles().vx[0], 1.0, 1e-9);
+  EXPECT_TRUE(sim.Asleep(1));
+  EXPECT_EQ(sim.AwakeCount(), 1U);
+}
+
+TEST(SleepingTest, PassingMassWakesSleeperWithoutContact) {
+  // Тяжелое тело пролетает в метре от спящего; ускорение от него G * M / r^2 превышает порог ближе 26 м
+  const std::vector<Object> objects = {Body(0.0, 0.0, 0.0), Object(pu::Weight{1e10}, {pu::Length{-50.0}, pu::Length{1.0}, pu::Length{0.0}},
+                                                                  {pu::Speed{20.0}, pu::Speed{0.0}, pu::Speed{0.0}})};
+  Simulator reference(objects, pu::Length{0.1});
+  Simulator sim(objects, pu::Length{0.1});
+  EnableSleeping(sim, 3);
+
+  for (int step = 0; step < 500; ++step) {
+    reference.Step(pu::Time{0.01});
+    sim.Step(pu::Time{0.01});
+    if (step == 10) {
+      ASSERT_TRUE(sim.Asleep(0));
+    }
+  }
+
+  // Тело проснулось до сближения и получило почти весь импульс пролета 2 G M / (b v)
+  EXPECT_FALSE(sim.Asleep(0));
+  const double vy = reference.Particles().vy[0];
+  EXPECT_GT(vy, 0.05);
+  EXPECT_NEAR(sim.Particles().vy[0], vy, 0.02 * vy);
+}
+
+TEST(SleepingTest, SpringsAndVelocityWakeWholeChain) {
+  Simulator sim({Body(0.0, 0.0, 0.0), Body(1.0, 0.0, 0.0), Body(2.0, 0.0, 0.0), Body(10.0, 0.0, 0.0)}, pu::Length{0.1});
+  sim.EnableGravity(false);
+  sim.Springs().Add(0, 1, pu::Length{1.0}, pu::SpringConstant{5.0});
+  sim.Springs().Add(1, 2, pu::Length{1.0}, pu::SpringConstant{5.0});
+  EnableSleeping(sim, 2);
+
+  for (int step = 0; step < 3; ++step) {
+    sim.Step(pu::Time{0.01});
+  }
+  ASSERT_EQ(sim.AwakeCount(), 0U);
+
+  // Толчок крайнему телу будит всю цепочку, а отдельное тело продолжает спать
+  sim.Particles().vx[2] = 0.5;
+  sim.Step(pu::Time{0.01});
+  EXPECT_EQ(sim.AwakeCount(), 3U);
+  EXPECT_TRUE(sim.Asleep(3));
+
+  // Растянутая пружина тянет разбуженного соседа со следующего шага
+  sim.Step(pu::Time{0.01});
+  EXPECT_GT(sim.Particles().vx[1], 0.0);
+
+  sim.WakeUp(3);
+  EXPECT_FALSE(sim.Asleep(3));
+  EnableSleeping(sim, 0);
+  EXPECT_EQ(sim.AwakeCount(), 4U);
+}
@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <physics/object/object.hpp>
+#include <physics/simulator/simulator.hpp>
+#include <physics/units/quantity.hpp>
+#include <physics/vector/vector.hpp>
+
+#include "bodies.hpp"
+
+namespace pu = physics::units;
+using physics::object::Object;
+using physics::simulator::Integrator;
+using physics::simulator::ParticleStore;
+using physics::simulator::Simulator;
+using physics::tests::Cloud;
+using physics::tests::RandomBodies;
+
+namespace {
+
+Object Body(double mass, double x, double vx = 0.0) {
+  const physics::vector::Vector<pu::Length, 3> r{pu::Length{x}, pu::Length{0.0}, pu::Length{0.0}};
+  const physics::vector::Vector<pu::Speed, 3> v{pu::Speed{vx}, pu::Speed{0.0}, pu::Speed{0.0}};
+  return Object(pu::Weight{mass}, r, v);
+}
+
+constexpr Cloud kCloud{.low = -5.0, .high = 5.0, .speed = 1.0, .mass_low = 0.5, .mass_high = 2.0};
+
+// Силы пружин по списку, без CSR: на тело a действует f * u, на тело b - обратная
+std::vector<double> PairForces(const ParticleStore& p, const std::vector<std::uint32_t>& a, const std::vector<std::uint32_t>& b,
+                               const std::vector<double>& rest, const std::vector<double>& k, const std::vector<double>& c) {
+  std::vector<double> force(3 * p.Size(), 0.0);
+  for (std::size_t s = 0; s < a.size(); ++s) {
+    const double d[3] = {p.x[b[s]] - p.x[a[s]], p.y[b[s]] - p.y[a[s]], p.z[b[s]] - p.z[a[s]]};
+    const double dv[3] = {p.vx[b[s]] - p.vx[a[s]], p.vy[b[s]] - p.vy[a[s]], p.vz[b[s]] - p.vz[a[s]]};
+    const double length = std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+    const double closing = (dv[0] * d[0] + dv[1] * d[1] + dv[2] * d[2]) / length;
+    const double f = k[s] * (length - rest[s]) + c[s] * closing;
+    for (std::size_t axis = 0; axis < 3; ++axis) {
+      force[3 * a[s] + axis] += f * d[axis] / length;
+      force[3 * b[s] + axis] -= f * d[axis] / length;
+    }
+  }
+  return force;
+}
+
+}  // namespace
+
+TEST(SpringsTest, TwoBodyOscillatorKeepsPeriodAndEnergy) {
+  // Приведенная масса 0.5 и жесткость 4: omega = sqrt(8), тела расходятся до 1.5 и возвращаются через период
+  Simulator sim({Body(1.0, 0.0), Body(1.0, 1.5)}, pu::Length{0.0});
+  sim.EnableGravity(false);
+  sim.SetIntegrator(Integrator::kVelocityVerlet);
+  sim.SetDiagnostics(1);
+  sim.Springs().Add(0, 1, pu::Length{1.0}, pu::SpringConstant{4.0});
+
+  const double period = 2.0 * M_PI / std::sqrt(8.0);
+  const std::size_t steps = 2000;
+  for (std::size_t s = 0; s < steps; ++s) {
+    sim.Step(pu::Time{period / steps});
+  }
+
+  const auto& p = sim.Particles();
+  EXPECT_NEAR(p.x[1] - p.x[0], 1.5, 1e-5);
+  EXPECT_NEAR(p.x[0] + p.x[1], 1.5, 1e-12);
+
+  // Начальная энергия - только упругая: k * 0.5^2 / 2
+  for (const auto& d : sim.DiagnosticsSeries()) {
+    ASSERT_NEAR(d.Total(), 0.5, 1e-5);
+  }
+}
+
+TEST(SpringsTest, ForcesMatchPairSumForAnyThreads) {
+  const std::size_t n = 10000;
+  const auto objects = RandomBodies(n, kCloud, 4);
+
+  std::mt19937 gen(8);
+  std::uniform_int_distribution<std::uint32_t> body(0, n - 1);
+  std::uniform_real_distribution<double> value(0.1, 3.0);
+  std::vector<std::uint32_t> a;
+  std::vector<std::uint32_t> b;
+  std::vector<double> rest;
+  std::vector<double> k;
+  std::vector<double> c;
+  for (std::size_t s = 0; s < 4 * n; ++s) {
+    a.push_back(body(gen));
+    b.push_back((a.back() + 1 + body(gen) % (n - 1)) % n);
+    rest.push_back(value(gen));
+    k.push_back(value(gen));
+    c.push_back(0.1 * value(gen));
+  }
+
+  std::vector<double> reference;
+  for (std::size_t threads : {1, 3}) {
+    Simulator sim(objects, pu::Length{0.0});
+    sim.EnableGravity(false);
+    sim.SetThreads(threads);
+    sim.Springs().Add(a, b, rest, k, c);
+    sim.Step(pu::Time{0.0});
+
+    const auto& p = sim.Particles();
+    const auto force = PairForces(p, a, b, rest, k, c);
+    double momentum[3] = {0.0, 0.0, 0.0};
+    for (std::size_t i = 0; i < n; ++i) {
+      EXPECT_NEAR(p.mass[i] * p.ax[i], force[3 * i], 1e-9 * (1.0 + std::abs(force[3 * i])));
+      EXPECT_NEAR(p.mass[i] * p.az[i], force[3 * i + 2], 1e-9 * (1.0 + std::abs(force[3 * i + 2])));
+      momentum[0] += p.mass[i] * p.ax[i];
+      momentum[1] += p.mass[i] * p.ay[i];
+      momentum[2] += p.mass[i] * p.az[i];
+    }
+    for (double m : momentum) {
+      EXPECT_NEAR(m, 0.0, 1e-8);
+    }
+
+    // У каждого тела свои пружины в порядке добавления, поэтому результат не зависит от числа потоков
+    if (reference.empty()) {
+      reference.assign(p.ax.begin(), p.ax.end());
+    } else {
+      for (std::size_t i = 0; i < n; ++i) {
+        ASSERT_EQ(p.ax[i], reference[i]);
+      }
+    }
+  }
+}
+
+TEST(SpringsTest, BulkAddMatchesSingleAndChecksBodies) {
+  const auto objects = RandomBodies(50, kCloud, 6);
+  const std::vector<std::uint32_t> a = {0, 3, 7, 7, 49};
+  const std::vector<std::uint32_t> b = {1, 2, 8, 20, 0};
+  const std::vector<double> rest = {1.0, 0.5, 2.0, 1.5, 0.1};
+  const std::vector<double> k = {10.0, 3.0, 1.0, 7.0, 2.0};
+  const std::vector<double> c = {0.0, 0.2, 0.0, 1.0, 0.5};
+
+  Simulator single(objects, pu::Length{0.0});
+  Simulator bulk(objects, pu::Length{0.0});
+  for (std::size_t s = 0; s < a.size(); ++s) {
+    single.Springs().Add(a[s], b[s], pu::Length{rest[s]}, pu::SpringConstant{k[s]}, c[s]);
+  }
+  bulk.Springs().Add(a, b, rest, k, c);
+  ASSERT_EQ(bulk.Springs().Size(), a.size());
+  EXPECT_EQ(bulk.Springs().Stiffness(3).value, 7.0);
+
+  for (int step = 0; step < 20; ++step) {
+    single.Step(pu::Time{0.01});
+    bulk.Step(pu::Time{0.01});
+  }
+  for (std::size_t i = 0; i < objects.size(); ++i) {
+    ASSERT_EQ(single.Particles().x[i], bulk.Particles().x[i]);
+    ASSERT_EQ(single.Particles().vz[i], bulk.Particles().vz[i]);
+  }
+
+  EXPECT_THROW(bulk.Springs().Add(a, b, rest, k, std::vector<double>(2)), std::invalid_argument);
+  bulk.Springs().Add(0, 50, pu::Length{1.0}, pu::SpringConstant{1.0});
+  EXPECT_THROW(bulk.Step(pu::Time{0.01}), std::out_of_range);
+}
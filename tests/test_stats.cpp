@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <physics/object/object.hpp>
+#include <physics/simulator/simulator.hpp>
+#include <physics/simulator/stats.hpp>
+#include <physics/units/quantity.hpp>
+#include <physics/vector/vector.hpp>
+
+namespace pu = physics::units;
+namespace fs = std::filesystem;
+using physics::object::Object;
+using physics::simulator::BroadPhase;
+using physics::simulator::Simulator;
+using physics::simulator::StepPhase;
+
+namespace {
+
+// Два шара летят навстречу и сталкиваются примерно на 40-м шаге
+Simulator HeadOn() {
+  using pu::operator""_kg;
+  using pu::operator""_m;
+  using pu::operator""_ms;
+
+  std::vector<Object> balls = {
+      Object(1.0_kg, {0.5_m * -1, 0.0_m, 0.0_m}, {1.0_ms, 0.0_ms, 0.0_ms}),
+      Object(1.0_kg, {0.5_m, 0.0_m, 0.0_m}, {1.0_ms * -1, 0.0_ms, 0.0_ms}),
+  };
+  Simulator sim(balls, pu::Length{0.2});
+  sim.EnableGravity(false);
+  sim.SetBroadPhase(BroadPhase::kBruteForce);
+  return sim;
+}
+
+}  // namespace
+
+TEST(StatsTest, CountsStepsPairsCollisionsAndBodies) {
+  if (!physics::simulator::kStatsEnabled) {
+    GTEST_SKIP() << "built without PHYSICS_ENABLE_STATS";
+  }
+
+  auto sim = HeadOn();
+  for (std::size_t step = 0; step < 100; ++step) {
+    sim.Step(pu::Time{0.01});
+  }
+
+  const auto& stats = sim.Stats();
+  EXPECT_EQ(stats.steps, 100u);
+  EXPECT_EQ(stats.pairs_examined, 100u);
+  EXPECT_EQ(stats.collisions_resolved, 1u);
+  EXPECT_EQ(stats.bodies_integrated, 200u);
+
+  const double nested = stats.Seconds(StepPhase::kGravity) + stats.Seconds(StepPhase::kIntegration) + stats.Seconds(StepPhase::kCollisions);
+  EXPECT_GT(stats.Seconds(StepPhase::kStep), 0.0);
+  EXPECT_LE(nested, stats.Seconds(StepPhase::kStep));
+
+  sim.ResetStats();
+  EXPECT_EQ(sim.Stats().steps, 0u);
+  EXPECT_EQ(sim.Stats().Seconds(StepPhase::kStep), 0.0);
+}
+
+TEST(StatsTest, WritesChromeTrace) {
+  if (!physics::simulator::kStatsEnabled) {
+    GTEST_SKIP() << "built without PHYSICS_ENABLE_STATS";
+  }
+
+  const std::string path = (fs::temp_directory_path() / "physics_stats_trace.json").string();
+  auto sim = HeadOn();
+  sim.Step(pu::Time{0.01});
+  sim.EnableTrace(true);
+  for (std::size_t step = 0; step < 3; ++step) {
+    sim.Step(pu::Time{0.01});
+  }
+  sim.EnableTrace(false);
+  sim.Step(pu::Time{0.01});
+  sim.WriteTrace(path);
+
+  std::ifstream in(path);
+  std::stringstream buffer;
+  buffer << in.rdbuf();
+  const std::string json = buffer.str();
+  fs::remove(path);
+
+  auto count = [&json](const std::string& needle) {
+    std::size_t found = 0;
+    for (auto pos = json.find(needle); pos != std::string::npos; pos = json.find(needle, pos + 1)) {
+      ++found;
+    }
+    return found;
+  };
+
+  EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0), 0u);
+  EXPECT_EQ(count("\"name\":\"step\""), 3u);
+  EXPECT_EQ(count("\"name\":\"collisions\""), 3u);
+  EXPECT_EQ(count("\"ph\":\"C\""), 3u);
+}
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include <physics/object/object.hpp>
+#include <physics/simulator/particles.hpp>
+#include <physics/simulator/simulator.hpp>
+#include <physics/simulator/sweep_and_prune.hpp>
+#include <physics/units/quantity.hpp>
+#include <physics/vector/vector.hpp>
+
+#include "bodies.hpp"
+
+namespace pu = physics::units;
+using physics::object::Object;
+using physics::simulator::BroadPhase;
+using physics::simulator::ParticleStore;
+using physics::simulator::Simulator;
+using physics::simulator::SweepAndPrune;
+using physics::tests::RandomBodies;
+
+namespace {
+
+std::vector<SweepAndPrune::Pair> BrutePairs(const ParticleStore& p, double distance) {
+  std::vector<SweepAndPrune::Pair> pairs;
+  for (std::size_t i = 0; i < p.Size(); ++i) {
+    for (std::size_t j = i + 1; j < p.Size(); ++j) {
+      const double dx = p.x[j] - p.x[i];
+      const double dy = p.y[j] - p.y[i];
+      const double dz = p.z[j] - p.z[i];
+      if (dx * dx + dy * dy + dz * dz <= distance * distance) {
+        pairs.emplace_back(i, j);
+      }
+    }
+  }
+  return pairs;
+}
+
+ParticleStore RandomGranules(std::size_t n, unsigned seed) {
+  ParticleStore p;
+  p.Assign(RandomBodies(n, {.high = 8.0}, seed));
+  return p;
+}
+
+}  // namespace
+
+TEST(SweepAndPruneTest, IncrementalUpdatesMatchBruteForce) {
+  auto p = RandomGranules(800, 5);
+  std::mt19937 gen(9);
+  std::normal_distribution<double> jitter(0.0, 0.05);
+
+  SweepAndPrune sap;
+  std::vector<SweepAndPrune::Pair> pairs;
+
+  // Тела чуть смещаются между кадрами, пары должны совпадать с перебором на каждом кадре
+  for (int frame = 0; frame < 40; ++frame) {
+    sap.FindPairs(p, 0.6, pairs);
+    ASSERT_EQ(pairs, BrutePairs(p, 0.6)) << "frame " << frame;
+
+    for (std::size_t i = 0; i < p.Size(); ++i) {
+      p.x[i] += jitter(gen);
+      p.y[i] += jitter(gen);
+      p.z[i] += jitter(gen);
+    }
+  }
+  EXPECT_GE(sap.OverlapCount(), pairs.size());
+}
+
+TEST(SweepAndPruneTest, RebuildsWhenBodiesOrDistanceChange) {
+  auto p = RandomGranules(300, 3);
+
+  SweepAndPrune sap;
+  std::vector<SweepAndPrune::Pair> pairs;
+  sap.FindPairs(p, 0.8, pairs);
+  ASSERT_EQ(pairs, BrutePairs(p, 0.8));
+
+  sap.FindPairs(p, 1.2, pairs);
+  EXPECT_EQ(pairs, BrutePairs(p, 1.2));
+
+  p.PushBack(Object(pu::Weight{1.0}, physics::vector::Vector<pu::Length, 3>{pu::Length{p.x[0]}, pu::Length{p.y[0]}, pu::Length{p.z[0]}}));
+  sap.FindPairs(p, 1.2, pairs);
+  EXPECT_EQ(pairs, BrutePairs(p, 1.2));
+}
+
+TEST(SweepAndPruneTest, SimulatorMatchesBruteForce) {
+  ParticleStore gas = RandomGranules(500, 13);
+  std::vector<Object> objects;
+  gas.Store(objects);
+
+  std::mt19937 gen(1);
+  std::uniform_real_distribution<double> vel(-1.0, 1.0);
+  for (auto& obj : objects) {
+    obj.speed = {pu::Speed{vel(gen)}, pu::Speed{vel(gen)}, pu::Speed{vel(gen)}};
+  }
+
+  Simulator brute(objects, pu::Length{0.4});
+  Simulator sap(objects, pu::Length{0.4});
+  brute.EnableGravity(false);
+  sap.EnableGravity(false);
+  brute.SetBroadPhase(BroadPhase::kBruteForce);
+  sap.SetBroadPhase(BroadPhase::kSweepAndPrune);
+
+  for (int step = 0; step < 50; ++step) {
+    brute.Step(pu::Time{0.02});
+    sap.Step(pu::Time{0.02});
+  }
+
+  for (std::size_t i = 0; i < objects.size(); ++i) {
+    for (std::size_t k = 0; k < 3; ++k) {
+      EXPECT_DOUBLE_EQ(sap.Objects()[i].position[k].value, brute.Objects()[i].position[k].value);
+      EXPECT_DOUBLE_EQ(sap.Objects()[i].speed[k].value, brute.Objects()[i].speed[k].value);
+    }
+  }
+}
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include <physics/object/object.hpp>
+#include <physics/parallel/thread_pool.hpp>
+#include <physics/simulator/simulator.hpp>
+#include <physics/units/quantity.hpp>
+#include <physics/vector/vector.hpp>
+
+#include "bodies.hpp"
+
+namespace pu = physics::units;
+using physics::object::Object;
+using physics::parallel::ThreadPool;
+using physics::simulator::GravitySolver;
+using physics::simulator::KernelIsa;
+using physics::simulator::Simulator;
+using physics::tests::RandomBodies;
+
+TEST(ThreadPoolTest, CoversRangeExactlyOnce) {
+  ThreadPool pool(4);
+  std::vector<std::atomic<int>> hits(10007);
+
+  for (int round = 0; round < 20; ++round) {
+    pool.ParallelFor(hits.size(), 16, [&](std::size_t begin, std::size_t end, std::size_t thread) {
+      EXPECT_LT(thread, pool.Size());
+      for (std::size_t i = begin; i < end; ++i) {
+        hits[i].fetch_add(1);
+      }
+    });
+  }
+
+  for (const auto& h : hits) {
+    EXPECT_EQ(h.load(), 20);
+  }
+}
+
+TEST(ThreadPoolTest, RethrowsFirstExceptionAndStaysUsable) {
+  ThreadPool pool(4);
+  std::atomic<int> calls{0};
+
+  // Бросают и кусок вызывающего потока (с нуля), и куски рабочих потоков
+  for (std::size_t failing : {0, 5000}) {
+    EXPECT_THROW(pool.ParallelFor(10000, 16,
+                                  [&](std::size_t begin, std::size_t end, std::size_t) {
+                                    calls.fetch_add(1);
+                                    if (begin <= failing && failing < end) {
+                                      throw std::runtime_error("chunk failed");
+                                    }
+                                  }),
+                 std::runtime_error);
+  }
+  EXPECT_GT(calls.load(), 0);
+
+  std::atomic<std::size_t> sum{0};
+  pool.ParallelFor(1000, 1, [&](std::size_t begin, std::size_t end, std::size_t) { sum.fetch_add(end - begin); });
+  EXPECT_EQ(sum.load(), 1000U);
+}
+
+TEST(ThreadPoolTest, NestedCallRunsInCurrentThread) {
+  ThreadPool pool(4);
+  std::vector<std::atomic<int>> hits(64 * 100);
+
+  pool.ParallelFor(64, 1, [&](std::size_t begin, std::size_t end, std::size_t thread) {
+    for (std::size_t row = begin; row < end; ++row) {
+      pool.ParallelFor(100, 1, [&](std::size_t b, std::size_t e, std::size_t inner) {
+        EXPECT_EQ(inner, thread);
+        EXPECT_EQ(e - b, 100U);
+        for (std::size_t i = b; i < e; ++i) {
+          hits[row * 100 + i].fetch_add(1);
+        }
+      });
+    }
+  });
+
+  for (const auto& h : hits) {
+    EXPECT_EQ(h.load(), 1);
+  }
+}
+
+void ExpectThreadedMatchesSerial(KernelIsa isa, GravitySolver solver) {
+  auto objects = RandomBodies(2500, {.low = -20.0, .high = 20.0, .speed = 0.5, .mass_low = 1e9, .mass_high = 1e9}, 5);
+
+  Simulator serial(objects, pu::Length{0.3});
+  Simulator threaded(objects, pu::Length{0.3});
+  for (auto* sim : {&serial, &threaded}) {
+    sim->SetKernelIsa(isa);
+    sim->SetGravitySolver(solver);
+  }
+  threaded.SetThreads(4);
+  ASSERT_EQ(threaded.Threads(), 4u);
+
+  for (int step = 0; step < 5; ++step) {
+    serial.Step(pu::Time{0.1});
+    threaded.Step(pu::Time{0.1});
+  }
+
+  for (std::size_t i = 0; i < objects.size(); ++i) {
+    for (std::size_t k = 0; k < 3; ++k) {
+      const double expected = serial.Objects()[i].position[k].value;
+      EXPECT_NEAR(threaded.Objects()[i].position[k].value, expected, 1e-9 * (1.0 + std::abs(expected)));
+    }
+  }
+}
+
+TEST(ThreadPoolTest, PairwiseGravityWithThreadBuffers) {
+  ExpectThreadedMatchesSerial(KernelIsa::kScalar, GravitySolver::kDirect);
+}
+
+TEST(ThreadPoolTest, VectorKernelGravity) {
+  ExpectThreadedMatchesSerial(physics::simulator::DetectKernelIsa(), GravitySolver::kDirect);
+}
+
+TEST(ThreadPoolTest, BarnesHutGravity) {
+  ExpectThreadedMatchesSerial(KernelIsa::kScalar, GravitySolver::kBarnesHut);
+}
@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <physics/io/trajectory.hpp>
+#include <physics/object/object.hpp>
+#include <physics/simulator/simulator.hpp>
+#include <physics/units/quantity.hpp>
+#include <physics/vector/vector.hpp>
+
+namespace pu = physics::units;
+namespace fs = std::filesystem;
+using physics::io::Compression;
+using physics::io::TrajectoryReader;
+using physics::io::TrajectoryWriter;
+using physics::io::TrajectoryWriterOptions;
+using physics::object::Object;
+using physics::simulator::Simulator;
+
+namespace {
+
+std::vector<Object> Balls() {
+  using pu::operator""_kg;
+  using pu::operator""_m;
+  using pu::operator""_ms;
+
+  return {
+      Object(0.17_kg, {0.6_m * -1, 0.0_m, 0.0_m}, {1.5_ms, 0.0_ms, 0.0_ms}),
+      Object(0.17_kg, {0.6_m, 0.3_m * -1, 0.0_m}, {0.5_ms * -1, 0.5_ms, 0.0_ms}),
+      Object(0.17_kg, {0.0_m, 0.4_m, 0.0_m}, {0.0_ms, 1.0_ms * -1, 0.0_ms}),
+  };
+}
+
+std::string TempPath(const std::string& name) {
+  return (fs::temp_directory_path() / ("physics_" + name + ".traj")).string();
+}
+
+// 500 шагов с записью каждого 5-го кадра
+void Record(const std::string& path, const TrajectoryWriterOptions& options) {
+  Simulator sim(Balls(), pu::Length{0.114});
+  auto writer = std::make_shared<TrajectoryWriter>(path, options);
+  sim.SetRecorder(writer);
+  for (std::size_t step = 0; step < 500; ++step) {
+    sim.Step(pu::Time{0.005});
+  }
+  writer->Close();
+}
+
+}  // namespace
+
+TEST(TrajectoryTest, StreamedFramesMatchRun) {
+  const std::string path = TempPath("stream");
+  TrajectoryWriterOptions options;
+  options.record_every = 5;
+  options.velocities = true;
+  options.frames_per_chunk = 7;
+  options.buffers = 2;
+  Record(path, options);
+
+  Simulator sim(Balls(), pu::Length{0.114});
+  auto expected = sim.Run(500, pu::Time{0.005}, 5, true);
+
+  TrajectoryReader reader(path);
+  ASSERT_EQ(reader.Frames(), expected.frames);
+  ASSERT_EQ(reader.Bodies(), 3u);
+  EXPECT_TRUE(reader.HasVelocities());
+
+  std::vector<double> positions(9);
+  std::vector<double> velocities(9);
+  for (std::size_t frame = 0; frame < reader.Frames(); ++frame) {
+    EXPECT_EQ(reader.Step(frame), 5 * (frame + 1));
+    reader.ReadPositions(frame, positions.data());
+    reader.ReadVelocities(frame, velocities.data());
+    for (std::size_t k = 0; k < 9; ++k) {
+      EXPECT_EQ(positions[k], expected.positions[frame * 9 + k]);
+      EXPECT_EQ(velocities[k], expected.velocities[frame * 9 + k]);
+    }
+  }
+  fs::remove(path);
+}
+
+TEST(TrajectoryTest, CompressedFileReadsBackIdentically) {
+  if (!physics::io::CompressionAvailable(Compression::kZlib)) {
+    GTEST_SKIP() << "built without zlib";
+  }
+
+  const std::string plain_path = TempPath("plain");
+  const std::string packed_path = TempPath("packed");
+  TrajectoryWriterOptions options;
+  options.frames_per_chunk = 64;
+  Record(plain_path, options);
+  options.compression = Compression::kZlib;
+  Record(packed_path, options);
+
+  EXPECT_LT(fs::file_size(packed_path), fs::file_size(plain_path));
+
+  TrajectoryReader plain(plain_path);
+  TrajectoryReader packed(packed_path);
+  ASSERT_EQ(packed.Frames(), 500u);
+  std::vector<double> a(9);
+  std::vector<double> b(9);
+  // Обратный порядок: кусок распаковывается заново при каждом переходе
+  for (std::size_t frame = packed.Frames(); frame-- > 0;) {
+    plain.ReadPositions(frame, a.data());
+    packed.ReadPositions(frame, b.data());
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(plain.Time(frame), packed.Time(frame));
+  }
+  fs::remove(plain_path);
+  fs::remove(packed_path);
+}
+
+TEST(TrajectoryTest, TruncatedTailChunkIsDropped) {
+  const std::string path = TempPath("truncated");
+  TrajectoryWriterOptions options;
+  options.frames_per_chunk = 30;
+  Record(path, options);
+
+  fs::resize_file(path, fs::file_size(path) - 1);
+  TrajectoryReader reader(path);
+  // 500 = 16 * 30 + 20, от последнего куска не остается ничего
+  EXPECT_EQ(reader.Frames(), 480u);
+  EXPECT_THROW(reader.Step(480), std::out_of_range);
+  fs::remove(path);
+}